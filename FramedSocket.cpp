@@ -0,0 +1,174 @@
+/*
+ *   Length-prefixed message framing on top of PracticalSocket
+ */
+
+#include "FramedSocket.h"
+#include <cstring>           // For memcpy
+
+// Varint helpers
+
+size_t encodeFrameLength(uint32_t length, unsigned char *out) {
+  size_t n = 0;
+  while (length >= 0x80) {
+    out[n++] = (unsigned char) (length | 0x80);
+    length >>= 7;
+  }
+  out[n++] = (unsigned char) length;
+  return n;
+}
+
+static size_t roundUpPow2(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+// FrameReader Code
+
+FrameReader::FrameReader(CommunicatingSocket &sock, size_t capacity)
+    : sock(sock), ring(roundUpPow2(capacity < 64 ? 64 : capacity)),
+      scratch(ring.size()), mask(ring.size() - 1), head(0), tail(0) {
+}
+
+// Decode the length prefix at head without consuming it.  A prefix that
+// does not fit 32 bits (a 5th byte with any of its top four bits set) is
+// malformed
+FrameReader::HeaderState FrameReader::peekHeader(uint32_t &length,
+                                                 size_t &headerLen) const {
+  size_t available = buffered();
+  uint32_t value = 0;
+  for (size_t i = 0; i < kMaxFrameHeader; i++) {
+    if (i >= available) {
+      return kHeaderIncomplete;
+    }
+    unsigned char byte = ring[(size_t) (head + i) & mask];
+    if (i == kMaxFrameHeader - 1 && (byte & 0xf0) != 0) {
+      return kHeaderMalformed;
+    }
+    value |= (uint32_t) (byte & 0x7f) << (7 * i);
+    if ((byte & 0x80) == 0) {
+      length = value;
+      headerLen = i + 1;
+      return kHeaderComplete;
+    }
+  }
+  return kHeaderMalformed;
+}
+
+bool FrameReader::receive(std::error_code &ec) noexcept {
+  uint32_t length;
+  size_t headerLen;
+  HeaderState state = peekHeader(length, headerLen);
+  if (state == kHeaderMalformed) {
+    ec = std::make_error_code(std::errc::bad_message);
+    return false;
+  }
+  if (state == kHeaderComplete && (uint64_t) length + headerLen > ring.size()) {
+    ec = std::make_error_code(std::errc::message_size);
+    return false;
+  }
+
+  size_t room = ring.size() - buffered();
+  if (room == 0) {
+    // Full ring without a complete frame (callers drain next() first)
+    ec = std::make_error_code(std::errc::message_size);
+    return false;
+  }
+  size_t start = (size_t) tail & mask;
+  size_t contiguous = ring.size() - start;
+  if (contiguous > room) {
+    contiguous = room;
+  }
+
+  int rtn = sock.recv(&ring[start], (int) contiguous, ec);
+  if (ec || rtn == 0) {
+    return false;
+  }
+  tail += (uint64_t) rtn;
+  return true;
+}
+
+bool FrameReader::receive() {
+  std::error_code ec;
+  if (receive(ec)) {
+    return true;
+  }
+  if (ec == std::errc::message_size) {
+    throw SocketException("Frame exceeds receive buffer");
+  }
+  if (ec == std::errc::bad_message) {
+    throw SocketException("Malformed frame length prefix");
+  }
+  if (ec) {
+    throw SocketException("Receive failed (recv()): " + ec.message());
+  }
+  return false;
+}
+
+bool FrameReader::next(const unsigned char *&payload, size_t &length) noexcept {
+  uint32_t frameLen;
+  size_t headerLen;
+  if (peekHeader(frameLen, headerLen) != kHeaderComplete) {
+    return false;
+  }
+  if ((uint64_t) frameLen + headerLen > buffered()) {
+    return false;
+  }
+
+  size_t start = (size_t) (head + headerLen) & mask;
+  if (start + frameLen <= ring.size()) {
+    payload = &ring[start];
+  } else {
+    // Frame wraps the end of the ring: stitch both halves together
+    size_t first = ring.size() - start;
+    memcpy(&scratch[0], &ring[start], first);
+    memcpy(&scratch[first], &ring[0], frameLen - first);
+    payload = &scratch[0];
+  }
+  length = frameLen;
+  head += headerLen + frameLen;
+  return true;
+}
+
+// FrameWriter Code
+
+FrameWriter::FrameWriter(CommunicatingSocket &sock, size_t capacity)
+    : sock(sock), batch(capacity < 64 ? 64 : capacity), used(0) {
+}
+
+FrameWriter::~FrameWriter() {
+  try {
+    flush();
+  } catch (...) {
+  }
+}
+
+void FrameWriter::write(const void *payload, size_t length) {
+  unsigned char header[kMaxFrameHeader];
+  size_t headerLen = encodeFrameLength((uint32_t) length, header);
+  size_t need = headerLen + length;
+
+  if (used + need > batch.size()) {
+    flush();
+  }
+  if (need > batch.size()) {
+    // Too big to batch: send it straight through, nothing to coalesce
+    sock.send(header, (int) headerLen);
+    sock.send(payload, (int) length);
+    return;
+  }
+  memcpy(&batch[used], header, headerLen);
+  memcpy(&batch[used + headerLen], payload, length);
+  used += need;
+}
+
+void FrameWriter::flush() {
+  if (used == 0) {
+    return;
+  }
+  size_t n = used;
+  used = 0;
+  sock.send(&batch[0], (int) n);
+}
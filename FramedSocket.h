@@ -0,0 +1,144 @@
+/*
+ *   Length-prefixed message framing on top of PracticalSocket
+ *
+ *   Every frame on the wire is an unsigned LEB128 varint holding the
+ *   payload length followed by the payload bytes.  FrameReader parses
+ *   frames out of a fixed-capacity receive ring, FrameWriter coalesces
+ *   small frames into a single send().
+ */
+
+#ifndef __FRAMEDSOCKET_INCLUDED__
+#define __FRAMEDSOCKET_INCLUDED__
+
+#include "PracticalSocket.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>            // For the fixed-size buffers
+
+/**
+ *   Largest number of bytes a frame length prefix can take (32-bit varint)
+ */
+const size_t kMaxFrameHeader = 5;
+
+/**
+ *   Encode a frame length as a varint
+ *   @param length payload length
+ *   @param out destination with room for kMaxFrameHeader bytes
+ *   @return number of bytes written
+ */
+size_t encodeFrameLength(uint32_t length, unsigned char *out);
+
+/**
+ *   Reads frames from a connected socket.  All memory is allocated in the
+ *   constructor; a single receive() may yield any number of frames, which
+ *   are then handed out by next() as views into the internal buffers
+ */
+class FrameReader {
+public:
+  /**
+   *   Construct a reader over the given socket
+   *   @param sock connected socket to read from, must outlive the reader
+   *   @param capacity ring size in bytes (rounded up to a power of two);
+   *                   also bounds the largest frame that can be received
+   */
+  FrameReader(CommunicatingSocket &sock, size_t capacity = 64 * 1024);
+
+  /**
+   *   Read whatever the socket has available into the ring with one recv()
+   *   @return false if the peer closed the connection
+   *   @exception SocketException thrown if the receive fails, the ring
+   *   is full without holding a complete frame or a length prefix is
+   *   malformed
+   */
+  bool receive();
+
+  /**
+   *   Non-throwing receive()
+   *   @param ec set to the failure reason (operation_would_block on an
+   *             idle non-blocking socket, message_size if a frame does not
+   *             fit the ring, bad_message if a length prefix overflows
+   *             32 bits), cleared on success
+   *   @return false on EOF or failure
+   */
+  bool receive(std::error_code &ec) noexcept;
+
+  /**
+   *   Take the next complete frame out of the ring
+   *   @param payload set to the frame bytes; valid until the next call to
+   *                  next() or receive()
+   *   @param length set to the number of payload bytes
+   *   @return false if no complete frame is buffered
+   */
+  bool next(const unsigned char *&payload, size_t &length) noexcept;
+
+  /**
+   *   Get the number of received bytes not yet consumed by next()
+   *   @return buffered byte count
+   */
+  size_t buffered() const { return (size_t) (tail - head); }
+
+private:
+  FrameReader(const FrameReader &);
+  void operator=(const FrameReader &);
+
+  enum HeaderState { kHeaderIncomplete, kHeaderComplete, kHeaderMalformed };
+  HeaderState peekHeader(uint32_t &length, size_t &headerLen) const;
+
+  CommunicatingSocket &sock;
+  std::vector<unsigned char> ring;     // Received, unconsumed bytes
+  std::vector<unsigned char> scratch;  // Frames that wrap the ring seam
+  size_t mask;                         // ring.size() - 1
+  uint64_t head;                       // Total bytes consumed
+  uint64_t tail;                       // Total bytes received
+};
+
+/**
+ *   Writes frames to a connected socket, batching small frames so that
+ *   several of them leave in one send() call
+ */
+class FrameWriter {
+public:
+  /**
+   *   Construct a writer over the given socket
+   *   @param sock connected socket to write to, must outlive the writer
+   *   @param capacity batch size in bytes; frames that do not fit are
+   *                   sent on their own
+   */
+  FrameWriter(CommunicatingSocket &sock, size_t capacity = 16 * 1024);
+
+  /**
+   *   Flushes whatever is still batched.  Errors are swallowed here; call
+   *   flush() explicitly to observe them
+   */
+  ~FrameWriter();
+
+  /**
+   *   Queue a frame.  It is sent once the batch fills up or on flush()
+   *   @param payload frame bytes
+   *   @param length number of payload bytes
+   *   @exception SocketException thrown if a required flush fails
+   */
+  void write(const void *payload, size_t length);
+
+  /**
+   *   Send all batched frames
+   *   @exception SocketException thrown if unable to send the data
+   */
+  void flush();
+
+  /**
+   *   Get the number of bytes waiting in the batch
+   *   @return batched byte count
+   */
+  size_t pending() const { return used; }
+
+private:
+  FrameWriter(const FrameWriter &);
+  void operator=(const FrameWriter &);
+
+  CommunicatingSocket &sock;
+  std::vector<unsigned char> batch;
+  size_t used;
+};
+
+#endif
@@ -30,10 +30,16 @@
   #include <arpa/inet.h>       // For inet_addr()
   #include <unistd.h>          // For close()
   #include <netinet/in.h>      // For sockaddr_in
+  #include <netinet/tcp.h>     // For TCP_NODELAY
+  #include <sys/time.h>        // For timeval
+  #include <poll.h>            // For poll()
+  #include <fcntl.h>           // For fcntl()
   typedef void raw_type;       // Type used for raw data on this platform
 #endif
 
 #include <errno.h>             // For errno
+#include <chrono>              // For readiness wait deadlines
+#include <new>                 // For std::nothrow
 
 using std::string;
 
@@ -41,6 +47,12 @@ using std::string;
 static bool initialized = false;
 #endif
 
+#ifdef MSG_NOSIGNAL
+static const int sendFlags = MSG_NOSIGNAL;  // Report EPIPE instead of SIGPIPE
+#else
+static const int sendFlags = 0;
+#endif
+
 // SocketException Code
 
 SocketException::SocketException(const string &message, bool inclSysMsg)
@@ -58,21 +70,111 @@ const char *SocketException::what() const noexcept {
   return userMessage.c_str();
 }
 
-// Function to fill in address structure given an address and port
-static void fillAddr(const string &address, unsigned short port, 
-                     sockaddr_in &addr) {
+// Function to fill in address structure given an address and port.
+// Returns false if the name cannot be resolved
+static bool resolveAddr(const string &address, unsigned short port,
+                        sockaddr_in &addr) {
   memset(&addr, 0, sizeof(addr));  // Zero out address structure
   addr.sin_family = AF_INET;       // Internet address
+  addr.sin_port = htons(port);     // Assign port in network byte order
+
+  // Dotted addresses need no resolver round trip
+  unsigned long numeric = inet_addr(address.c_str());
+  if (numeric != INADDR_NONE) {
+    addr.sin_addr.s_addr = numeric;
+    return true;
+  }
 
   hostent *host;  // Resolve name
   if ((host = gethostbyname(address.c_str())) == NULL) {
+    return false;
+  }
+  addr.sin_addr.s_addr = *((unsigned long *) host->h_addr_list[0]);
+  return true;
+}
+
+static void fillAddr(const string &address, unsigned short port, 
+                     sockaddr_in &addr) {
+  if (!resolveAddr(address, port, addr)) {
     // strerror() will not work for gethostbyname() and hstrerror() 
     // is supposedly obsolete
     throw SocketException("Failed to resolve name (gethostbyname())");
   }
-  addr.sin_addr.s_addr = *((unsigned long *) host->h_addr_list[0]);
+}
 
-  addr.sin_port = htons(port);     // Assign port in network byte order
+// True if the last socket call failed only because it would have blocked
+static bool lastErrorWouldBlock() {
+  #ifdef WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+  #else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+  #endif
+}
+
+// True if the last socket call was interrupted by a signal
+static bool lastErrorInterrupted() {
+  #ifdef WIN32
+    return WSAGetLastError() == WSAEINTR;
+  #else
+    return errno == EINTR;
+  #endif
+}
+
+// Error code describing the last failed socket call
+static std::error_code lastSocketError() {
+  #ifdef WIN32
+    return std::error_code(WSAGetLastError(), std::system_category());
+  #else
+    return std::error_code(errno, std::system_category());
+  #endif
+}
+
+// Wait for the descriptor to become readable or writable.  Returns false
+// on timeout; a negative timeout waits forever
+static bool waitForSocket(int sockDesc, bool forWrite, int timeoutMs) {
+  typedef std::chrono::steady_clock clock;
+  clock::time_point deadline = clock::now() +
+                               std::chrono::milliseconds(timeoutMs);
+  int remainingMs = timeoutMs;
+  for (;;) {
+    #ifdef WIN32
+      fd_set fds;
+      FD_ZERO(&fds);
+      FD_SET((SOCKET) sockDesc, &fds);
+      timeval tv;
+      tv.tv_sec = remainingMs / 1000;
+      tv.tv_usec = (remainingMs % 1000) * 1000;
+      int rtn = select(sockDesc + 1, forWrite ? NULL : &fds,
+                       forWrite ? &fds : NULL, NULL,
+                       remainingMs < 0 ? NULL : &tv);
+    #else
+      pollfd pfd;
+      pfd.fd = sockDesc;
+      pfd.events = forWrite ? POLLOUT : POLLIN;
+      pfd.revents = 0;
+      int rtn = poll(&pfd, 1, remainingMs);
+    #endif
+    if (rtn > 0) {
+      return true;
+    }
+    if (rtn == 0) {
+      return false;
+    }
+    if (!lastErrorInterrupted()) {
+      #ifdef WIN32
+        throw SocketException("Readiness wait failed (select())", true);
+      #else
+        throw SocketException("Readiness wait failed (poll())", true);
+      #endif
+    }
+    if (timeoutMs >= 0) {
+      remainingMs = (int) std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - clock::now()).count();
+      if (remainingMs < 0) {
+        remainingMs = 0;
+      }
+    }
+  }
 }
 
 // Socket Code
@@ -172,13 +274,67 @@ unsigned short Socket::resolveService(const string &service,
     return ntohs(serv->s_port);    /* Found port (network byte order) by name */
 }
 
+bool Socket::waitReadable(int timeoutMs) {
+  return waitForSocket(sockDesc, false, timeoutMs);
+}
+
+bool Socket::waitWritable(int timeoutMs) {
+  return waitForSocket(sockDesc, true, timeoutMs);
+}
+
+void Socket::setReceiveBufferSize(int size) {
+  if (setsockopt(sockDesc, SOL_SOCKET, SO_RCVBUF,
+                 (raw_type *) &size, sizeof(size)) < 0) {
+    throw SocketException("Receive buffer size set failed (setsockopt())", true);
+  }
+}
+
+void Socket::setSendBufferSize(int size) {
+  if (setsockopt(sockDesc, SOL_SOCKET, SO_SNDBUF,
+                 (raw_type *) &size, sizeof(size)) < 0) {
+    throw SocketException("Send buffer size set failed (setsockopt())", true);
+  }
+}
+
+void Socket::setBlocking(bool blocking) {
+  #ifdef WIN32
+    u_long nonBlocking = blocking ? 0 : 1;
+    if (ioctlsocket(sockDesc, FIONBIO, &nonBlocking) != 0) {
+      throw SocketException("Blocking mode change failed (ioctlsocket())", true);
+    }
+  #else
+    int flags = fcntl(sockDesc, F_GETFL, 0);
+    if (flags < 0) {
+      throw SocketException("Blocking mode change failed (fcntl())", true);
+    }
+    flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+    if (fcntl(sockDesc, F_SETFL, flags) < 0) {
+      throw SocketException("Blocking mode change failed (fcntl())", true);
+    }
+  #endif
+}
+
+// Function to apply a SO_RCVTIMEO/SO_SNDTIMEO style option in milliseconds
+static bool setTimeoutOption(int sockDesc, int option, int timeoutMs) {
+  #ifdef WIN32
+    DWORD tv = (DWORD) timeoutMs;
+  #else
+    timeval tv;
+    tv.tv_sec = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+  #endif
+  return setsockopt(sockDesc, SOL_SOCKET, option,
+                    (raw_type *) &tv, sizeof(tv)) >= 0;
+}
+
 // CommunicatingSocket Code
 
 CommunicatingSocket::CommunicatingSocket(int type, int protocol)
-    : Socket(type, protocol) {
+    : Socket(type, protocol), sendTimeoutMs(0) {
 }
 
-CommunicatingSocket::CommunicatingSocket(int newConnSD) : Socket(newConnSD) {
+CommunicatingSocket::CommunicatingSocket(int newConnSD)
+    : Socket(newConnSD), sendTimeoutMs(0) {
 }
 
 void CommunicatingSocket::connect(const string &foreignAddress,
@@ -194,11 +350,42 @@ void CommunicatingSocket::connect(const string &foreignAddress,
 }
 
 void CommunicatingSocket::send(const void *buffer, int bufferLen) {
-  if (::send(sockDesc, (raw_type *) buffer, bufferLen, 0) < 0) {
-    throw SocketException("Send failed (send())", true);
+  const char *data = (const char *) buffer;
+  int sent = 0;
+  while (sent < bufferLen) {
+    int rtn = ::send(sockDesc, (raw_type *) (data + sent), bufferLen - sent,
+                     sendFlags);
+    if (rtn < 0) {
+      if (lastErrorInterrupted()) {
+        continue;
+      }
+      if (!lastErrorWouldBlock()) {
+        throw SocketException("Send failed (send())", true);
+      }
+      // Kernel buffer is full: wait for room instead of dropping the rest
+      if (!waitWritable(sendTimeoutMs > 0 ? sendTimeoutMs : -1)) {
+        throw SocketException("Send timed out (send())");
+      }
+      continue;
+    }
+    sent += rtn;
   }
 }
 
+int CommunicatingSocket::send(const void *buffer, int bufferLen,
+                              std::error_code &ec) noexcept {
+  int rtn;
+  do {
+    rtn = ::send(sockDesc, (raw_type *) buffer, bufferLen, sendFlags);
+  } while (rtn < 0 && lastErrorInterrupted());
+  if (rtn < 0) {
+    ec = lastSocketError();
+    return 0;
+  }
+  ec.clear();
+  return rtn;
+}
+
 int CommunicatingSocket::recv(void *buffer, int bufferLen) {
   int rtn;
   if ((rtn = ::recv(sockDesc, (raw_type *) buffer, bufferLen, 0)) < 0) {
@@ -208,6 +395,20 @@ int CommunicatingSocket::recv(void *buffer, int bufferLen) {
   return rtn;
 }
 
+int CommunicatingSocket::recv(void *buffer, int bufferLen,
+                              std::error_code &ec) noexcept {
+  int rtn;
+  do {
+    rtn = ::recv(sockDesc, (raw_type *) buffer, bufferLen, 0);
+  } while (rtn < 0 && lastErrorInterrupted());
+  if (rtn < 0) {
+    ec = lastSocketError();
+    return 0;
+  }
+  ec.clear();
+  return rtn;
+}
+
 string CommunicatingSocket::getForeignAddress() {
   sockaddr_in addr;
   unsigned int addr_len = sizeof(addr);
@@ -228,6 +429,19 @@ unsigned short CommunicatingSocket::getForeignPort() {
   return ntohs(addr.sin_port);
 }
 
+void CommunicatingSocket::setReceiveTimeout(int timeoutMs) {
+  if (!setTimeoutOption(sockDesc, SO_RCVTIMEO, timeoutMs)) {
+    throw SocketException("Receive timeout set failed (setsockopt())", true);
+  }
+}
+
+void CommunicatingSocket::setSendTimeout(int timeoutMs) {
+  if (!setTimeoutOption(sockDesc, SO_SNDTIMEO, timeoutMs)) {
+    throw SocketException("Send timeout set failed (setsockopt())", true);
+  }
+  sendTimeoutMs = timeoutMs;
+}
+
 // TCPSocket Code
 
 TCPSocket::TCPSocket()
@@ -243,6 +457,14 @@ TCPSocket::TCPSocket(const string &foreignAddress, unsigned short foreignPort)
 TCPSocket::TCPSocket(int newConnSD) : CommunicatingSocket(newConnSD) {
 }
 
+void TCPSocket::setNoDelay(bool noDelay) {
+  int flag = noDelay ? 1 : 0;
+  if (setsockopt(sockDesc, IPPROTO_TCP, TCP_NODELAY,
+                 (raw_type *) &flag, sizeof(flag)) < 0) {
+    throw SocketException("TCP_NODELAY set failed (setsockopt())", true);
+  }
+}
+
 // TCPServerSocket Code
 
 TCPServerSocket::TCPServerSocket(unsigned short localPort, int queueLen)
@@ -267,6 +489,30 @@ TCPSocket *TCPServerSocket::accept() {
   return new TCPSocket(newConnSD);
 }
 
+TCPSocket *TCPServerSocket::accept(std::error_code &ec) noexcept {
+  int newConnSD;
+  do {
+    newConnSD = ::accept(sockDesc, NULL, 0);
+  } while (newConnSD < 0 && lastErrorInterrupted());
+  if (newConnSD < 0) {
+    ec = lastSocketError();
+    return NULL;
+  }
+  TCPSocket *conn = new (std::nothrow) TCPSocket(newConnSD);
+  if (conn == NULL) {
+    // Nobody owns the descriptor yet, so close it here
+    #ifdef WIN32
+      ::closesocket(newConnSD);
+    #else
+      ::close(newConnSD);
+    #endif
+    ec = std::make_error_code(std::errc::not_enough_memory);
+    return NULL;
+  }
+  ec.clear();
+  return conn;
+}
+
 void TCPServerSocket::setListen(int queueLen) {
   if (listen(sockDesc, queueLen) < 0) {
     throw SocketException("Set listening socket failed (listen())", true);
@@ -344,6 +590,47 @@ int UDPSocket::recvFrom(void *buffer, int bufferLen, string &sourceAddress,
   return rtn;
 }
 
+int UDPSocket::sendTo(const void *buffer, int bufferLen,
+    const string &foreignAddress, unsigned short foreignPort,
+    std::error_code &ec) noexcept {
+  sockaddr_in destAddr;
+  if (!resolveAddr(foreignAddress, foreignPort, destAddr)) {
+    ec = std::make_error_code(std::errc::address_not_available);
+    return 0;
+  }
+
+  int rtn;
+  do {
+    rtn = sendto(sockDesc, (raw_type *) buffer, bufferLen, sendFlags,
+                 (sockaddr *) &destAddr, sizeof(destAddr));
+  } while (rtn < 0 && lastErrorInterrupted());
+  if (rtn < 0) {
+    ec = lastSocketError();
+    return 0;
+  }
+  ec.clear();
+  return rtn;
+}
+
+int UDPSocket::recvFrom(void *buffer, int bufferLen, string &sourceAddress,
+    unsigned short &sourcePort, std::error_code &ec) noexcept {
+  sockaddr_in clntAddr;
+  socklen_t addrLen = sizeof(clntAddr);
+  int rtn;
+  do {
+    rtn = recvfrom(sockDesc, (raw_type *) buffer, bufferLen, 0,
+                   (sockaddr *) &clntAddr, (socklen_t *) &addrLen);
+  } while (rtn < 0 && lastErrorInterrupted());
+  if (rtn < 0) {
+    ec = lastSocketError();
+    return 0;
+  }
+  ec.clear();
+  sourceAddress.assign(inet_ntoa(clntAddr.sin_addr));
+  sourcePort = ntohs(clntAddr.sin_port);
+  return rtn;
+}
+
 void UDPSocket::setMulticastTTL(unsigned char multicastTTL) {
   if (setsockopt(sockDesc, IPPROTO_IP, IP_MULTICAST_TTL, 
                  (raw_type *) &multicastTTL, sizeof(multicastTTL)) < 0) {
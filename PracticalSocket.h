@@ -25,6 +25,7 @@
 #include <stdlib.h>
 #include <string>            // For string
 #include <exception>         // For exception class
+#include <system_error>      // For error_code
 
 /**
  *   Signals a problem with the execution of a socket call.
@@ -121,6 +122,48 @@ public:
   static unsigned short resolveService(const std::string &service,
                                        const std::string &protocol = "tcp");
 
+  /**
+   *   Wait until data can be read from this socket (or, for a server
+   *   socket, until a connection is pending)
+   *   @param timeoutMs maximum time to wait in milliseconds, 0 to poll
+   *                    and a negative value to wait forever
+   *   @return true if the socket is readable, false on timeout
+   *   @exception SocketException thrown if the wait fails
+   */
+  bool waitReadable(int timeoutMs);
+
+  /**
+   *   Wait until data can be written to this socket without blocking
+   *   @param timeoutMs maximum time to wait in milliseconds, 0 to poll
+   *                    and a negative value to wait forever
+   *   @return true if the socket is writable, false on timeout
+   *   @exception SocketException thrown if the wait fails
+   */
+  bool waitWritable(int timeoutMs);
+
+  /**
+   *   Set the size of the kernel receive buffer (SO_RCVBUF)
+   *   @param size buffer size in bytes
+   *   @exception SocketException thrown if the option cannot be set
+   */
+  void setReceiveBufferSize(int size);
+
+  /**
+   *   Set the size of the kernel send buffer (SO_SNDBUF)
+   *   @param size buffer size in bytes
+   *   @exception SocketException thrown if the option cannot be set
+   */
+  void setSendBufferSize(int size);
+
+  /**
+   *   Switch the socket between blocking and non-blocking mode.  In
+   *   non-blocking mode the error_code variants of the I/O calls report
+   *   std::errc::operation_would_block instead of waiting
+   *   @param blocking false to make calls on this socket non-blocking
+   *   @exception SocketException thrown if the mode cannot be changed
+   */
+  void setBlocking(bool blocking);
+
 
   int GetSocket(){return sockDesc;}
 private:
@@ -149,14 +192,27 @@ public:
   void connect(const std::string &foreignAddress, unsigned short foreignPort);
 
   /**
-   *   Write the given buffer to this socket.  Call connect() before
-   *   calling send()
+   *   Write the whole given buffer to this socket.  Call connect() before
+   *   calling send().  Partial writes are continued and, if the socket
+   *   would block, the call waits for it to become writable again (up to
+   *   the send timeout, see setSendTimeout())
    *   @param buffer buffer to be written
    *   @param bufferLen number of bytes from buffer to be written
-   *   @exception SocketException thrown if unable to send data
+   *   @exception SocketException thrown if unable to send all the data
    */
   void send(const void *buffer, int bufferLen);
 
+  /**
+   *   Write as much of the given buffer as the socket accepts right now,
+   *   without throwing.  Intended for event loops on non-blocking sockets
+   *   @param buffer buffer to be written
+   *   @param bufferLen number of bytes from buffer to be written
+   *   @param ec set to the failure reason (operation_would_block if the
+   *             socket is full), cleared on success
+   *   @return number of bytes written, 0 on failure
+   */
+  int send(const void *buffer, int bufferLen, std::error_code &ec) noexcept;
+
   /**
    *   Read into the given buffer up to bufferLen bytes data from this
    *   socket.  Call connect() before calling recv()
@@ -167,6 +223,16 @@ public:
    */
   int recv(void *buffer, int bufferLen);
 
+  /**
+   *   Read up to bufferLen bytes without throwing
+   *   @param buffer buffer to receive the data
+   *   @param bufferLen maximum number of bytes to read into buffer
+   *   @param ec set to the failure reason (operation_would_block if no
+   *             data is pending), cleared on success
+   *   @return number of bytes read, 0 for EOF or failure (check ec)
+   */
+  int recv(void *buffer, int bufferLen, std::error_code &ec) noexcept;
+
   /**
    *   Get the foreign address.  Call connect() before calling recv()
    *   @return foreign address
@@ -181,9 +247,27 @@ public:
    */
   unsigned short getForeignPort();
 
+  /**
+   *   Set the maximum time a blocking recv() waits for data (SO_RCVTIMEO)
+   *   @param timeoutMs timeout in milliseconds, 0 to wait forever
+   *   @exception SocketException thrown if the option cannot be set
+   */
+  void setReceiveTimeout(int timeoutMs);
+
+  /**
+   *   Set the maximum time send() waits for the socket to accept more
+   *   data (SO_SNDTIMEO)
+   *   @param timeoutMs timeout in milliseconds, 0 to wait forever
+   *   @exception SocketException thrown if the option cannot be set
+   */
+  void setSendTimeout(int timeoutMs);
+
 protected:
   CommunicatingSocket(int type, int protocol);
   CommunicatingSocket(int newConnSD);
+
+private:
+  int sendTimeoutMs;         // Wait limit for send() when it would block
 };
 
 /**
@@ -206,6 +290,14 @@ public:
    */
   TCPSocket(const std::string &foreignAddress, unsigned short foreignPort);
 
+  /**
+   *   Enable or disable Nagle's algorithm (TCP_NODELAY).  Disable it
+   *   when small messages must go out immediately
+   *   @param noDelay true to send segments without coalescing delay
+   *   @exception SocketException thrown if the option cannot be set
+   */
+  void setNoDelay(bool noDelay);
+
 private:
   // Access for TCPServerSocket::accept() connection creation
   friend class TCPServerSocket;
@@ -247,6 +339,15 @@ public:
    */
   TCPSocket *accept();
 
+  /**
+   *   Accept a pending connection without throwing on socket errors
+   *   @param ec set to the failure reason (operation_would_block if no
+   *             connection is pending on a non-blocking socket,
+   *             not_enough_memory if the socket object cannot be allocated)
+   *   @return new connection socket, or NULL on failure
+   */
+  TCPSocket *accept(std::error_code &ec) noexcept;
+
 private:
   void setListen(int queueLen);
 };
@@ -297,6 +398,18 @@ public:
   void sendTo(const void *buffer, int bufferLen, const std::string &foreignAddress,
             unsigned short foreignPort);
 
+  /**
+   *   Send a datagram without throwing
+   *   @param buffer buffer to be written
+   *   @param bufferLen number of bytes to write
+   *   @param foreignAddress address (IP address or name) to send to
+   *   @param foreignPort port number to send to
+   *   @param ec set to the failure reason, cleared on success
+   *   @return number of bytes sent, 0 on failure
+   */
+  int sendTo(const void *buffer, int bufferLen, const std::string &foreignAddress,
+             unsigned short foreignPort, std::error_code &ec) noexcept;
+
   /**
    *   Read read up to bufferLen bytes data from this socket.  The given buffer
    *   is where the data will be placed
@@ -310,6 +423,19 @@ public:
   int recvFrom(void *buffer, int bufferLen, std::string &sourceAddress,
                unsigned short &sourcePort);
 
+  /**
+   *   Receive a datagram without throwing.  The dotted source address
+   *   fits the small-string buffer, so no allocation takes place
+   *   @param buffer buffer to receive data
+   *   @param bufferLen maximum number of bytes to receive
+   *   @param sourceAddress address of datagram source
+   *   @param sourcePort port of data source
+   *   @param ec set to the failure reason, cleared on success
+   *   @return number of bytes received, 0 on failure
+   */
+  int recvFrom(void *buffer, int bufferLen, std::string &sourceAddress,
+               unsigned short &sourcePort, std::error_code &ec) noexcept;
+
   /**
    *   Set the multicast TTL
    *   @param multicastTTL multicast TTL
@@ -0,0 +1,100 @@
+#include <math.h>
+#include "RelaAceleracion.h"
+#include "RelaLorentz.h"
+#include "RelaModelo.h"
+
+// Integral del ritmo mientras u va de ua a ub con aceleracion a, sin que u
+// cambie de signo.  Con v <= 0 el ritmo es 1 / sqrt(1 + u^2) y con v >= 0
+// es sqrt(1 + u^2).
+static double ClockPiece(double ua, double ub, double span, double a)
+{
+	if (ua + ub <= 0.0) {
+		return AsinhDiff(ua, ub) / a;
+	}
+	// (ub * gb - ua * ga) / (2 a) + (asinh ub - asinh ua) / (2 a), con el
+	// primer termino escrito sin restas de numeros parecidos.
+	double ga = sqrt(1.0 + ua * ua);
+	double gb = sqrt(1.0 + ub * ub);
+	return 0.5 * span * (ub + ua) * (1.0 + ub * ub + ua * ua) / (ub * gb + ua * ga) + 0.5 * AsinhDiff(ua, ub) / a;
+}
+
+static double ClampToLimit(double v)
+{
+	if (v > kVelocityLimit) {
+		return kVelocityLimit;
+	}
+	if (v < -kVelocityLimit) {
+		return -kVelocityLimit;
+	}
+	return v;
+}
+
+double AcceleratedClock(double v, double a, double accelTime, double dt, double& velocity)
+{
+	v = ClampToLimit(v);
+	double end = (accelTime < dt) ? accelTime : dt;
+	double limit = (a > 0.0 ? 1.0 : -1.0) * CelerityFromVelocity(kVelocityLimit);
+	double u = CelerityFromVelocity(v);
+	double t = 0.0;
+	double clock = 0.0;
+	while (t < end) {
+		// Ya en el limite: el resto del paso es inercial.
+		if ((a > 0.0) ? u >= limit : u <= limit) {
+			u = limit;
+			break;
+		}
+		double next = end;
+		double ub = u + a * (end - t);
+		double toLimit = t + (limit - u) / a;
+		if (toLimit < next) {
+			next = toLimit;
+			ub = limit;
+		}
+		// Hasta v = 0 y desde ahi, porque el ritmo cambia de formula.
+		if (u * ub < 0.0) {
+			next = t - u / a;
+			ub = 0.0;
+		}
+		clock += ClockPiece(u, ub, next - t, a);
+		u = ub;
+		t = next;
+	}
+	velocity = ClampToLimit(VelocityFromCelerity(u));
+	if (t < dt) {
+		clock += (dt - t) / FactorFromVelocity(velocity);
+	}
+	return clock;
+}
+
+void AccelerationSet::Start(int column, double a, double duration)
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < accelerations.size(); i++) {
+		if (accelerations[i].column != column) {
+			accelerations[kept++] = accelerations[i];
+		}
+	}
+	accelerations.resize(kept);
+	if (a == 0.0 || !(duration > 0.0)) {
+		return;
+	}
+	Acceleration acceleration = { column, a, duration };
+	accelerations.push_back(acceleration);
+}
+
+void AccelerationSet::Advance(double dt, double* times, double* velocities, bool* moved)
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < accelerations.size(); i++) {
+		Acceleration& acc = accelerations[i];
+		times[acc.column] += AcceleratedClock(velocities[acc.column], acc.a, acc.remaining, dt,
+			velocities[acc.column]);
+		moved[acc.column] = true;
+		// Con duraciones multiplo del paso la resta deja restos de redondeo.
+		acc.remaining -= dt;
+		if (acc.remaining > 1.0e-9 * dt) {
+			accelerations[kept++] = acc;
+		}
+	}
+	accelerations.resize(kept);
+}
@@ -0,0 +1,44 @@
+#ifndef RELAACELERACION_H_INCLUDED
+#define RELAACELERACION_H_INCLUDED
+
+#include <vector>
+
+/*
+ * Aceleraciones en curso del modelo de dilatacion.  Cada una actua sobre
+ * una columna (indice de Times/Velocidades) con aceleracion propia
+ * constante: la celeridad u = v / sqrt(1 - v^2) crece linealmente con el
+ * tiempo de simulacion.
+ *
+ * El avance del reloj durante el paso se integra de forma cerrada, igual
+ * que el ritmo que usa StepSimulation (1 / FactorFromVelocity), partiendo
+ * el paso donde v cambia de signo, donde se llega a kVelocityLimit y donde
+ * termina la duracion.  No hay error de integracion, asi que el resultado
+ * no depende del tamano del paso.
+ */
+class AccelerationSet {
+public:
+	// Sustituye la aceleracion que tuviera la columna.
+	void Start(int column, double a, double duration);
+	void Clear() { accelerations.clear(); }
+	bool Active() const { return !accelerations.empty(); }
+
+	// Avanza dt segundos de simulacion: suma a times el avance del reloj
+	// de cada columna acelerada, deja en velocities su velocidad final y
+	// marca moved[column].  Quita las que terminan.
+	void Advance(double dt, double* times, double* velocities, bool* moved);
+
+private:
+	struct Acceleration {
+		int column;
+		double a;
+		double remaining;
+	};
+	std::vector<Acceleration> accelerations;
+};
+
+// Avance del reloj con velocidad v durante dt segundos acelerando con a
+// (el mismo calculo que AccelerationSet::Advance para una columna).
+// velocity recibe la velocidad final.
+double AcceleratedClock(double v, double a, double accelTime, double dt, double& velocity);
+
+#endif // RELAACELERACION_H_INCLUDED
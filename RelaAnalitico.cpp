@@ -0,0 +1,354 @@
+#include <math.h>
+#include "RelaAnalitico.h"
+
+AnalyticEngine::AnalyticEngine(Mode mode)
+	: mode(mode), events(NULL), eventCount(0), index(kWindowCount), current(NULL)
+{
+	for (int w = 0; w < kWindowCount; w++) {
+		for (int c = 0; c < kIndexColumns; c++) {
+			keyColumn[w * kIndexColumns + c] = GetIndexForLabelInWindow(w, (char)('A' + c));
+		}
+	}
+	Reset();
+}
+
+void AnalyticEngine::Load(const AppEvent* eventData, size_t count)
+{
+	events = eventData;
+	eventCount = count;
+	index.Build(events, eventCount);
+	Reset();
+}
+
+void AnalyticEngine::Reset()
+{
+	for (int i = 0; i < kTotalColumns; i++) {
+		state.clock[i] = 0.0;
+		state.velocity[i] = 0.0;
+		state.factor[i] = FactorFromVelocity(0.0);
+	}
+	state.elapsed = 0.0;
+	state.step = 0;
+	ramps.Clear();
+	accelerations.Clear();
+	index.Rewind();
+}
+
+// Pasos que faltan para el siguiente evento.  El reloj tras m pasos se
+// calcula igual que en MoveSteps, asi que el evento elegido se alcanza.
+static bool StepsToReach(double clock, double increment, double target, unsigned long long& steps)
+{
+	double need = (target - clock) / increment;
+	if (!(need < 1.0e18)) {
+		return false;
+	}
+	unsigned long long m = (need > 0.0) ? (unsigned long long)ceil(need) : 0;
+	while (clock + (double)m * increment < target) {
+		m++;
+	}
+	while (m > 0 && clock + (double)(m - 1) * increment >= target) {
+		m--;
+	}
+	steps = m;
+	return true;
+}
+
+// skip marca las columnas que ya ha movido otro (las que aceleran).
+void AnalyticEngine::MoveSteps(unsigned long long steps, const bool* skip)
+{
+	for (int i = 0; i < kTotalColumns; i++) {
+		if (skip != NULL && skip[i]) {
+			continue;
+		}
+		double increment = kStepTime * (1 / state.factor[i]);
+		state.clock[i] = state.clock[i] + (double)steps * increment;
+	}
+	state.step += steps;
+	state.elapsed = (double)state.step * kStepTime;
+}
+
+void AnalyticEngine::MoveTime(double elapsed, const bool* skip)
+{
+	for (int i = 0; i < kTotalColumns; i++) {
+		if (skip != NULL && skip[i]) {
+			continue;
+		}
+		state.clock[i] += elapsed / state.factor[i];
+	}
+	state.elapsed += elapsed;
+	state.step = (unsigned long long)ceil(state.elapsed / kStepTime);
+}
+
+// Como StepsToReach, para el primer paso en el que el intervalo x - y
+// cumple la condicion.
+static bool StepsToCross(double cx, double ix, double cy, double iy, double threshold, bool down,
+	unsigned long long& steps)
+{
+	double slope = ix - iy;
+	double need = (threshold - (cx - cy)) / slope;
+	if (!(need >= 0.0 && need < 1.0e18) || (down ? slope >= 0.0 : slope <= 0.0)) {
+		return false;
+	}
+	auto holds = [&](unsigned long long m) {
+		double value = (cx + (double)m * ix) - (cy + (double)m * iy);
+		return down ? value <= threshold : value >= threshold;
+	};
+	unsigned long long m = (unsigned long long)ceil(need);
+	for (int guard = 0; !holds(m); guard++) {
+		if (guard > 64) {
+			return false;
+		}
+		m++;
+	}
+	while (m > 0 && holds(m - 1)) {
+		m--;
+	}
+	steps = m;
+	return true;
+}
+
+// Condicion por intervalo que se cumple antes; basta mirar la primera
+// pendiente de cada grupo del indice.
+bool AnalyticEngine::NextCondition(size_t& slot, unsigned long long& steps, double& wait) const
+{
+	bool found = false;
+	for (size_t i = 0; i < index.ConditionGroupCount(); i++) {
+		uint32_t event;
+		int window;
+		if (!index.PeekCondition(i, event, window)) {
+			continue;
+		}
+		const AppEvent& ev = events[event];
+		int cx = GetIndexForLabelInWindow(window, kIntervalLabels[ev.interval][0]);
+		int cy = GetIndexForLabelInWindow(window, kIntervalLabels[ev.interval][1]);
+		bool down = ev.direction == kSentidoBaja;
+		if (mode == kPorPasos) {
+			unsigned long long needed;
+			if (StepsToCross(state.clock[cx], kStepTime * (1 / state.factor[cx]), state.clock[cy],
+				kStepTime * (1 / state.factor[cy]), ev.time, down, needed) && (!found || needed < steps)) {
+				steps = needed;
+				slot = i;
+				found = true;
+			}
+		} else {
+			double slope = 1 / state.factor[cx] - 1 / state.factor[cy];
+			double w = (ev.time - (state.clock[cx] - state.clock[cy])) / slope;
+			if (w >= 0.0 && isfinite(w) && (down ? slope < 0.0 : slope > 0.0) && (!found || w < wait)) {
+				wait = w;
+				slot = i;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+void AnalyticEngine::SetColumnVelocity(int col, double requested)
+{
+	state.velocity[col] = ClampVelocity(requested);
+	state.factor[col] = FactorFromVelocity(state.velocity[col]);
+	if (current != NULL) {
+		current->requested = requested;
+		current->velocity = state.velocity[col];
+	}
+}
+
+// Como el modelo de dilatacion del programa: las demas ventanas ven el
+// cambio con el signo contrario.
+void AnalyticEngine::AddVelocity(int window, char label, double delta)
+{
+	// Columnas desconocidas (-1) se ignoran, como en StepSimulation.
+	int col = GetIndexForLabelInWindow(window, label);
+	if (col >= 0) {
+		SetColumnVelocity(col, state.velocity[col] + ((window == 0) ? delta : -delta));
+	}
+}
+
+void AnalyticEngine::SetVelocity(int window, char label, double velocity)
+{
+	int col = GetIndexForLabelInWindow(window, label);
+	if (col >= 0) {
+		SetColumnVelocity(col, (window == 0) ? velocity : -velocity);
+	}
+}
+
+void AnalyticEngine::StartAcceleration(const AppEvent& ev, int window)
+{
+	int col = GetIndexForLabelInWindow(window, ColumnLabel(ev.column));
+	if (col >= 0) {
+		accelerations.Start(col, (window == 0) ? ev.amount : -ev.amount, ev.duration);
+	}
+}
+
+// Un paso con rampas o aceleraciones activas, en el mismo orden que
+// StepSimulation.
+void AnalyticEngine::StepOnce()
+{
+	ramps.Step(*this);
+	bool moved[kTotalColumns] = {};
+	bool accelerating = accelerations.Active();
+	if (accelerating) {
+		accelerations.Advance(kStepTime, state.clock, state.velocity, moved);
+	}
+	if (mode == kPorPasos) {
+		MoveSteps(1, moved);
+	} else {
+		MoveTime(kStepTime, moved);
+	}
+	if (accelerating) {
+		for (int i = 0; i < kTotalColumns; i++) {
+			if (moved[i]) {
+				state.factor[i] = FactorFromVelocity(state.velocity[i]);
+			}
+		}
+	}
+}
+
+void AnalyticEngine::Apply(std::vector<AnalyticTrigger>& fired)
+{
+	for (size_t d = 0; d < collected.size(); d++) {
+		AnalyticTrigger trigger;
+		trigger.event = collected[d].event;
+		trigger.window = collected[d].window;
+		trigger.step = state.step;
+		trigger.elapsed = state.elapsed;
+		trigger.requested = 0.0;
+		trigger.velocity = 0.0;
+		current = &trigger;
+		DispatchEvent(*this, events[trigger.event], trigger.event, trigger.window);
+		current = NULL;
+		fired.push_back(trigger);
+	}
+}
+
+void AnalyticEngine::Fire(std::vector<AnalyticTrigger>& fired)
+{
+	double columnTimes[kWindowCount * kIndexColumns];
+	double intervals[kWindowCount * kIntervalCount];
+	for (int k = 0; k < kWindowCount * kIndexColumns; k++) {
+		columnTimes[k] = state.clock[keyColumn[k]];
+	}
+	// Los intervalos solo hacen falta si hay eventos que dependen de ellos.
+	const double* intervalValues = NULL;
+	if (index.ConditionCount() > 0) {
+		GetIntervalValues(state.clock, intervals);
+		intervalValues = intervals;
+	}
+	collected.clear();
+	index.Collect(columnTimes, collected, intervalValues);
+	Apply(fired);
+}
+
+bool AnalyticEngine::Advance(std::vector<AnalyticTrigger>& fired)
+{
+	size_t before = fired.size();
+	// Lo que ya se ha alcanzado en la posicion actual (por ejemplo tiempo 0).
+	Fire(fired);
+	if (fired.size() != before) {
+		return true;
+	}
+	if (ramps.Active() || accelerations.Active()) {
+		StepOnce();
+		Fire(fired);
+		return true;
+	}
+
+	int nextKey = -1;
+	unsigned long long nextSteps = 0;
+	double nextWait = INFINITY;
+	for (int k = 0; k < index.KeyCount(); k++) {
+		double target;
+		if (!index.Peek(k, target)) {
+			continue;
+		}
+		int col = keyColumn[k];
+		if (mode == kPorPasos) {
+			unsigned long long steps;
+			if (StepsToReach(state.clock[col], kStepTime * (1 / state.factor[col]), target, steps) &&
+				(nextKey < 0 || steps < nextSteps)) {
+				nextSteps = steps;
+				nextKey = k;
+			}
+		} else {
+			double wait = (target - state.clock[col]) * state.factor[col];
+			if (wait < 0.0) {
+				wait = 0.0;
+			}
+			if (wait < nextWait) {
+				nextWait = wait;
+				nextKey = k;
+			}
+		}
+	}
+	size_t slot = 0;
+	unsigned long long conditionSteps = 0;
+	double conditionWait = INFINITY;
+	bool condition = NextCondition(slot, conditionSteps, conditionWait);
+	if (condition && nextKey >= 0) {
+		condition = (mode == kPorPasos) ? conditionSteps < nextSteps : conditionWait < nextWait;
+	}
+	if (nextKey < 0 && !condition) {
+		return false;
+	}
+
+	if (mode == kPorPasos) {
+		MoveSteps(condition ? conditionSteps : nextSteps);
+	} else if (condition) {
+		MoveTime(conditionWait);
+		// El redondeo puede dejar el intervalo justo antes del umbral.
+		collected.clear();
+		index.FireCondition(slot, collected);
+		Apply(fired);
+	} else {
+		MoveTime(nextWait);
+		// Evita que el redondeo deje el reloj justo por debajo del evento.
+		double target;
+		if (index.Peek(nextKey, target) && state.clock[keyColumn[nextKey]] < target) {
+			state.clock[keyColumn[nextKey]] = target;
+		}
+	}
+	Fire(fired);
+	return true;
+}
+
+void AnalyticEngine::AdvanceToStep(unsigned long long step, std::vector<AnalyticTrigger>* fired)
+{
+	std::vector<AnalyticTrigger> ignored;
+	std::vector<AnalyticTrigger>& out = (fired != NULL) ? *fired : ignored;
+	while (state.step < step) {
+		Fire(out);
+		unsigned long long steps = step - state.step;
+		if (ramps.Active() || accelerations.Active()) {
+			StepOnce();
+			continue;
+		}
+		size_t slot;
+		unsigned long long needed;
+		double wait;
+		if (NextCondition(slot, needed, wait) && needed > 0 && needed < steps) {
+			steps = needed;
+		}
+		for (int k = 0; k < index.KeyCount(); k++) {
+			double target;
+			unsigned long long needed;
+			int col = keyColumn[k];
+			if (index.Peek(k, target) &&
+				StepsToReach(state.clock[col], kStepTime * (1 / state.factor[col]), target, needed) &&
+				needed > 0 && needed < steps) {
+				steps = needed;
+			}
+		}
+		MoveSteps(steps);
+	}
+}
+
+void AnalyticEngine::Run(std::vector<AnalyticTrigger>* fired)
+{
+	std::vector<AnalyticTrigger> batch;
+	while (Advance(batch)) {
+		if (fired != NULL) {
+			fired->insert(fired->end(), batch.begin(), batch.end());
+		}
+		batch.clear();
+	}
+}
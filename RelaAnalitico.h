@@ -0,0 +1,106 @@
+#ifndef RELAANALITICO_H_INCLUDED
+#define RELAANALITICO_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "RelaAceleracion.h"
+#include "RelaEventos.h"
+#include "RelaIndice.h"
+#include "RelaModelo.h"
+#include "RelaTipos.h"
+
+// Evento aplicado por el motor analitico.
+struct AnalyticTrigger {
+	uint32_t event;
+	int window;
+	unsigned long long step;   // StepCount en el que se dispara
+	double elapsed;            // tiempo de simulacion en ese momento
+	double requested;          // cambio y fijar: velocidad antes del recorte
+	double velocity;           // cambio y fijar: velocidad resultante
+};
+
+// Estado de los relojes, con los mismos indices que Times/Velocidades/Factors.
+struct AnalyticState {
+	double clock[kTotalColumns];
+	double velocity[kTotalColumns];
+	double factor[kTotalColumns];
+	double elapsed;
+	unsigned long long step;
+};
+
+/*
+ * Simulacion sin pasos.  Entre eventos cada reloj avanza a ritmo constante
+ * (1 / factor), asi que el motor calcula directamente cual es el siguiente
+ * evento y salta hasta el.  El coste depende del numero de eventos, no del
+ * de pasos.
+ *
+ * kPorPasos reproduce StepSimulation: los eventos se comprueban al principio
+ * de cada paso, con los relojes cuantizados a pasos de kStepTime, y los
+ * resultados coinciden con el bucle de DrawScene salvo el redondeo de la
+ * suma paso a paso.  kContinuo da el instante exacto de cada evento.
+ *
+ * Las pausas no cambian los relojes (todo se para a la vez), asi que aqui
+ * solo quedan registradas, igual que las instantaneas; step cuenta los
+ * pasos de simulacion como StepCount.  Los eventos por intervalo se cruzan
+ * de forma exacta porque entre eventos cada intervalo es lineal.  Mientras
+ * hay una rampa o una aceleracion activa el motor avanza de paso en paso
+ * (en kContinuo, pasos de kStepTime), como el programa.
+ */
+class AnalyticEngine : private EventTarget {
+public:
+	enum Mode {
+		kContinuo,
+		kPorPasos
+	};
+
+	explicit AnalyticEngine(Mode mode = kPorPasos);
+
+	// Los eventos se usan por referencia; tienen que seguir vivos.
+	void Load(const AppEvent* events, size_t count);
+	void Reset();
+
+	// Salta al siguiente grupo de eventos simultaneos y los aplica.  Devuelve
+	// false (sin mover los relojes) si ya no queda ninguno.  Con una rampa o
+	// una aceleracion activa avanza un solo paso, aunque no se dispare nada.
+	bool Advance(std::vector<AnalyticTrigger>& fired);
+
+	// Aplica los eventos hasta el paso indicado y deja los relojes en el
+	// (solo kPorPasos).
+	void AdvanceToStep(unsigned long long step, std::vector<AnalyticTrigger>* fired);
+
+	// Hasta el ultimo evento.
+	void Run(std::vector<AnalyticTrigger>* fired);
+
+	const AnalyticState& State() const { return state; }
+
+private:
+	void MoveSteps(unsigned long long steps, const bool* skip = NULL);
+	void MoveTime(double elapsed, const bool* skip = NULL);
+	void StepOnce();
+	void Fire(std::vector<AnalyticTrigger>& fired);
+	void Apply(std::vector<AnalyticTrigger>& fired);
+	bool NextCondition(size_t& slot, unsigned long long& steps, double& wait) const;
+
+	// EventTarget
+	void Pausa(uint32_t, int) override {}
+	void AddVelocity(int window, char label, double delta) override;
+	void SetVelocity(int window, char label, double velocity) override;
+	void StartRamp(const AppEvent& ev, int window) override { ramps.Start(ev, window); }
+	void Instantanea(uint32_t, int) override {}
+	void StartAcceleration(const AppEvent& ev, int window) override;
+	void SetColumnVelocity(int col, double requested);
+
+	Mode mode;
+	const AppEvent* events;
+	size_t eventCount;
+	EventIndex index;
+	int keyColumn[kWindowCount * kIndexColumns];
+	std::vector<EventoDisparado> collected;
+	RampSet ramps;
+	AccelerationSet accelerations;
+	AnalyticTrigger* current;   // evento que se esta aplicando (no en las rampas)
+	AnalyticState state;
+};
+
+#endif // RELAANALITICO_H_INCLUDED
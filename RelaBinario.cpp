@@ -0,0 +1,262 @@
+#include <stdio.h>
+#include <string.h>
+#include "RelaBinario.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+uint32_t ScenarioChecksum(const void* records, size_t bytes)
+{
+	// El static local se inicializa una sola vez aunque llamen varios hilos.
+	struct Tabla { uint32_t entries[256]; };
+	static const Tabla table = []() {
+		Tabla t;
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++) {
+				c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+			}
+			t.entries[i] = c;
+		}
+		return t;
+	}();
+	const unsigned char* p = (const unsigned char*)records;
+	const unsigned char* end = p + bytes;
+	uint32_t crc = 0xFFFFFFFFu;
+	for (; p < end; p++) {
+		crc = table.entries[(crc ^ *p) & 0xFF] ^ (crc >> 8);
+	}
+	return crc ^ 0xFFFFFFFFu;
+}
+
+bool IsScenarioBinary(const char* filePath)
+{
+	FILE* f = fopen(filePath, "rb");
+	if (f == NULL) {
+		return false;
+	}
+	char magic[4];
+	bool match = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+		memcmp(magic, kScenarioMagic, sizeof(magic)) == 0;
+	fclose(f);
+	return match;
+}
+
+bool WriteScenarioBinary(const char* filePath, const ScenarioConfig& config, std::string& error)
+{
+	ScenarioBinaryHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, kScenarioMagic, sizeof(header.magic));
+	header.version = kScenarioVersion;
+	header.recordSize = (uint16_t)sizeof(AppEvent);
+	header.eventCount = (uint32_t)config.eventos.size();
+	header.checksum = ScenarioChecksum(config.eventos.data(), config.eventos.size() * sizeof(AppEvent));
+	header.telemetriaPuerto = config.telemetriaPuerto;
+	header.telemetriaDecimacion = config.telemetriaDecimacion;
+	header.recargaActiva = config.recargaActiva ? 1 : 0;
+	header.recargaModo = (uint8_t)config.recargaModo;
+	header.fisicaModelo = (uint8_t)config.fisicaModelo;
+	for (int i = 0; i < kFisicaMarcos; i++) {
+		header.fisicaMarcos[i] = config.fisicaMarcos[i];
+	}
+
+	std::string tempPath = std::string(filePath) + ".tmp";
+	FILE* f = fopen(tempPath.c_str(), "wb");
+	if (f == NULL) {
+		error = "no se pudo crear " + tempPath;
+		return false;
+	}
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	if (ok && !config.eventos.empty()) {
+		ok = fwrite(config.eventos.data(), sizeof(AppEvent), config.eventos.size(), f) == config.eventos.size();
+	}
+	if (fclose(f) != 0) {
+		ok = false;
+	}
+	if (!ok) {
+		remove(tempPath.c_str());
+		error = "fallo al escribir " + tempPath;
+		return false;
+	}
+#ifdef WIN32
+	remove(filePath);
+#endif
+	if (rename(tempPath.c_str(), filePath) != 0) {
+		remove(tempPath.c_str());
+		error = std::string("no se pudo renombrar a ") + filePath;
+		return false;
+	}
+	return true;
+}
+
+MappedScenario::MappedScenario()
+	: events(NULL), base(NULL), length(0)
+#ifdef WIN32
+	, fileHandle(INVALID_HANDLE_VALUE), mappingHandle(NULL)
+#endif
+{
+	memset(&header, 0, sizeof(header));
+}
+
+MappedScenario::~MappedScenario()
+{
+	Close();
+}
+
+void MappedScenario::Close()
+{
+#ifdef WIN32
+	if (base != NULL) {
+		UnmapViewOfFile(base);
+	}
+	if (mappingHandle != NULL) {
+		CloseHandle(mappingHandle);
+		mappingHandle = NULL;
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (base != NULL) {
+		munmap(base, length);
+	}
+#endif
+	base = NULL;
+	length = 0;
+	memset(&header, 0, sizeof(header));
+	events = NULL;
+	converted.clear();
+}
+
+bool MappedScenario::Open(const char* filePath, std::string& error, bool verifyChecksum)
+{
+	Close();
+#ifdef WIN32
+	fileHandle = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		error = std::string("no se pudo abrir ") + filePath;
+		return false;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart < (LONGLONG)kScenarioHeaderSizeV1) {
+		Close();
+		error = "fichero demasiado corto";
+		return false;
+	}
+	length = (size_t)size.QuadPart;
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mappingHandle != NULL) {
+		base = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	}
+	if (base == NULL) {
+		Close();
+		error = "no se pudo mapear el fichero";
+		return false;
+	}
+#else
+	int fd = open(filePath, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		error = std::string("no se pudo abrir ") + filePath;
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t)kScenarioHeaderSizeV1) {
+		close(fd);
+		error = "fichero demasiado corto";
+		return false;
+	}
+	length = (size_t)st.st_size;
+	void* p = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+	// El mapeo sigue siendo valido despues de cerrar el descriptor.
+	close(fd);
+	if (p == MAP_FAILED) {
+		length = 0;
+		error = "no se pudo mapear el fichero";
+		return false;
+	}
+	base = p;
+#endif
+
+	// La version 1 tiene la cabecera corta; lo que falta queda a cero.
+	// Los registros de la version 2 y anteriores son el principio de los
+	// actuales; lo que falta queda a cero.
+	const ScenarioBinaryHeader* h = (const ScenarioBinaryHeader*)base;
+	size_t headerSize = (h->version == 1) ? kScenarioHeaderSizeV1 : sizeof(ScenarioBinaryHeader);
+	size_t recordSize = (h->version < 3) ? kScenarioRecordSizeV2 : sizeof(AppEvent);
+	if (memcmp(h->magic, kScenarioMagic, sizeof(h->magic)) != 0) {
+		error = "no es un escenario binario";
+	} else if (h->version < 1 || h->version > kScenarioVersion) {
+		error = "version del escenario no soportada";
+	} else if (length < headerSize) {
+		error = "fichero truncado";
+	} else if (h->recordSize != recordSize) {
+		error = "tamano de registro no valido";
+	} else if ((length - headerSize) / recordSize < h->eventCount) {
+		error = "fichero truncado";
+	} else {
+		const char* records = (const char*)base + headerSize;
+		if (!verifyChecksum || ScenarioChecksum(records, h->eventCount * recordSize) == h->checksum) {
+			memset(&header, 0, sizeof(header));
+			memcpy(&header, h, headerSize);
+			header.version = kScenarioVersion;
+			header.recordSize = (uint16_t)sizeof(AppEvent);
+			if (recordSize == sizeof(AppEvent)) {
+				events = (const AppEvent*)records;
+				return true;
+			}
+			converted.assign(h->eventCount, AppEvent());
+			for (uint32_t i = 0; i < h->eventCount; i++) {
+				memcpy(&converted[i], records + i * recordSize, recordSize);
+			}
+			events = converted.data();
+			if (events == NULL) {
+				// Sin eventos IsOpen() tiene que seguir siendo true.
+				converted.reserve(1);
+				events = converted.data();
+			}
+			return true;
+		}
+		error = "la suma de comprobacion no coincide";
+	}
+	Close();
+	return false;
+}
+
+void MappedScenario::CopySettingsTo(ScenarioConfig& out) const
+{
+	out.telemetriaPuerto = header.telemetriaPuerto;
+	out.telemetriaDecimacion = header.telemetriaDecimacion;
+	out.recargaActiva = header.recargaActiva != 0;
+	out.recargaModo = (header.recargaModo == kRecargaReiniciar) ? kRecargaReiniciar : kRecargaPreservar;
+	out.fisicaModelo = (header.fisicaModelo == kFisicaLorentz) ? kFisicaLorentz : kFisicaDilatacion;
+	for (int i = 0; i < kFisicaMarcos; i++) {
+		out.fisicaMarcos[i] = header.fisicaMarcos[i];
+	}
+}
+
+void MappedScenario::CopyTo(ScenarioConfig& out) const
+{
+	out.eventos.assign(events, events + Count());
+	CopySettingsTo(out);
+}
+
+bool LoadScenarioFile(const char* filePath, ScenarioConfig& out, std::string& error)
+{
+	if (!IsScenarioBinary(filePath)) {
+		return LoadEventosFromYaml(filePath, out, error);
+	}
+	MappedScenario mapped;
+	if (!mapped.Open(filePath, error, true)) {
+		return false;
+	}
+	mapped.CopyTo(out);
+	return true;
+}
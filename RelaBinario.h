@@ -0,0 +1,101 @@
+#ifndef RELABINARIO_H_INCLUDED
+#define RELABINARIO_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "RelaEventos.h"
+
+/*
+ * Escenario compilado.  config.yaml sigue siendo el formato de edicion;
+ * escenario_bin lo convierte a este formato, que el programa mapea en
+ * memoria de solo lectura sin parsear nada.  Varios procesos con el mismo
+ * fichero comparten las paginas en la cache del sistema.
+ *
+ *   ScenarioBinaryHeader (64 bytes; 32 en la version 1, sin fisica)
+ *   AppEvent[eventCount] (40 bytes cada uno, alineados a 8; 24 hasta la
+ *                         version 2, sin disparos por intervalo ni periodos)
+ *
+ * Los enteros y los double se guardan en el orden de bytes de la maquina;
+ * un fichero de otro orden de bytes se rechaza por la version, que leida
+ * al reves queda fuera de rango.
+ */
+const char kScenarioMagic[4] = { 'R', 'L', 'E', 'V' };
+const uint16_t kScenarioVersion = 3;
+
+struct ScenarioBinaryHeader {
+	char magic[4];
+	uint16_t version;
+	uint16_t recordSize;        // sizeof(AppEvent)
+	uint32_t eventCount;
+	uint32_t checksum;          // CRC-32 de los registros
+	int32_t telemetriaPuerto;
+	int32_t telemetriaDecimacion;
+	uint8_t recargaActiva;
+	uint8_t recargaModo;        // ReloadMode
+	uint8_t fisicaModelo;       // PhysicsModel (desde la version 2)
+	uint8_t reserved[5];
+	double fisicaMarcos[kFisicaMarcos];
+	uint8_t reserved2[8];
+};
+
+static_assert(sizeof(AppEvent) == 40, "AppEvent es el registro del formato binario");
+static_assert(sizeof(ScenarioBinaryHeader) == 64, "cabecera del formato binario");
+const size_t kScenarioHeaderSizeV1 = 32;
+const size_t kScenarioRecordSizeV2 = 24;
+
+// true si el fichero empieza por la firma del formato binario.
+bool IsScenarioBinary(const char* filePath);
+
+// Escribe el escenario en formato binario (a un temporal que luego se renombra,
+// para no tocar las paginas que otros procesos tengan mapeadas).
+bool WriteScenarioBinary(const char* filePath, const ScenarioConfig& config, std::string& error);
+
+// CRC-32 de los registros tal como estan en el fichero.
+uint32_t ScenarioChecksum(const void* records, size_t bytes);
+
+/*
+ * Fichero binario mapeado.  Open() solo comprueba la cabecera y el tamano,
+ * asi que no depende del numero de eventos; verifyChecksum recorre ademas
+ * todos los registros.  Los ficheros de versiones con registros mas cortos
+ * se copian a memoria con el registro actual.
+ */
+class MappedScenario {
+public:
+	MappedScenario();
+	~MappedScenario();
+
+	bool Open(const char* filePath, std::string& error, bool verifyChecksum = false);
+	void Close();
+
+	bool IsOpen() const { return events != NULL; }
+	// Cabecera en formato de la version actual (las antiguas se completan).
+	const ScenarioBinaryHeader& Header() const { return header; }
+	const AppEvent* Events() const { return events; }
+	size_t Count() const { return events != NULL ? header.eventCount : 0; }
+
+	// Copia la configuracion, sin los eventos.
+	void CopySettingsTo(ScenarioConfig& out) const;
+	// Copia la configuracion y los eventos a un ScenarioConfig normal.
+	void CopyTo(ScenarioConfig& out) const;
+
+private:
+	MappedScenario(const MappedScenario&);
+	void operator=(const MappedScenario&);
+
+	ScenarioBinaryHeader header;
+	const AppEvent* events;
+	std::vector<AppEvent> converted;   // registros de versiones antiguas
+	void* base;
+	size_t length;
+#ifdef WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+};
+
+// Lee un escenario en cualquiera de los dos formatos (se distingue por la firma).
+bool LoadScenarioFile(const char* filePath, ScenarioConfig& out, std::string& error);
+
+#endif // RELABINARIO_H_INCLUDED
@@ -0,0 +1,749 @@
+#include <math.h>
+#include <stdio.h>
+#include <cctype>
+#include <stdexcept>
+#include <yaml-cpp/yaml.h>
+#include <yaml-cpp/eventhandler.h>
+#include "RelaEventos.h"
+#include "RelaTipos.h"
+#include "RelaYaml.h"
+
+// Un evento tal como aparece en config.yaml.  Los campos van en el orden de
+// EventField (RelaTipos.h), asi que YamlBit(kCampoX) es el bit del campo.
+struct EventoYaml {
+	std::string tipo;
+	std::string columna;
+	double tiempo;
+	double cantidad;
+	double velocidad;
+	double duracion;
+	double periodo;
+	int repeticiones;
+	std::string intervalo;
+	double umbral;
+	std::string sentido;
+	double aceleracion;
+	YamlLectura yaml;
+};
+
+static const YamlCampo<EventoYaml> kCamposEvento[] = {
+	YAML_CAMPO(EventoYaml, tipo, true),
+	YAML_CAMPO(EventoYaml, columna, true),
+	YAML_CAMPO(EventoYaml, tiempo, false),
+	YAML_CAMPO(EventoYaml, cantidad, false),
+	YAML_CAMPO(EventoYaml, velocidad, false),
+	YAML_CAMPO(EventoYaml, duracion, false),
+	YAML_CAMPO(EventoYaml, periodo, false),
+	YAML_CAMPO(EventoYaml, repeticiones, false),
+	YAML_CAMPO(EventoYaml, intervalo, false),
+	YAML_CAMPO(EventoYaml, umbral, false),
+	YAML_CAMPO(EventoYaml, sentido, false),
+	YAML_CAMPO(EventoYaml, aceleracion, false),
+};
+static_assert(sizeof(kCamposEvento) / sizeof(kCamposEvento[0]) == kCampoCount,
+	"un campo de EventoYaml por EventField");
+
+static const double* NumericField(const EventoYaml& e, int field)
+{
+	switch (field) {
+	case kCampoTiempo: return &e.tiempo;
+	case kCampoCantidad: return &e.cantidad;
+	case kCampoVelocidad: return &e.velocidad;
+	case kCampoDuracion: return &e.duracion;
+	case kCampoPeriodo: return &e.periodo;
+	case kCampoUmbral: return &e.umbral;
+	case kCampoAceleracion: return &e.aceleracion;
+	default: return NULL;
+	}
+}
+
+static std::string NumberText(double value)
+{
+	char text[32];
+	snprintf(text, sizeof(text), "%g", value);
+	return text;
+}
+
+static std::string NumberText(int value)
+{
+	return std::to_string(value);
+}
+
+// Secciones de config.yaml.  Los valores iniciales son los de una seccion
+// presente pero vacia.
+struct TelemetriaYaml {
+	int puerto;
+	int decimacion;
+	YamlLectura yaml;
+
+	TelemetriaYaml() : puerto(1162), decimacion(1) {}
+};
+
+enum { kTelemetriaPuerto, kTelemetriaDecimacion };
+
+static const YamlCampo<TelemetriaYaml> kCamposTelemetria[] = {
+	YAML_CAMPO(TelemetriaYaml, puerto, false),
+	YAML_CAMPO(TelemetriaYaml, decimacion, false),
+};
+
+struct RecargaYaml {
+	bool activa;
+	std::string estado;
+	YamlLectura yaml;
+
+	RecargaYaml() : activa(true), estado("preservar") {}
+};
+
+enum { kRecargaActiva, kRecargaEstado };
+
+static const YamlCampo<RecargaYaml> kCamposRecarga[] = {
+	YAML_CAMPO(RecargaYaml, activa, false),
+	YAML_CAMPO(RecargaYaml, estado, false),
+};
+
+struct FisicaYaml {
+	std::string modelo;
+	double marco0;
+	double marco1;
+	double marco2;
+	YamlLectura yaml;
+
+	FisicaYaml() : modelo("lorentz"), marco0(0.0), marco1(0.0), marco2(0.0) {}
+};
+
+enum { kFisicaModelo, kFisicaMarco0 };
+
+static const YamlCampo<FisicaYaml> kCamposFisica[] = {
+	YAML_CAMPO(FisicaYaml, modelo, false),
+	YAML_CAMPO(FisicaYaml, marco0, false),
+	YAML_CAMPO(FisicaYaml, marco1, false),
+	YAML_CAMPO(FisicaYaml, marco2, false),
+};
+static_assert(sizeof(kCamposFisica) / sizeof(kCamposFisica[0]) == kFisicaModelo + 1 + kFisicaMarcos,
+	"un campo marcoN por ventana");
+
+// Claves de primer nivel que se leen.
+enum { kClaveEventos, kClaveTelemetria, kClaveRecarga, kClaveFisica };
+static const char* const kClavesRaiz[] = { "eventos", "telemetria", "recarga", "fisica" };
+
+/*
+ * Lector de escenarios por eventos del parser: rellena ScenarioConfig a
+ * medida que llegan los escalares, sin construir el arbol de YAML::Node.
+ * Las claves desconocidas y los subarboles que no interesan se saltan.
+ */
+class ScenarioEventHandler : public YAML::EventHandler {
+public:
+	ScenarioEventHandler(ScenarioConfig& out, ScenarioDiagnostics* diagnostics)
+		: out(out), diagnostics(diagnostics), skipDepth(0), expectKey(true),
+		  eventos(kCamposEvento, pendientes), lectorTelemetria(kCamposTelemetria),
+		  lectorRecarga(kCamposRecarga), lectorFisica(kCamposFisica)
+	{
+		for (size_t i = 0; i < sizeof(kClavesRaiz) / sizeof(kClavesRaiz[0]); i++) {
+			clavesRaiz.Anadir(kClavesRaiz[i]);
+		}
+	}
+
+	void OnDocumentStart(const YAML::Mark&) override {}
+	void OnDocumentEnd() override {}
+
+	// Dentro de 'eventos' todo va a la lista, que rellena 'pendientes', y
+	// dentro de una seccion a su lector.  Los nodos con ancla se guardan aqui
+	// para que sus alias valgan en cualquier parte del documento: el de un
+	// escalar se sustituye por su valor y el de una coleccion repite sus
+	// eventos, asi que los lectores no ven ni anclas ni alias.
+	void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override
+	{
+		anclas.OnNull(mark, anchor);
+		if (YAML::EventHandler* lector = Lector()) {
+			lector->OnNull(mark, YAML::NullAnchor);
+			return;
+		}
+		OnScalarValue(mark, std::string());
+	}
+	void OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override
+	{
+		const std::string* value = anclas.Buscar(anchor);
+		if (value != NULL) {
+			OnScalar(mark, std::string(), YAML::NullAnchor, *value);
+			return;
+		}
+		if (anclas.Repetir(anchor, *this)) {
+			return;
+		}
+		// Alias dentro de su propia coleccion: se salta como ella.
+		if (LectorValorUtil()) {
+			Report(mark, "alias no soportado (dentro de su coleccion)", std::string());
+		}
+		if (YAML::EventHandler* lector = Lector()) {
+			lector->OnAlias(mark, anchor);
+		} else if (skipDepth == 0 && enRaiz) {
+			StartSkip();
+			OnCollectionEnd();
+		}
+	}
+	void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		const std::string& value) override
+	{
+		anclas.OnScalar(mark, tag, anchor, value);
+		if (YAML::EventHandler* lector = Lector()) {
+			lector->OnScalar(mark, tag, YAML::NullAnchor, value);
+			return;
+		}
+		OnScalarValue(mark, value);
+	}
+
+	void OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		YAML::EmitterStyle::value style) override
+	{
+		anclas.OnSequenceStart(mark, tag, anchor, style);
+		if (YAML::EventHandler* lector = Lector()) {
+			lector->OnSequenceStart(mark, tag, YAML::NullAnchor, style);
+			return;
+		}
+		OnCollectionStart(mark, tag, style, false);
+	}
+	void OnSequenceEnd() override
+	{
+		anclas.OnSequenceEnd();
+		if (YAML::EventHandler* lector = Lector()) {
+			lector->OnSequenceEnd();
+			AfterLector();
+			return;
+		}
+		OnCollectionEnd();
+	}
+
+	void OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		YAML::EmitterStyle::value style) override
+	{
+		anclas.OnMapStart(mark, tag, anchor, style);
+		if (YAML::EventHandler* lector = Lector()) {
+			lector->OnMapStart(mark, tag, YAML::NullAnchor, style);
+			return;
+		}
+		OnCollectionStart(mark, tag, style, true);
+	}
+	void OnMapEnd() override
+	{
+		anclas.OnMapEnd();
+		if (YAML::EventHandler* lector = Lector()) {
+			lector->OnMapEnd();
+			AfterLector();
+			return;
+		}
+		OnCollectionEnd();
+	}
+
+	bool foundEventos() const { return sawEventos; }
+
+private:
+	static std::runtime_error Error(const YAML::Mark& mark, const char* what, const std::string& value)
+	{
+		char msg[160];
+		if (value.empty()) {
+			snprintf(msg, sizeof(msg), "linea %d, columna %d: %s", mark.line + 1, mark.column + 1, what);
+		} else {
+			snprintf(msg, sizeof(msg), "linea %d, columna %d: %s '%.60s'", mark.line + 1, mark.column + 1, what,
+				value.c_str());
+		}
+		return std::runtime_error(msg);
+	}
+
+	// Quien recibe los eventos: la lista de eventos, el lector de la seccion
+	// abierta o, con NULL, el propio mapa raiz.
+	YAML::EventHandler* Lector()
+	{
+		if (enEventos) {
+			return &eventos;
+		}
+		switch (seccion) {
+		case kClaveTelemetria: return &lectorTelemetria;
+		case kClaveRecarga: return &lectorRecarga;
+		case kClaveFisica: return &lectorFisica;
+		default: return NULL;
+		}
+	}
+
+	// Si el siguiente nodo se usa, para quien lo vaya a recibir.
+	bool LectorValorUtil() const
+	{
+		if (enEventos) {
+			return eventos.ValorUtil();
+		}
+		switch (seccion) {
+		case kClaveTelemetria: return lectorTelemetria.ValorUtil();
+		case kClaveRecarga: return lectorRecarga.ValorUtil();
+		case kClaveFisica: return lectorFisica.ValorUtil();
+		default: return ValorUtil();
+		}
+	}
+
+	// En el mapa raiz: una clave o el valor de una clave conocida.
+	bool ValorUtil() const
+	{
+		if (skipDepth > 0 || !enRaiz) {
+			return false;
+		}
+		return expectKey || clave >= 0;
+	}
+
+	// Error que impide usar el valor: se anota o se lanza.
+	void Report(const YAML::Mark& mark, const char* what, const std::string& value)
+	{
+		if (diagnostics == NULL) {
+			throw Error(mark, what, value);
+		}
+		Note(mark, what, value);
+	}
+
+	// Problema que en ejecucion se ignora (el evento se omite o el dato no
+	// se usa); solo se anota con diagnostico.
+	void Note(const YAML::Mark& mark, const char* what, const std::string& value)
+	{
+		if (diagnostics == NULL) {
+			return;
+		}
+		char msg[160];
+		if (value.empty()) {
+			snprintf(msg, sizeof(msg), "%s", what);
+		} else {
+			snprintf(msg, sizeof(msg), "%s '%.60s'", what, value.c_str());
+		}
+		ScenarioProblem problem = { mark.line + 1, mark.column + 1, msg };
+		diagnostics->problems.push_back(problem);
+	}
+
+	void OnCollectionStart(const YAML::Mark& mark, const std::string& tag, YAML::EmitterStyle::value style,
+		bool isMap)
+	{
+		if (skipDepth > 0) {
+			skipDepth++;
+			return;
+		}
+		if (!enRaiz) {
+			if (isMap) {
+				enRaiz = true;
+				expectKey = true;
+			} else {
+				StartSkip();
+			}
+			return;
+		}
+		// Colecciones como clave o valor del mapa raiz.
+		if (!expectKey && clave == kClaveEventos && !isMap) {
+			enEventos = true;
+			sawEventos = true;
+			out.eventos.clear();
+			eventos.OnSequenceStart(mark, tag, YAML::NullAnchor, style);
+			return;
+		}
+		if (!expectKey && isMap && clave != kClaveEventos && clave >= 0) {
+			seccion = clave;
+			switch (seccion) {
+			case kClaveTelemetria:
+				telemetria = TelemetriaYaml();
+				lectorTelemetria.Empezar(telemetria);
+				break;
+			case kClaveRecarga:
+				recarga = RecargaYaml();
+				lectorRecarga.Empezar(recarga);
+				break;
+			default:
+				fisica = FisicaYaml();
+				lectorFisica.Empezar(fisica);
+				break;
+			}
+			Lector()->OnMapStart(mark, tag, YAML::NullAnchor, style);
+			return;
+		}
+		StartSkip();
+	}
+
+	void StartSkip()
+	{
+		skipDepth = 1;
+		skippingKey = expectKey;
+	}
+
+	void OnCollectionEnd()
+	{
+		if (skipDepth > 0) {
+			if (--skipDepth == 0 && enRaiz) {
+				// Una clave compleja saltada deja su valor sin clave util.
+				if (skippingKey) {
+					clave = -1;
+				}
+				expectKey = !skippingKey;
+			}
+			return;
+		}
+		enRaiz = false;
+	}
+
+	void OnScalarValue(const YAML::Mark&, const std::string& value)
+	{
+		if (skipDepth > 0 || !enRaiz) {
+			return;
+		}
+		if (expectKey) {
+			clave = clavesRaiz.Buscar(value);
+			expectKey = false;
+			return;
+		}
+		expectKey = true;
+	}
+
+	// Compila cada evento en cuanto se cierra su mapa y cada seccion al
+	// cerrarse la suya.
+	void AfterLector()
+	{
+		if (enEventos) {
+			if (!pendientes.empty()) {
+				FinishEvento(pendientes.back());
+				pendientes.clear();
+			}
+			if (eventos.Terminada()) {
+				enEventos = false;
+				expectKey = true;
+			}
+			return;
+		}
+		switch (seccion) {
+		case kClaveTelemetria:
+			if (lectorTelemetria.Terminado()) {
+				FinishTelemetria();
+				seccion = -1;
+			}
+			break;
+		case kClaveRecarga:
+			if (lectorRecarga.Terminado()) {
+				FinishRecarga();
+				seccion = -1;
+			}
+			break;
+		case kClaveFisica:
+			if (lectorFisica.Terminado()) {
+				FinishFisica();
+				seccion = -1;
+			}
+			break;
+		}
+		if (seccion < 0) {
+			expectKey = true;
+		}
+	}
+
+	// Campo numerico: false (y se anota) si no se puede usar.
+	bool ParseField(const EventoYaml& e, int field, double& value)
+	{
+		if (e.yaml.Erroneo(field)) {
+			char what[48];
+			snprintf(what, sizeof(what), "%s no es un numero", kCamposEvento[field].name);
+			Report(e.yaml.marks[field], what, e.yaml.Texto(field));
+			return false;
+		}
+		value = *NumericField(e, field);
+		return true;
+	}
+
+	// Campo de una seccion, ya convertido: false (y se anota) si no se pudo
+	// convertir o esta fuera de rango; entonces se queda el valor por defecto.
+	bool SectionField(const YamlLectura& yaml, int campo, bool enRango, const std::string& value)
+	{
+		if (yaml.Erroneo(campo)) {
+			Report(yaml.marks[campo], "valor no valido", yaml.Texto(campo));
+			return false;
+		}
+		if (yaml.Tiene(campo) && !enRango) {
+			Report(yaml.marks[campo], "valor fuera de rango", value);
+			return false;
+		}
+		return true;
+	}
+
+	void FinishTelemetria()
+	{
+		const TelemetriaYaml defaults;
+		const TelemetriaYaml& t = telemetria;
+		out.telemetriaPuerto = SectionField(t.yaml, kTelemetriaPuerto, t.puerto >= 0 && t.puerto <= 65535,
+			NumberText(t.puerto)) ? t.puerto : defaults.puerto;
+		out.telemetriaDecimacion = SectionField(t.yaml, kTelemetriaDecimacion, t.decimacion >= 1,
+			NumberText(t.decimacion)) ? t.decimacion : defaults.decimacion;
+	}
+
+	void FinishRecarga()
+	{
+		const RecargaYaml& r = recarga;
+		out.recargaActiva = SectionField(r.yaml, kRecargaActiva, true, std::string()) ? r.activa : true;
+		bool reiniciar = r.estado == "reiniciar";
+		out.recargaModo = (SectionField(r.yaml, kRecargaEstado, reiniciar || r.estado == "preservar", r.estado)
+			&& reiniciar) ? kRecargaReiniciar : kRecargaPreservar;
+	}
+
+	void FinishFisica()
+	{
+		const FisicaYaml& f = fisica;
+		bool lorentz = f.modelo == "lorentz";
+		out.fisicaModelo = (SectionField(f.yaml, kFisicaModelo, lorentz || f.modelo == "dilatacion", f.modelo)
+			&& !lorentz) ? kFisicaDilatacion : kFisicaLorentz;
+		const double marcos[kFisicaMarcos] = { f.marco0, f.marco1, f.marco2 };
+		for (int i = 0; i < kFisicaMarcos; i++) {
+			if (f.yaml.Tiene(kFisicaMarco0 + i)
+				&& SectionField(f.yaml, kFisicaMarco0 + i, fabs(marcos[i]) < 1.0, NumberText(marcos[i]))) {
+				out.fisicaMarcos[i] = marcos[i];
+			}
+		}
+	}
+
+	void FinishEvento(const EventoYaml& e)
+	{
+		const YamlLectura& yaml = e.yaml;
+		bool byInterval = yaml.Tiene(kCampoIntervalo) || yaml.Tiene(kCampoUmbral);
+		bool hasTrigger = byInterval ? (yaml.Tiene(kCampoIntervalo) && yaml.Tiene(kCampoUmbral))
+			: yaml.Tiene(kCampoTiempo);
+		if (yaml.faltan != 0 || !hasTrigger || e.columna.empty()) {
+			Note(yaml.mark, "evento incompleto (hacen falta tipo, columna y tiempo, o intervalo y umbral)",
+				std::string());
+			return;
+		}
+		AppEvent ev = {};
+		if (!FindEventType(e.tipo, ev.type)) {
+			Note(yaml.marks[kCampoTipo], "tipo desconocido", e.tipo);
+			return;
+		}
+		const EventTypeInfo& info = kEventTypes[ev.type];
+		for (int f = 0; f < kCampoCount; f++) {
+			if ((info.required & FieldBit(f)) != 0 && !yaml.Tiene(f)) {
+				char what[64];
+				snprintf(what, sizeof(what), "%s sin %s", info.name, kCamposEvento[f].name);
+				Note(yaml.mark, what, std::string());
+				return;
+			}
+		}
+		char label = (char)toupper((unsigned char)e.columna[0]);
+		ev.column = (label >= 'A' && label <= 'C') ? (uint8_t)(label - 'A') : kColumnaInvalida;
+		if (info.amountField != kCampoCount) {
+			if (!ParseField(e, info.amountField, ev.amount)) {
+				return;
+			}
+			if (!isfinite(ev.amount)) {
+				Note(yaml.marks[info.amountField], "valor no finito", NumberText(ev.amount));
+				return;
+			}
+		}
+		if ((info.required & FieldBit(kCampoDuracion)) != 0) {
+			if (!ParseField(e, kCampoDuracion, ev.duration)) {
+				return;
+			}
+			if (!(ev.duration > 0.0) || !isfinite(ev.duration)) {
+				Note(yaml.marks[kCampoDuracion], "duracion no positiva o no finita", NumberText(ev.duration));
+				return;
+			}
+		}
+		if (ev.column == kColumnaInvalida) {
+			Note(yaml.marks[kCampoColumna], "la columna no es A, B ni C", e.columna);
+			return;
+		}
+		if (byInterval ? !FinishIntervalTrigger(e, ev) : !FinishClockTrigger(e, ev)) {
+			return;
+		}
+		out.eventos.push_back(ev);
+		if (diagnostics != NULL) {
+			ScenarioPosition position = { yaml.mark.line + 1, yaml.mark.column + 1 };
+			diagnostics->eventPositions.push_back(position);
+		}
+	}
+
+	bool FinishClockTrigger(const EventoYaml& e, AppEvent& ev)
+	{
+		const YamlLectura& yaml = e.yaml;
+		ev.trigger = kDisparoReloj;
+		if (!ParseField(e, kCampoTiempo, ev.time)) {
+			return false;
+		}
+		if (!isfinite(ev.time) || ev.time < 0.0) {
+			Note(yaml.marks[kCampoTiempo], "tiempo negativo o no finito", NumberText(ev.time));
+			return false;
+		}
+		if (yaml.Tiene(kCampoPeriodo)) {
+			if (!ParseField(e, kCampoPeriodo, ev.period)) {
+				return false;
+			}
+			if (!(ev.period > 0.0) || !isfinite(ev.period)) {
+				Note(yaml.marks[kCampoPeriodo], "periodo no positivo o no finito", NumberText(ev.period));
+				return false;
+			}
+		}
+		if (yaml.Tiene(kCampoRepeticiones)) {
+			int repeats = e.repeticiones;
+			if (yaml.Erroneo(kCampoRepeticiones) || repeats < 1 || repeats > 65535) {
+				Report(yaml.marks[kCampoRepeticiones], "repeticiones no valido (1 a 65535)",
+					yaml.Erroneo(kCampoRepeticiones) ? yaml.Texto(kCampoRepeticiones) : std::to_string(repeats));
+				return false;
+			}
+			ev.repeats = (uint16_t)repeats;
+			if (!yaml.Tiene(kCampoPeriodo)) {
+				Note(yaml.marks[kCampoRepeticiones], "repeticiones sin periodo", std::string());
+			}
+		}
+		return true;
+	}
+
+	bool FinishIntervalTrigger(const EventoYaml& e, AppEvent& ev)
+	{
+		static const char* const names[3] = { "dtBA", "dtAC", "dtBC" };
+		const YamlLectura& yaml = e.yaml;
+		ev.trigger = kDisparoIntervalo;
+		ev.interval = 3;
+		for (int k = 0; k < 3; k++) {
+			if (e.intervalo == names[k]) {
+				ev.interval = (uint8_t)k;
+			}
+		}
+		if (ev.interval == 3) {
+			Note(yaml.marks[kCampoIntervalo], "intervalo desconocido (dtBA, dtAC o dtBC)", e.intervalo);
+			return false;
+		}
+		if (!ParseField(e, kCampoUmbral, ev.time)) {
+			return false;
+		}
+		if (!isfinite(ev.time)) {
+			Note(yaml.marks[kCampoUmbral], "umbral no finito", NumberText(ev.time));
+			return false;
+		}
+		ev.direction = kSentidoSube;
+		if (yaml.Tiene(kCampoSentido)) {
+			if (e.sentido == "baja") {
+				ev.direction = kSentidoBaja;
+			} else if (e.sentido != "sube") {
+				Note(yaml.marks[kCampoSentido], "sentido no es sube ni baja", e.sentido);
+				return false;
+			}
+		}
+		if (yaml.Tiene(kCampoTiempo)) {
+			Note(yaml.marks[kCampoTiempo], "con intervalo el tiempo no se usa", std::string());
+		}
+		if (yaml.Tiene(kCampoPeriodo) || yaml.Tiene(kCampoRepeticiones)) {
+			Note(yaml.mark, "los eventos por intervalo no se repiten", std::string());
+		}
+		return true;
+	}
+
+	ScenarioConfig& out;
+	ScenarioDiagnostics* diagnostics;
+	int skipDepth;
+	bool expectKey;
+	bool enRaiz = false;
+	bool sawEventos = false;
+	bool skippingKey = false;
+	YamlClaves clavesRaiz;
+	int clave = -1;         // la ultima clave del mapa raiz, de kClavesRaiz
+	YamlAnclas anclas;
+
+	// La lista de eventos deja cada evento leido en 'pendientes' y se compila
+	// al momento; el vector se reutiliza entre eventos.
+	std::vector<EventoYaml> pendientes;
+	YamlLista<EventoYaml> eventos;
+	bool enEventos = false;
+
+	// La seccion abierta (kClaveTelemetria...) o -1; cada una con su lector.
+	int seccion = -1;
+	TelemetriaYaml telemetria;
+	RecargaYaml recarga;
+	FisicaYaml fisica;
+	YamlRegistro<TelemetriaYaml> lectorTelemetria;
+	YamlRegistro<RecargaYaml> lectorRecarga;
+	YamlRegistro<FisicaYaml> lectorFisica;
+};
+
+static void AddFileProblem(ScenarioDiagnostics* diagnostics, int line, int column, const std::string& message)
+{
+	if (diagnostics != NULL) {
+		ScenarioProblem problem = { line, column, message };
+		diagnostics->problems.push_back(problem);
+	}
+}
+
+bool LoadEventosFromYaml(const char* filePath, ScenarioConfig& out, std::string& error,
+	ScenarioDiagnostics* diagnostics)
+{
+	// El parser proyecta el fichero en memoria y lo escanea en sitio.
+	YAML::Parser parser;
+	try {
+		parser.LoadFile(filePath);
+	} catch (const YAML::BadFile&) {
+		error = std::string("no se pudo abrir ") + filePath;
+		AddFileProblem(diagnostics, 0, 0, error);
+		return false;
+	}
+	try {
+		ScenarioEventHandler handler(out, diagnostics);
+		parser.HandleNextDocument(handler);
+		if (!handler.foundEventos()) {
+			error = "falta la lista 'eventos'";
+			AddFileProblem(diagnostics, 0, 0, error);
+			return false;
+		}
+		if (out.eventos.empty()) {
+			error = "el escenario no contiene eventos validos";
+			AddFileProblem(diagnostics, 0, 0, error);
+			return false;
+		}
+		return true;
+	} catch (const YAML::Exception& ex) {
+		error = ex.what();
+		if (ex.mark.is_null()) {
+			AddFileProblem(diagnostics, 0, 0, ex.msg);
+		} else {
+			AddFileProblem(diagnostics, ex.mark.line + 1, ex.mark.column + 1, ex.msg);
+		}
+	} catch (const std::exception& ex) {
+		error = ex.what();
+		AddFileProblem(diagnostics, 0, 0, error);
+	}
+	return false;
+}
+
+static bool InvalidEvent(std::string& error, size_t i, const char* what)
+{
+	char msg[128];
+	snprintf(msg, sizeof(msg), "evento %u: %s", (unsigned)i, what);
+	error = msg;
+	return false;
+}
+
+bool ValidateEventos(const AppEvent* eventos, size_t count, std::string& error)
+{
+	for (size_t i = 0; i < count; i++) {
+		const AppEvent& ev = eventos[i];
+		if (!IsKnownEventType(ev.type)) {
+			return InvalidEvent(error, i, "tipo desconocido");
+		}
+		if (ev.column >= 3) {
+			return InvalidEvent(error, i, "la columna no es A, B ni C");
+		}
+		if (ev.trigger == kDisparoReloj) {
+			if (!isfinite(ev.time) || ev.time < 0.0) {
+				return InvalidEvent(error, i, "tiempo no valido");
+			}
+			if (!isfinite(ev.period) || ev.period < 0.0) {
+				return InvalidEvent(error, i, "periodo no valido");
+			}
+		} else if (ev.trigger == kDisparoIntervalo) {
+			if (ev.interval >= 3 || ev.direction > kSentidoBaja || !isfinite(ev.time)) {
+				return InvalidEvent(error, i, "condicion de intervalo no valida");
+			}
+		} else {
+			return InvalidEvent(error, i, "disparo desconocido");
+		}
+		if (!isfinite(ev.amount) || !isfinite(ev.duration)) {
+			return InvalidEvent(error, i, "cantidad no valida");
+		}
+	}
+	return true;
+}
+
+bool ValidateEventos(const std::vector<AppEvent>& eventos, std::string& error)
+{
+	return ValidateEventos(eventos.data(), eventos.size(), error);
+}
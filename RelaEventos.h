@@ -0,0 +1,121 @@
+#ifndef RELAEVENTOS_H_INCLUDED
+#define RELAEVENTOS_H_INCLUDED
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Tipos de evento.  El nombre, los campos y la accion de cada uno estan en
+// el registro de RelaTipos.h; el valor es el indice en esa tabla.
+enum EventType {
+	kEventoPausa = 0,
+	kEventoCambio = 1,
+	kEventoFijar = 2,         // velocidad absoluta
+	kEventoRampa = 3,         // cambio repartido en 'duracion' segundos
+	kEventoInstantanea = 4,   // guarda el estado de la ventana
+	kEventoAceleracion = 5,   // aceleracion propia durante 'duracion' segundos
+	kEventTypeCount = 6
+};
+
+// Que hace que un evento se dispare.
+enum EventTrigger {
+	kDisparoReloj = 0,       // el reloj de la columna llega a 'time'
+	kDisparoIntervalo = 1    // un intervalo de la ventana cruza 'time' (el umbral)
+};
+
+enum IntervalKind {
+	kIntervaloBA = 0,
+	kIntervaloAC = 1,
+	kIntervaloBC = 2
+};
+
+enum IntervalDirection {
+	kSentidoSube = 0,        // se dispara con valor >= umbral
+	kSentidoBaja = 1         // se dispara con valor <= umbral
+};
+
+const uint8_t kColumnaInvalida = 0xff;
+
+// Evento compilado.  Tiene tamano fijo y es el mismo registro que guarda el
+// escenario binario (RelaBinario.h), asi que se puede usar directamente desde
+// un fichero mapeado.  El estado de disparo se guarda aparte.  Los 24
+// primeros bytes son el registro de las versiones 1 y 2.
+struct AppEvent {
+	uint8_t type;         // EventType
+	uint8_t column;       // 0 = A, 1 = B, 2 = C o kColumnaInvalida
+	uint8_t trigger;      // EventTrigger
+	uint8_t interval;     // IntervalKind (disparo por intervalo)
+	uint8_t direction;    // IntervalDirection (disparo por intervalo)
+	uint8_t reserved;
+	uint16_t repeats;     // disparos de un evento periodico; 0 = sin limite
+	double time;          // tiempo del reloj o umbral del intervalo
+	double amount;        // cantidad, velocidad o aceleracion
+	double duration;      // rampa y aceleracion: segundos de simulacion
+	double period;        // > 0: se repite cada 'period' del reloj
+};
+
+inline char ColumnLabel(uint8_t column)
+{
+	return (column < 3) ? (char)('A' + column) : '?';
+}
+
+enum ReloadMode {
+	kRecargaPreservar = 0,  // Los eventos ya alcanzados se dan por disparados
+	kRecargaReiniciar = 1   // Se reinicia la simulacion con el nuevo escenario
+};
+
+enum PhysicsModel {
+	kFisicaDilatacion = 0,  // Solo cambia el ritmo de cada reloj (modelo original)
+	kFisicaLorentz = 1      // Particulas con posicion y transformaciones de Lorentz
+};
+
+const int kFisicaMarcos = 3;  // uno por ventana
+
+// Contenido de config.yaml ya convertido a estructuras del programa.
+struct ScenarioConfig {
+	std::vector<AppEvent> eventos;
+	int telemetriaPuerto;
+	int telemetriaDecimacion;
+	bool recargaActiva;
+	ReloadMode recargaModo;
+	PhysicsModel fisicaModelo;
+	double fisicaMarcos[kFisicaMarcos];  // velocidad del marco de cada ventana
+
+	ScenarioConfig()
+		: telemetriaPuerto(0), telemetriaDecimacion(1),
+		  recargaActiva(false), recargaModo(kRecargaPreservar),
+		  fisicaModelo(kFisicaDilatacion), fisicaMarcos() {}
+};
+
+// Problema encontrado en un escenario.  Linea y columna empiezan en 1; 0 si
+// el problema es del fichero entero.
+struct ScenarioProblem {
+	int line;
+	int column;
+	std::string message;
+};
+
+struct ScenarioPosition {
+	int line;
+	int column;
+};
+
+// Con diagnostico el lector no se detiene en el primer error: anota todos
+// los problemas y la posicion de cada evento aceptado (en el mismo orden
+// que out.eventos).
+struct ScenarioDiagnostics {
+	std::vector<ScenarioProblem> problems;
+	std::vector<ScenarioPosition> eventPositions;
+};
+
+// Lee un escenario.  No toca estado global, se puede llamar desde cualquier hilo.
+bool LoadEventosFromYaml(const char* filePath, ScenarioConfig& out, std::string& error,
+	ScenarioDiagnostics* diagnostics = NULL);
+
+// Comprueba que los eventos se pueden aplicar tal cual (tipo, columna, numeros
+// finitos).  El lector de YAML ya omite los que no; esto es para los registros
+// binarios, que se usan sin pasar por el.
+bool ValidateEventos(const AppEvent* eventos, size_t count, std::string& error);
+bool ValidateEventos(const std::vector<AppEvent>& eventos, std::string& error);
+
+#endif // RELAEVENTOS_H_INCLUDED
@@ -0,0 +1,70 @@
+#include <math.h>
+#include "RelaFactores.h"
+#include "RelaModelo.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RELA_FACTORES_SSE2 1
+#endif
+
+void FactorsFromVelocities(const double* velocities, double* factors, double* rates, size_t count)
+{
+	size_t i = 0;
+#ifdef RELA_FACTORES_SSE2
+	const __m128d limit = _mm_set1_pd(kVelocityLimit);
+	const __m128d negLimit = _mm_set1_pd(-kVelocityLimit);
+	const __m128d one = _mm_set1_pd(1.0);
+	const __m128d minTerm = _mm_set1_pd(1.0e-6);
+	const __m128d zero = _mm_setzero_pd();
+	for (; i + 2 <= count; i += 2) {
+		__m128d v = _mm_loadu_pd(velocities + i);
+		// El orden de los operandos de min/max deja pasar los NaN como el codigo escalar.
+		v = _mm_min_pd(limit, _mm_max_pd(negLimit, v));
+		__m128d term = _mm_sub_pd(one, _mm_mul_pd(v, v));
+		term = _mm_max_pd(minTerm, term);
+		__m128d root = _mm_sqrt_pd(term);
+		__m128d inverse = _mm_div_pd(one, root);
+		__m128d negative = _mm_cmplt_pd(v, zero);
+		__m128d factor = _mm_or_pd(_mm_and_pd(negative, inverse), _mm_andnot_pd(negative, root));
+		if (factors != NULL) {
+			_mm_storeu_pd(factors + i, factor);
+		}
+		if (rates != NULL) {
+			_mm_storeu_pd(rates + i, _mm_div_pd(one, factor));
+		}
+	}
+#endif
+	for (; i < count; i++) {
+		double factor = FactorFromVelocity(velocities[i]);
+		if (factors != NULL) {
+			factors[i] = factor;
+		}
+		if (rates != NULL) {
+			rates[i] = 1 / factor;
+		}
+	}
+}
+
+void VelocitiesFromFactors(const double* factors, double* velocities, size_t count)
+{
+	size_t i = 0;
+#ifdef RELA_FACTORES_SSE2
+	const __m128d one = _mm_set1_pd(1.0);
+	const __m128d zero = _mm_setzero_pd();
+	for (; i + 2 <= count; i += 2) {
+		__m128d f = _mm_loadu_pd(factors + i);
+		__m128d inv = _mm_div_pd(one, f);
+		__m128d inv2 = _mm_mul_pd(inv, inv);
+		// f >= 1: sqrt(1 - inv2) (0 si no es positivo); f < 1: sqrt(1 + inv2).
+		__m128d slow = _mm_cmpge_pd(f, one);
+		__m128d term = _mm_or_pd(_mm_and_pd(slow, _mm_sub_pd(one, inv2)),
+			_mm_andnot_pd(slow, _mm_add_pd(one, inv2)));
+		__m128d isZero = _mm_or_pd(_mm_cmple_pd(f, zero), _mm_and_pd(slow, _mm_cmple_pd(term, zero)));
+		__m128d v = _mm_andnot_pd(isZero, _mm_sqrt_pd(term));
+		_mm_storeu_pd(velocities + i, v);
+	}
+#endif
+	for (; i < count; i++) {
+		velocities[i] = VelocityFromFactor(factors[i]);
+	}
+}
@@ -0,0 +1,20 @@
+#ifndef RELAFACTORES_H_INCLUDED
+#define RELAFACTORES_H_INCLUDED
+
+#include <stddef.h>
+
+/*
+ * Conversion por lotes entre velocidades y factores.
+ *
+ * Da exactamente lo mismo que FactorFromVelocity (RelaModelo.h) y
+ * rates[i] = 1 / factors[i], que es lo que suma cada paso; con SSE2 se
+ * procesan dos valores por instruccion.
+ */
+
+// factors o rates pueden ser NULL si no hacen falta.
+void FactorsFromVelocities(const double* velocities, double* factors, double* rates, size_t count);
+
+// Igual que VelocityFromFactor para cada elemento.
+void VelocitiesFromFactors(const double* factors, double* velocities, size_t count);
+
+#endif // RELAFACTORES_H_INCLUDED
@@ -0,0 +1,254 @@
+#include <math.h>
+#include <algorithm>
+#include "RelaIndice.h"
+#include "RelaTipos.h"
+
+static const uint32_t kSinLimite = 0xffffffffu;
+
+EventIndex::EventIndex(int windowCount)
+	: windowCount(windowCount), events(NULL),
+	  keyStart(windowCount * kIndexColumns + 1, 0),
+	  cursor(windowCount * kIndexColumns, 0),
+	  repeats(windowCount * kIndexColumns),
+	  conditionStart(windowCount * 3 * 2 + 1, 0),
+	  conditionCursor(windowCount * 3 * 2, 0)
+{
+}
+
+static bool Indexable(const AppEvent& ev)
+{
+	if (ev.column >= kIndexColumns || isnan(ev.time) || !IsKnownEventType(ev.type)) {
+		return false;
+	}
+	return ev.trigger == kDisparoReloj || (ev.trigger == kDisparoIntervalo && ev.interval < 3);
+}
+
+static bool IsPeriodic(const AppEvent& ev)
+{
+	return ev.trigger == kDisparoReloj && ev.period > 0.0 && isfinite(ev.period);
+}
+
+// Ventanas en las que se dispara: todas o solo la 0.
+static int EventWindows(const AppEvent& ev, int windowCount)
+{
+	return kEventTypes[ev.type].allWindows ? windowCount : 1;
+}
+
+static int ConditionGroup(const AppEvent& ev, int window)
+{
+	return (window * 3 + ev.interval) * 2 + (ev.direction == kSentidoBaja ? 1 : 0);
+}
+
+void EventIndex::Build(const AppEvent* eventData, size_t count)
+{
+	events = eventData;
+	const int keys = windowCount * kIndexColumns;
+	const int groups = (int)conditionCursor.size();
+	std::vector<uint32_t> sizes(keys, 0);
+	std::vector<uint32_t> groupSizes(groups, 0);
+	for (size_t e = 0; e < count; e++) {
+		const AppEvent& ev = events[e];
+		if (!Indexable(ev)) {
+			continue;
+		}
+		int windows = EventWindows(ev, windowCount);
+		for (int w = 0; w < windows; w++) {
+			if (ev.trigger == kDisparoIntervalo) {
+				groupSizes[ConditionGroup(ev, w)]++;
+			} else {
+				sizes[w * kIndexColumns + ev.column]++;
+			}
+		}
+	}
+
+	keyStart[0] = 0;
+	for (int k = 0; k < keys; k++) {
+		keyStart[k + 1] = keyStart[k] + sizes[k];
+	}
+	conditionStart[0] = 0;
+	for (int g = 0; g < groups; g++) {
+		conditionStart[g + 1] = conditionStart[g] + groupSizes[g];
+	}
+	entries.resize(keyStart[keys]);
+	conditions.resize(conditionStart[groups]);
+	std::vector<uint32_t> fill(keyStart.begin(), keyStart.end() - 1);
+	std::vector<uint32_t> groupFill(conditionStart.begin(), conditionStart.end() - 1);
+	for (size_t e = 0; e < count; e++) {
+		const AppEvent& ev = events[e];
+		if (!Indexable(ev)) {
+			continue;
+		}
+		int windows = EventWindows(ev, windowCount);
+		for (int w = 0; w < windows; w++) {
+			if (ev.trigger == kDisparoIntervalo) {
+				Condition condition = { ev.time, (uint32_t)e, w };
+				conditions[groupFill[ConditionGroup(ev, w)]++] = condition;
+			} else {
+				Entry entry = { ev.time, (uint32_t)e };
+				entries[fill[w * kIndexColumns + ev.column]++] = entry;
+			}
+		}
+	}
+
+	// Se rellenan en orden de evento, asi que un sort estable conserva ese
+	// orden entre eventos con el mismo tiempo.
+	for (int k = 0; k < keys; k++) {
+		std::stable_sort(entries.begin() + keyStart[k], entries.begin() + keyStart[k + 1],
+			[](const Entry& a, const Entry& b) { return a.time < b.time; });
+	}
+	// Los grupos impares son los de 'baja': primero el umbral mayor.
+	for (int g = 0; g < groups; g++) {
+		bool down = (g % 2) != 0;
+		std::stable_sort(conditions.begin() + conditionStart[g], conditions.begin() + conditionStart[g + 1],
+			[down](const Condition& a, const Condition& b) {
+				return down ? a.threshold > b.threshold : a.threshold < b.threshold;
+			});
+	}
+	Rewind();
+}
+
+void EventIndex::Rewind()
+{
+	for (size_t k = 0; k < cursor.size(); k++) {
+		cursor[k] = keyStart[k];
+		repeats[k].clear();
+	}
+	for (size_t g = 0; g < conditionCursor.size(); g++) {
+		conditionCursor[g] = conditionStart[g];
+	}
+}
+
+// Deja la repeticion en 'rearmed'; se pasa al monticulo de la clave al
+// terminar con ella, para que no se dispare otra vez en la misma llamada.
+void EventIndex::Rearm(uint32_t event, double time, uint32_t remaining)
+{
+	if (remaining == 0) {
+		return;
+	}
+	Repeat repeat = { time, event, remaining };
+	rearmed.push_back(repeat);
+}
+
+// Si la primera condicion pendiente del grupo se cumple.
+bool EventIndex::GroupDue(size_t group, const double* intervalValues) const
+{
+	if (conditionCursor[group] == conditionStart[group + 1]) {
+		return false;
+	}
+	const Condition& c = conditions[conditionCursor[group]];
+	double value = intervalValues[group / 2];
+	return (group % 2 != 0) ? value <= c.threshold : value >= c.threshold;
+}
+
+void EventIndex::Seek(const double* columnTimes, const double* intervalValues)
+{
+	for (size_t k = 0; k < cursor.size(); k++) {
+		std::vector<Repeat>& heap = repeats[k];
+		while (!heap.empty() && heap.front().time <= columnTimes[k]) {
+			std::pop_heap(heap.begin(), heap.end(), LaterRepeat);
+			Repeat repeat = heap.back();
+			heap.pop_back();
+			// Igual que al entrar: los disparos saltados cuentan como hechos,
+			// sin recorrerlos de uno en uno aunque el periodo sea minimo.
+			double period = events[repeat.event].period;
+			double done = floor((columnTimes[k] - repeat.time) / period) + 1.0;
+			if (repeat.remaining == kSinLimite) {
+				Rearm(repeat.event, repeat.time + done * period, kSinLimite);
+			} else if (done < (double)repeat.remaining) {
+				Rearm(repeat.event, repeat.time + done * period, repeat.remaining - (uint32_t)done);
+			}
+		}
+		uint32_t end = keyStart[k + 1];
+		uint32_t i = cursor[k];
+		while (i < end && entries[i].time <= columnTimes[k]) {
+			const AppEvent& ev = events[entries[i].event];
+			if (IsPeriodic(ev)) {
+				// Los disparos que ya habrian ocurrido cuentan como hechos.
+				double done = floor((columnTimes[k] - ev.time) / ev.period) + 1.0;
+				if (ev.repeats == 0) {
+					Rearm(entries[i].event, ev.time + done * ev.period, kSinLimite);
+				} else if (done < (double)ev.repeats) {
+					Rearm(entries[i].event, ev.time + done * ev.period, ev.repeats - (uint32_t)done);
+				}
+			}
+			i++;
+		}
+		cursor[k] = i;
+		for (size_t r = 0; r < rearmed.size(); r++) {
+			heap.push_back(rearmed[r]);
+			std::push_heap(heap.begin(), heap.end(), LaterRepeat);
+		}
+		rearmed.clear();
+	}
+	if (intervalValues != NULL) {
+		for (size_t g = 0; g < conditionCursor.size(); g++) {
+			while (GroupDue(g, intervalValues)) {
+				conditionCursor[g]++;
+			}
+		}
+	}
+}
+
+void EventIndex::Collect(const double* columnTimes, std::vector<EventoDisparado>& fired,
+	const double* intervalValues)
+{
+	size_t first = fired.size();
+	for (size_t k = 0; k < cursor.size(); k++) {
+		int window = (int)(k / kIndexColumns);
+		uint32_t end = keyStart[k + 1];
+		uint32_t i = cursor[k];
+		while (i < end && entries[i].time <= columnTimes[k]) {
+			EventoDisparado ev = { entries[i].event, window };
+			fired.push_back(ev);
+			const AppEvent& source = events[entries[i].event];
+			if (IsPeriodic(source)) {
+				Rearm(entries[i].event, source.time + source.period,
+					source.repeats == 0 ? kSinLimite : source.repeats - 1u);
+			}
+			i++;
+		}
+		cursor[k] = i;
+		std::vector<Repeat>& heap = repeats[k];
+		while (!heap.empty() && heap.front().time <= columnTimes[k]) {
+			std::pop_heap(heap.begin(), heap.end(), LaterRepeat);
+			Repeat repeat = heap.back();
+			heap.pop_back();
+			EventoDisparado ev = { repeat.event, window };
+			fired.push_back(ev);
+			Rearm(repeat.event, repeat.time + events[repeat.event].period,
+				repeat.remaining == kSinLimite ? kSinLimite : repeat.remaining - 1u);
+		}
+		for (size_t r = 0; r < rearmed.size(); r++) {
+			heap.push_back(rearmed[r]);
+			std::push_heap(heap.begin(), heap.end(), LaterRepeat);
+		}
+		rearmed.clear();
+	}
+	if (intervalValues != NULL) {
+		for (size_t g = 0; g < conditionCursor.size(); g++) {
+			while (GroupDue(g, intervalValues)) {
+				const Condition& c = conditions[conditionCursor[g]++];
+				EventoDisparado ev = { c.event, c.window };
+				fired.push_back(ev);
+			}
+		}
+	}
+	// Con varios eventos en el mismo paso el orden importa (los cambios se
+	// recortan a kVelocityLimit uno a uno).
+	if (fired.size() - first > 1) {
+		std::sort(fired.begin() + first, fired.end(),
+			[](const EventoDisparado& a, const EventoDisparado& b) {
+				return a.event != b.event ? a.event < b.event : a.window < b.window;
+			});
+	}
+}
+
+void EventIndex::FireCondition(size_t group, std::vector<EventoDisparado>& fired)
+{
+	if (conditionCursor[group] == conditionStart[group + 1]) {
+		return;
+	}
+	const Condition& c = conditions[conditionCursor[group]++];
+	EventoDisparado ev = { c.event, c.window };
+	fired.push_back(ev);
+}
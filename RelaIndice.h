@@ -0,0 +1,133 @@
+#ifndef RELAINDICE_H_INCLUDED
+#define RELAINDICE_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "RelaEventos.h"
+
+const int kIndexColumns = 3;  // A, B, C
+
+struct EventoDisparado {
+	uint32_t event;   // posicion en el escenario
+	int window;
+};
+
+/*
+ * Indice de eventos por (ventana, columna).  Cada clave guarda sus eventos
+ * ordenados por tiempo y un cursor al primero que aun no se ha disparado;
+ * como los relojes solo avanzan, cada paso mira la cabeza de cada clave y
+ * el coste no depende del numero total de eventos.
+ *
+ * Los tipos que solo actuan en la ventana 0 (pausa) solo se indexan ahi y
+ * el resto en todas.  Los eventos con tipo o columna desconocidos, o con
+ * tiempo NaN, nunca se disparan y no se indexan.
+ *
+ * Los eventos periodicos, al dispararse, vuelven a quedar pendientes un
+ * periodo despues en un monticulo por clave ordenado por la siguiente
+ * repeticion; como mucho se disparan una vez por llamada a Collect.
+ *
+ * Los eventos con disparo por intervalo se disparan una sola vez por
+ * ventana y se agrupan por (ventana, intervalo, sentido), ordenados por
+ * umbral en el sentido en que se cruzan: con 'sube' el intervalo pasa
+ * antes por los umbrales menores.  Cada grupo tiene un cursor a su
+ * siguiente umbral, asi que Collect solo mira una condicion por grupo mas
+ * las que se disparan.
+ *
+ * columnTimes[w * kIndexColumns + c] es el reloj de la columna c (0 = A)
+ * en la ventana w, e intervalValues[w * 3 + k] el intervalo k (IntervalKind)
+ * de la ventana w.  Sin intervalValues no se comprueban las condiciones.
+ */
+class EventIndex {
+public:
+	explicit EventIndex(int windowCount);
+
+	// Los eventos se usan por referencia; tienen que seguir vivos.
+	void Build(const AppEvent* events, size_t count);
+
+	// Vuelve a dejar todos los eventos pendientes.
+	void Rewind();
+
+	// Da por disparado todo lo que ya se ha alcanzado, sin devolverlo.
+	void Seek(const double* columnTimes, const double* intervalValues = NULL);
+
+	// Anade a fired los eventos alcanzados desde la ultima llamada, en el
+	// mismo orden que el recorrido completo (por evento y luego por ventana).
+	void Collect(const double* columnTimes, std::vector<EventoDisparado>& fired,
+		const double* intervalValues = NULL);
+
+	// Tiempo del primer evento pendiente de la clave (w * kIndexColumns + c).
+	// Sin eventos pendientes devuelve false y time queda a 0.
+	bool Peek(int key, double& time) const
+	{
+		bool found = cursor[key] < keyStart[key + 1];
+		double first = found ? entries[cursor[key]].time : 0.0;
+		const std::vector<Repeat>& heap = repeats[key];
+		if (!heap.empty() && (!found || heap.front().time < first)) {
+			first = heap.front().time;
+			found = true;
+		}
+		time = first;
+		return found;
+	}
+
+	int KeyCount() const { return (int)cursor.size(); }
+	size_t Size() const { return entries.size(); }
+
+	// Condiciones por intervalo, una por evento y ventana.
+	size_t ConditionCount() const { return conditions.size(); }
+	// Grupos de condiciones; de cada uno solo la primera pendiente puede
+	// cumplirse antes que las demas.
+	size_t ConditionGroupCount() const { return conditionCursor.size(); }
+	// Primera condicion pendiente del grupo; false si no queda ninguna.
+	bool PeekCondition(size_t group, uint32_t& event, int& window) const
+	{
+		if (conditionCursor[group] == conditionStart[group + 1]) {
+			return false;
+		}
+		const Condition& c = conditions[conditionCursor[group]];
+		event = c.event;
+		window = c.window;
+		return true;
+	}
+	// Dispara esa condicion aunque el intervalo no llegue al umbral (para
+	// quien ha calculado el cruce y no quiere depender del redondeo).
+	void FireCondition(size_t group, std::vector<EventoDisparado>& fired);
+
+private:
+	struct Entry {
+		double time;
+		uint32_t event;
+	};
+
+	struct Repeat {
+		double time;
+		uint32_t event;
+		uint32_t remaining;   // disparos que quedan (kSinLimite en los ilimitados)
+	};
+
+	struct Condition {
+		double threshold;
+		uint32_t event;
+		int window;
+	};
+
+	// Orden de los monticulos de repeticiones: la mas proxima arriba.
+	static bool LaterRepeat(const Repeat& a, const Repeat& b) { return a.time > b.time; }
+
+	void Rearm(uint32_t event, double time, uint32_t remaining);
+	bool GroupDue(size_t group, const double* intervalValues) const;
+
+	int windowCount;
+	const AppEvent* events;
+	std::vector<Entry> entries;       // todas las claves seguidas
+	std::vector<uint32_t> keyStart;   // windowCount * kIndexColumns + 1
+	std::vector<uint32_t> cursor;     // windowCount * kIndexColumns
+	std::vector<std::vector<Repeat> > repeats;  // por clave, monticulo por tiempo
+	std::vector<Repeat> rearmed;      // repeticiones de la clave en curso
+	std::vector<Condition> conditions;       // todos los grupos seguidos
+	std::vector<uint32_t> conditionStart;    // windowCount * 3 * 2 + 1
+	std::vector<uint32_t> conditionCursor;   // windowCount * 3 * 2
+};
+
+#endif // RELAINDICE_H_INCLUDED
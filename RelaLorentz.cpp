@@ -0,0 +1,211 @@
+#include <math.h>
+#include "RelaLorentz.h"
+
+LorentzSystem::LorentzSystem()
+	: t(0.0), speedLimit(1.0)
+{
+}
+
+void LorentzSystem::Reset(size_t count, const double* x0)
+{
+	t = 0.0;
+	segT.assign(count, 0.0);
+	segX.assign(count, 0.0);
+	segTau.assign(count, 0.0);
+	v.assign(count, 0.0);
+	invGamma.assign(count, 1.0);
+	accel.assign(count, 0.0);
+	segEnd.assign(count, INFINITY);
+	requestedAccel.assign(count, 0.0);
+	accelEnd.assign(count, -INFINITY);
+	history.assign(count, std::vector<WorldSegment>());
+	for (size_t i = 0; i < count; i++) {
+		if (x0 != NULL) {
+			segX[i] = x0[i];
+		}
+		WorldSegment first = { 0.0, segX[i], 0.0, 0.0, 0.0 };
+		history[i].push_back(first);
+	}
+}
+
+double LorentzSystem::ClampSpeed(double velocity) const
+{
+	if (velocity > speedLimit) {
+		return speedLimit;
+	}
+	if (velocity < -speedLimit) {
+		return -speedLimit;
+	}
+	return velocity;
+}
+
+// Empieza un tramo nuevo en start (dentro del tramo actual).
+void LorentzSystem::OpenSegment(size_t i, double start, double velocity, double a)
+{
+	double end = INFINITY;
+	if (a != 0.0) {
+		end = accelEnd[i];
+		if (speedLimit < 1.0) {
+			double target = (a > 0.0 ? 1.0 : -1.0) * CelerityFromVelocity(speedLimit);
+			double reach = start + (target - CelerityFromVelocity(velocity)) / a;
+			if (reach < end) {
+				end = reach;
+			}
+		}
+		// Ya en el limite (o sin duracion): tramo recto.
+		if (!(end > start)) {
+			a = 0.0;
+			end = INFINITY;
+		}
+	}
+
+	WorldSegment next;
+	double previousVelocity;
+	WorldlinePoint(history[i].back(), start, next.x, next.tau, previousVelocity);
+	next.t = start;
+	next.v = velocity;
+	next.a = a;
+	// Dos cambios en el mismo instante solo dejan el ultimo tramo.
+	if (history[i].back().t == start) {
+		history[i].back() = next;
+	} else {
+		history[i].push_back(next);
+	}
+	segT[i] = next.t;
+	segX[i] = next.x;
+	segTau[i] = next.tau;
+	v[i] = velocity;
+	invGamma[i] = sqrt(1.0 - velocity * velocity);
+	accel[i] = a;
+	segEnd[i] = end;
+}
+
+void LorentzSystem::SetVelocity(size_t i, double velocity)
+{
+	double a = (t < accelEnd[i]) ? requestedAccel[i] : 0.0;
+	OpenSegment(i, t, velocity, a);
+}
+
+double LorentzSystem::Velocity(size_t i) const
+{
+	if (accel[i] == 0.0) {
+		return v[i];
+	}
+	double x, tau, velocity;
+	WorldlinePoint(history[i].back(), t, x, tau, velocity);
+	return velocity;
+}
+
+void LorentzSystem::Accelerate(size_t i, double a, double duration)
+{
+	requestedAccel[i] = a;
+	accelEnd[i] = t + duration;
+	OpenSegment(i, t, Velocity(i), a);
+}
+
+void LorentzSystem::Advance(double dt)
+{
+	t += dt;
+	const size_t n = v.size();
+	for (size_t i = 0; i < n; i++) {
+		if (segEnd[i] <= t) {
+			double x, tau, velocity;
+			WorldlinePoint(history[i].back(), segEnd[i], x, tau, velocity);
+			OpenSegment(i, segEnd[i], ClampSpeed(velocity), 0.0);
+		}
+	}
+}
+
+// Suceso del tramo que contiene s = t - frame * x (la coordenada de
+// simultaneidad del marco, escalada por 1 / gamma).  s crece a lo largo de
+// toda linea de universo porque |v| < 1, asi que el tramo es unico.
+void LorentzSystem::SegmentPoint(size_t i, double frame, double s, double& tauOut, double& tOut, double& xOut,
+	double& vOut) const
+{
+	const std::vector<WorldSegment>& segs = history[i];
+	size_t lo = 0;
+	size_t hi = segs.size();
+	while (hi - lo > 1) {
+		size_t mid = (lo + hi) / 2;
+		if (segs[mid].t - frame * segs[mid].x <= s) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	WorldSegment seg = segs[lo];
+	if (seg.a != 0.0 && lo + 1 == segs.size() && segEnd[i] < INFINITY) {
+		// Despues de la aceleracion en curso se extrapola en linea recta.
+		WorldSegment after;
+		WorldlinePoint(seg, segEnd[i], after.x, after.tau, after.v);
+		after.t = segEnd[i];
+		after.v = ClampSpeed(after.v);
+		after.a = 0.0;
+		if (after.t - frame * after.x <= s) {
+			seg = after;
+		}
+	}
+	double te;
+	if (seg.a == 0.0) {
+		te = (s + frame * (seg.x - seg.v * seg.t)) / (1.0 - frame * seg.v);
+	} else {
+		// Con u = sinh(eta) y frame = tanh(beta) la condicion de
+		// simultaneidad queda sinh(eta - beta) = K * cosh(beta).
+		double u0 = CelerityFromVelocity(seg.v);
+		double k = seg.a * (s - seg.t + frame * seg.x) + u0 - frame * sqrt(1.0 + u0 * u0);
+		double beta = atanh(frame);
+		double u = sinh(beta + asinh(k / sqrt(1.0 - frame * frame)));
+		te = seg.t + (u - u0) / seg.a;
+	}
+	tOut = te;
+	WorldlinePoint(seg, te, xOut, tauOut, vOut);
+}
+
+void LorentzSystem::View(double frame, double frameTime, double* tau, double* x, double* velocity) const
+{
+	const size_t n = v.size();
+	const double gamma = 1.0 / sqrt(1.0 - frame * frame);
+	// El suceso cumple gamma * (t - frame * x) = frameTime.
+	const double s = frameTime / gamma;
+	const double* st = segT.data();
+	const double* sx = segX.data();
+	const double* stau = segTau.data();
+	const double* sv = v.data();
+	const double* sg = invGamma.data();
+	const double* sa = accel.data();
+
+	// Todas con el tramo actual; sin saltos para que el compilador vectorice.
+	for (size_t i = 0; i < n; i++) {
+		double te = (s + frame * (sx[i] - sv[i] * st[i])) / (1.0 - frame * sv[i]);
+		double dt = te - st[i];
+		if (tau != NULL) {
+			tau[i] = stau[i] + sg[i] * dt;
+		}
+		if (x != NULL) {
+			double xe = sx[i] + sv[i] * dt;
+			x[i] = gamma * (xe - frame * te);
+		}
+		if (velocity != NULL) {
+			velocity[i] = (sv[i] - frame) / (1.0 - sv[i] * frame);
+		}
+	}
+
+	// Las que caen antes del tramo actual, o estan acelerando, se corrigen
+	// con el historial.
+	for (size_t i = 0; i < n; i++) {
+		if (st[i] - frame * sx[i] <= s && sa[i] == 0.0) {
+			continue;
+		}
+		double tauE, tE, xE, vE;
+		SegmentPoint(i, frame, s, tauE, tE, xE, vE);
+		if (tau != NULL) {
+			tau[i] = tauE;
+		}
+		if (x != NULL) {
+			x[i] = gamma * (xE - frame * tE);
+		}
+		if (velocity != NULL) {
+			velocity[i] = RelativeVelocity(vE, frame);
+		}
+	}
+}
@@ -0,0 +1,154 @@
+#ifndef RELALORENTZ_H_INCLUDED
+#define RELALORENTZ_H_INCLUDED
+
+#include <math.h>
+#include <stddef.h>
+#include <vector>
+
+// Velocidades en unidades de c.
+
+// Suma relativista: velocidad b medida en un marco que se mueve a a.
+inline double ComposeVelocity(double a, double b)
+{
+	return (a + b) / (1.0 + a * b);
+}
+
+// Velocidad v (de laboratorio) vista desde un marco que se mueve a frame.
+inline double RelativeVelocity(double v, double frame)
+{
+	return (v - frame) / (1.0 - v * frame);
+}
+
+// Celeridad u = gamma * v.  Con aceleracion propia constante a, u crece
+// linealmente con el tiempo de laboratorio (movimiento hiperbolico).
+inline double CelerityFromVelocity(double v)
+{
+	return v / sqrt(1.0 - v * v);
+}
+
+inline double VelocityFromCelerity(double u)
+{
+	return u / sqrt(1.0 + u * u);
+}
+
+// asinh(u1) - asinh(u0) sin perder precision cuando u1 - u0 es pequeno.
+inline double AsinhDiff(double u0, double u1)
+{
+	if (u0 * u1 <= 0.0) {
+		return asinh(u1) - asinh(u0);
+	}
+	double g0 = sqrt(1.0 + u0 * u0);
+	double g1 = sqrt(1.0 + u1 * u1);
+	return asinh((u1 - u0) * (u1 + u0) / (u1 * g0 + u0 * g1));
+}
+
+// Inicio de un tramo de una linea de universo, en coordenadas de
+// laboratorio.  tau es el tiempo propio en ese suceso; con a != 0 el tramo
+// es un movimiento hiperbolico con aceleracion propia a (en c por segundo).
+struct WorldSegment {
+	double t;
+	double x;
+	double tau;
+	double v;
+	double a;
+};
+
+// Posicion, tiempo propio y velocidad en el instante t del tramo, con las
+// formulas exactas (no hay error de integracion).
+inline void WorldlinePoint(const WorldSegment& seg, double t, double& x, double& tau, double& v)
+{
+	double dt = t - seg.t;
+	if (seg.a == 0.0) {
+		x = seg.x + seg.v * dt;
+		tau = seg.tau + sqrt(1.0 - seg.v * seg.v) * dt;
+		v = seg.v;
+		return;
+	}
+	double u0 = CelerityFromVelocity(seg.v);
+	double u1 = u0 + seg.a * dt;
+	double g0 = sqrt(1.0 + u0 * u0);
+	double g1 = sqrt(1.0 + u1 * u1);
+	// (g1 - g0) / a escrito sin restas de numeros parecidos.
+	x = seg.x + dt * (u0 + u1) / (g0 + g1);
+	tau = seg.tau + AsinhDiff(u0, u1) / seg.a;
+	v = u1 / g1;
+}
+
+/*
+ * Particulas en 1D con posicion y velocidad con signo.  Cada linea de
+ * universo se guarda como tramos rectos en el marco de laboratorio, asi
+ * que avanzar el tiempo no toca las particulas y cualquier marco inercial
+ * se obtiene con la transformacion de Lorentz.
+ *
+ * View() responde, para todas las particulas a la vez, que marca su reloj
+ * en el suceso de su linea de universo simultaneo (en el marco dado) con un
+ * tiempo coordenado de ese marco: ahi aparece el desfase de simultaneidad.
+ * Si ese suceso queda en el futuro del laboratorio se extrapola con el
+ * movimiento actual.  Los datos del tramo actual van en arrays separados
+ * para que el bucle principal se vectorice; solo se busca en el historial
+ * cuando el suceso cae en un tramo anterior o la particula esta acelerando.
+ *
+ * Las aceleraciones son tramos hiperbolicos resueltos de forma cerrada en
+ * cualquier marco, asi que el resultado no depende del paso de Advance().
+ * Terminan al cumplirse la duracion o al llegar al limite de velocidad.
+ */
+class LorentzSystem {
+public:
+	LorentzSystem();
+
+	// count particulas en reposo; x0 puede ser NULL (todas en el origen).
+	void Reset(size_t count, const double* x0 = NULL);
+
+	size_t Count() const { return v.size(); }
+	double Time() const { return t; }
+
+	// |v| maximo al que llegan las aceleraciones (por defecto, sin limite).
+	void SetSpeedLimit(double limit) { speedLimit = limit; }
+
+	// Avanza el tiempo; las aceleraciones que terminan antes de t + dt se
+	// cierran en su instante exacto.
+	void Advance(double dt);
+
+	// Cambia la velocidad de laboratorio a partir del instante actual.  Si
+	// la particula esta acelerando, sigue acelerando desde esa velocidad.
+	void SetVelocity(size_t i, double velocity);
+	// Velocidad de laboratorio en el instante actual.
+	double Velocity(size_t i) const;
+
+	// Aceleracion propia a durante duration segundos de laboratorio, desde
+	// el instante actual.  a = 0 la termina.
+	void Accelerate(size_t i, double a, double duration);
+	bool Accelerating(size_t i) const { return accel[i] != 0.0; }
+
+	// Tiempo propio, posicion y velocidad de cada particula vistos desde un
+	// marco con velocidad frame en su instante frameTime.  Cualquiera de los
+	// arrays de salida puede ser NULL.
+	void View(double frame, double frameTime, double* tau, double* x, double* velocity) const;
+
+	// Tramos de la linea de universo, el ultimo abierto hasta ahora.
+	const std::vector<WorldSegment>& Segments(size_t i) const { return history[i]; }
+
+private:
+	void SegmentPoint(size_t i, double frame, double s, double& tauOut, double& tOut, double& xOut,
+		double& vOut) const;
+	void OpenSegment(size_t i, double start, double velocity, double a);
+	double ClampSpeed(double velocity) const;
+
+	double t;
+	double speedLimit;
+	// Tramo actual de cada particula.
+	std::vector<double> segT;
+	std::vector<double> segX;
+	std::vector<double> segTau;
+	std::vector<double> v;          // al principio del tramo
+	std::vector<double> invGamma;   // sqrt(1 - v^2), ritmo del reloj propio
+	std::vector<double> accel;      // 0 en los tramos rectos
+	std::vector<double> segEnd;     // fin del tramo hiperbolico (INFINITY en los rectos)
+	// Aceleracion pedida con Accelerate() y hasta cuando; sigue vigente
+	// aunque el tramo actual sea recto por haber llegado al limite.
+	std::vector<double> requestedAccel;
+	std::vector<double> accelEnd;
+	std::vector<std::vector<WorldSegment> > history;
+};
+
+#endif // RELALORENTZ_H_INCLUDED
@@ -0,0 +1,104 @@
+#ifndef RELAMODELO_H_INCLUDED
+#define RELAMODELO_H_INCLUDED
+
+#include <math.h>
+#include <cctype>
+
+// Geometria y fisica de la simulacion, compartidas por el programa y las
+// herramientas que analizan escenarios sin abrir ventanas.
+
+const int kWindowCount = 3;
+const int kColumnsPerWindow = 3;
+const int kTotalColumns = kWindowCount * kColumnsPerWindow;
+const double kVelocityLimit = 0.99;
+
+// Avance de reloj por paso de simulacion (se divide por el factor de cada columna).
+const double kStepTime = 1.0 / 100.0;
+
+inline double FactorFromVelocity(double v)
+{
+	if (v < -kVelocityLimit) {
+		v = -kVelocityLimit;
+	} else if (v > kVelocityLimit) {
+		v = kVelocityLimit;
+	}
+	double term = 1.0 - (v * v);
+	if (term < 1.0e-6) {
+		term = 1.0e-6;
+	}
+	if (v < 0.0) {
+		return 1.0 / sqrt(term);
+	}
+	return sqrt(term);
+}
+
+inline double VelocityFromFactor(double factor)
+{
+	if (factor <= 0.0) {
+		return 0.0;
+	}
+	double inv = 1.0 / factor;
+	double inv2 = inv * inv;
+	if (factor >= 1.0) {
+		double term = 1.0 - inv2;
+		if (term <= 0.0) {
+			return 0.0;
+		}
+		return sqrt(term);
+	}
+	return sqrt(1.0 + inv2);
+}
+
+inline char GetLabelForWindowColumn(int windowIndex, int columnIndex)
+{
+	static const char labels[kWindowCount][kColumnsPerWindow] = {
+		{ 'B', 'A', 'C' },
+		{ 'A', 'B', 'C' },
+		{ 'A', 'C', 'B' }
+	};
+	return labels[windowIndex][columnIndex];
+}
+
+inline int GetIndexForLabelInWindow(int windowIndex, char label)
+{
+	char target = (char)toupper((unsigned char)label);
+	if (windowIndex < 0 || windowIndex >= kWindowCount) {
+		return -1;
+	}
+	for (int c = 0; c < kColumnsPerWindow; c++) {
+		if (GetLabelForWindowColumn(windowIndex, c) == target) {
+			return windowIndex * kColumnsPerWindow + c;
+		}
+	}
+	return -1;
+}
+
+// Intervalos de cada ventana: dtBA, dtAC y dtBC (en el orden de IntervalKind),
+// la diferencia entre los relojes de las dos etiquetas.
+const int kIntervalCount = 3;
+const char kIntervalLabels[kIntervalCount][2] = { { 'B', 'A' }, { 'A', 'C' }, { 'B', 'C' } };
+
+// values[w * kIntervalCount + k] a partir de los relojes en el orden de Times.
+inline void GetIntervalValues(const double* times, double* values)
+{
+	for (int w = 0; w < kWindowCount; w++) {
+		for (int k = 0; k < kIntervalCount; k++) {
+			values[w * kIntervalCount + k] = times[GetIndexForLabelInWindow(w, kIntervalLabels[k][0])] -
+				times[GetIndexForLabelInWindow(w, kIntervalLabels[k][1])];
+		}
+	}
+}
+
+// Velocidad tras aplicar un cambio, recortada a kVelocityLimit como en la simulacion.
+inline double ClampVelocity(double v)
+{
+	if (v < -kVelocityLimit) {
+		return -kVelocityLimit;
+	}
+	if (v > kVelocityLimit) {
+		return kVelocityLimit;
+	}
+	return v;
+}
+
+#endif // RELAMODELO_H_INCLUDED
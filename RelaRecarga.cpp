@@ -0,0 +1,157 @@
+#include <string.h>
+#include "RelaRecarga.h"
+#include "RelaBinario.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+static const int kPollIntervalMs = 500;
+static const int kWaitSliceMs = 100;
+static const int kSettleMs = 100;
+
+ConfigWatcher::ConfigWatcher()
+	: thread(NULL), pending(NULL), inotifyFd(-1), lastModified(0), lastSize(0)
+{
+	SDL_SetAtomicInt(&stopRequested, 0);
+}
+
+ConfigWatcher::~ConfigWatcher()
+{
+	Stop();
+}
+
+bool ConfigWatcher::Start(const std::string& filePath)
+{
+	if (thread != NULL) {
+		return true;
+	}
+	path = filePath;
+	SDL_PathInfo info;
+	if (SDL_GetPathInfo(path.c_str(), &info)) {
+		lastModified = info.modify_time;
+		lastSize = info.size;
+	}
+
+#ifdef __linux__
+	inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyFd >= 0) {
+		size_t slash = path.find_last_of("/\\");
+		std::string dir = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+		if (inotify_add_watch(inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+			close(inotifyFd);
+			inotifyFd = -1;
+		}
+	}
+#endif
+
+	SDL_SetAtomicInt(&stopRequested, 0);
+	thread = SDL_CreateThread(ThreadMain, "recarga", this);
+	if (thread == NULL) {
+		SDL_Log("Recarga: fallo al crear el hilo: %s", SDL_GetError());
+		return false;
+	}
+	return true;
+}
+
+void ConfigWatcher::Stop()
+{
+	if (thread != NULL) {
+		SDL_SetAtomicInt(&stopRequested, 1);
+		SDL_WaitThread(thread, NULL);
+		thread = NULL;
+	}
+#ifdef __linux__
+	if (inotifyFd >= 0) {
+		close(inotifyFd);
+		inotifyFd = -1;
+	}
+#endif
+	delete TakePending();
+}
+
+ScenarioConfig* ConfigWatcher::TakePending()
+{
+	return (ScenarioConfig*)SDL_SetAtomicPointer(&pending, NULL);
+}
+
+int SDLCALL ConfigWatcher::ThreadMain(void* data)
+{
+	static_cast<ConfigWatcher*>(data)->Run();
+	return 0;
+}
+
+// Espera a que cambie el fichero.  Devuelve false si se pide parar.
+bool ConfigWatcher::WaitForChange()
+{
+	std::string name = path.substr(path.find_last_of("/\\") + 1);
+	int waitedMs = 0;
+	while (SDL_GetAtomicInt(&stopRequested) == 0) {
+#ifdef __linux__
+		if (inotifyFd >= 0) {
+			pollfd pfd;
+			pfd.fd = inotifyFd;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+			if (poll(&pfd, 1, kWaitSliceMs) <= 0) {
+				continue;
+			}
+			bool changed = false;
+			alignas(inotify_event) char buffer[4096];
+			ssize_t len;
+			while ((len = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+				for (char* p = buffer; p < buffer + len; ) {
+					const inotify_event* ev = (const inotify_event*)p;
+					if (ev->len > 0 && name == ev->name) {
+						changed = true;
+					}
+					p += sizeof(inotify_event) + ev->len;
+				}
+			}
+			if (changed) {
+				return true;
+			}
+			continue;
+		}
+#endif
+		SDL_Delay(kWaitSliceMs);
+		waitedMs += kWaitSliceMs;
+		if (waitedMs < kPollIntervalMs) {
+			continue;
+		}
+		waitedMs = 0;
+		SDL_PathInfo info;
+		if (SDL_GetPathInfo(path.c_str(), &info) &&
+			(info.modify_time != lastModified || info.size != lastSize)) {
+			lastModified = info.modify_time;
+			lastSize = info.size;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ConfigWatcher::Reload()
+{
+	ScenarioConfig* config = new ScenarioConfig();
+	std::string error;
+	if (!LoadScenarioFile(path.c_str(), *config, error) || !ValidateEventos(config->eventos, error)) {
+		SDL_Log("Recarga: %s rechazado: %s", path.c_str(), error.c_str());
+		delete config;
+		return;
+	}
+	SDL_Log("Recarga: %s leido, %u eventos", path.c_str(), (unsigned)config->eventos.size());
+	// Si el anterior no se llego a recoger, se descarta.
+	delete (ScenarioConfig*)SDL_SetAtomicPointer(&pending, config);
+}
+
+void ConfigWatcher::Run()
+{
+	while (WaitForChange()) {
+		// Dejar que el editor termine de escribir antes de leer.
+		SDL_Delay(kSettleMs);
+		Reload();
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef RELARECARGA_H_INCLUDED
+#define RELARECARGA_H_INCLUDED
+
+#include <string>
+#include "SDL.h"
+#include "RelaEventos.h"
+
+/*
+ * Vigila el escenario (YAML o binario) y, cuando cambia, lo lee y valida en un hilo propio.
+ * El escenario nuevo se deja en un puntero atomico; el hilo de simulacion
+ * lo recoge con TakePending() en el limite de un paso, sin bloquearse nunca.
+ *
+ * En Linux se usa inotify sobre el directorio del fichero (los editores
+ * suelen guardar con rename); en el resto, o si inotify falla, se consulta
+ * la fecha de modificacion periodicamente.
+ */
+class ConfigWatcher {
+public:
+	ConfigWatcher();
+	~ConfigWatcher();
+
+	bool Start(const std::string& filePath);
+	void Stop();
+
+	// Devuelve el ultimo escenario valido leido (el llamante lo libera) o NULL.
+	ScenarioConfig* TakePending();
+
+private:
+	ConfigWatcher(const ConfigWatcher&);
+	void operator=(const ConfigWatcher&);
+
+	static int SDLCALL ThreadMain(void* data);
+	void Run();
+	bool WaitForChange();
+	void Reload();
+
+	std::string path;
+	SDL_Thread* thread;
+	SDL_AtomicInt stopRequested;
+	void* pending;  // ScenarioConfig*, intercambiado con SDL_SetAtomicPointer
+	int inotifyFd;
+	SDL_Time lastModified;
+	Uint64 lastSize;
+};
+
+#endif // RELARECARGA_H_INCLUDED
@@ -16,16 +16,21 @@
 #include "SDL_thread.h"
 #include "RelaUtiles.h"
 #include "PracticalSocket.h"
+#include "RelaTelemetria.h"
+#include "RelaEventos.h"
+#include "RelaRecarga.h"
+#include "RelaBinario.h"
+#include "RelaIndice.h"
+#include "RelaModelo.h"
+#include "RelaFactores.h"
+#include "RelaLorentz.h"
+#include "RelaAceleracion.h"
+#include "RelaTipos.h"
 #include <SDL3/SDL_main.h>
 #include <yaml-cpp/yaml.h>
 
 
 
-const int kWindowCount = 3;
-const int kColumnsPerWindow = 3;
-const int kTotalColumns = kWindowCount * kColumnsPerWindow;
-const double kVelocityLimit = 0.99;
-
 int PanWidth = 1024;
 int PanHeight = 1024;
 SDL_Surface *screen;
@@ -43,21 +48,33 @@ SDL_WindowID windowIds[kWindowCount] = {};
 
 double Times[1024];
 double Factors[1024];
+double Rates[kTotalColumns];  // 1 / Factors[i], lo que avanza cada reloj por paso
 double Velocidades[kTotalColumns];
+Intervalo Intervalos[kWindowCount];
+unsigned long long StepCount = 0;
 bool Pause = true;
 bool NextStep = false;
 int SelectedGauge[kWindowCount] = { 0, 0, 0 };
 
-struct AppEvent {
-	std::string type;
-	char column;
-	double time;
-	double amount;
-	bool triggered;
-	int triggeredMask;
-};
-
+// Los eventos vienen de config.yaml (vector) o de un escenario binario
+// mapeado; la simulacion solo ve eventData/eventCount.
 std::vector<AppEvent> eventos;
+MappedScenario escenarioMapeado;
+const AppEvent* eventData = NULL;
+size_t eventCount = 0;
+EventIndex eventIndex(kWindowCount);
+std::vector<EventoDisparado> disparados;
+std::string configPath;
+ConfigWatcher recarga;
+
+TelemetryPublisher telemetria(kWindowCount);
+int TelemetriaPuerto = 0;
+int TelemetriaDecimacion = 1;
+bool RecargaActiva = false;
+
+PhysicsModel Fisica = kFisicaDilatacion;
+double FisicaMarcos[kWindowCount] = {};
+LorentzSystem particulas;  // A, B, C en el modelo lorentz
 
 /*
 double Lorentz(double v)
@@ -69,172 +86,91 @@ double Lorentz(double v)
 }
 */
 
-static double FactorFromVelocity(double v)
+static void ResetEventos()
 {
-	if (v < -kVelocityLimit) {
-		v = -kVelocityLimit;
-	} else if (v > kVelocityLimit) {
-		v = kVelocityLimit;
-	}
-	double term = 1.0 - (v * v);
-	if (term < 1.0e-6) {
-		term = 1.0e-6;
-	}
-	if (v < 0.0) {
-		return 1.0 / sqrt(term);
-	}
-	return sqrt(term);
+	eventIndex.Rewind();
 }
 
-static double VelocityFromFactor(double factor)
+// Reloj de cada columna A, B, C por ventana, en el orden que usa EventIndex.
+static void GetColumnTimes(double* columnTimes)
 {
-	if (factor <= 0.0) {
-		return 0.0;
-	}
-	double inv = 1.0 / factor;
-	double inv2 = inv * inv;
-	if (factor >= 1.0) {
-		double term = 1.0 - inv2;
-		if (term <= 0.0) {
-			return 0.0;
+	for (int w = 0; w < kWindowCount; w++) {
+		for (int c = 0; c < kIndexColumns; c++) {
+			columnTimes[w * kIndexColumns + c] = Times[GetIndexForLabelInWindow(w, (char)('A' + c))];
 		}
-		return sqrt(term);
 	}
-	return sqrt(1.0 + inv2);
 }
 
-static char GetLabelForWindowColumn(int windowIndex, int columnIndex)
-{
-	static const char labels[kWindowCount][kColumnsPerWindow] = {
-		{ 'B', 'A', 'C' },
-		{ 'A', 'B', 'C' },
-		{ 'A', 'C', 'B' }
-	};
-	return labels[windowIndex][columnIndex];
-}
+static void LoadEventos();
+static bool LoadEventosFromPath(const std::string& path);
 
-static int GetIndexForLabelInWindow(int windowIndex, char label)
+static void SetColumnVelocity(int index, double velocity)
 {
-	char target = (char)toupper((unsigned char)label);
-	if (windowIndex < 0 || windowIndex >= kWindowCount) {
-		return -1;
-	}
-	for (int c = 0; c < kColumnsPerWindow; c++) {
-		if (GetLabelForWindowColumn(windowIndex, c) == target) {
-			return windowIndex * kColumnsPerWindow + c;
-		}
-	}
-	return -1;
+	Velocidades[index] = ClampVelocity(velocity);
+	FactorsFromVelocities(&Velocidades[index], &Factors[index], &Rates[index], 1);
 }
 
-static bool LoadEventosFromYaml(const char* filePath)
+static void ApplyVelocityDelta(int index, double delta)
 {
-	try {
-		YAML::Node config = YAML::LoadFile(filePath);
-		if (!config["eventos"] || !config["eventos"].IsSequence()) {
-			return false;
-		}
-		eventos.clear();
-		for (const auto& node : config["eventos"]) {
-			if (!node.IsMap()) {
-				continue;
-			}
-			const YAML::Node tipoNode = node["tipo"];
-			const YAML::Node columnaNode = node["columna"];
-			const YAML::Node tiempoNode = node["tiempo"];
-			if (!tipoNode.IsDefined() || !columnaNode.IsDefined() || !tiempoNode.IsDefined()) {
-				continue;
-			}
-			std::string type = tipoNode.as<std::string>();
-			std::string col = columnaNode.as<std::string>();
-			if (col.empty()) {
-				continue;
-			}
-			char column = col[0];
-			double time = tiempoNode.as<double>();
-			double amount = 0.0;
-			if (type == "cambio") {
-				const YAML::Node cantidadNode = node["cantidad"];
-				if (!cantidadNode.IsDefined()) {
-					continue;
-				}
-				amount = cantidadNode.as<double>();
-			}
-			AppEvent ev { type, column, time, amount, false, 0 };
-			eventos.push_back(ev);
-		}
-		return !eventos.empty();
-	} catch (const std::exception& ex) {
-		SDL_Log("Fallo al cargar config.yaml: %s", ex.what());
-	}
-	return false;
+	SetColumnVelocity(index, Velocidades[index] + delta);
 }
 
-static void ResetEventos()
+static void ApplyDeltaToLabelInWindow(int windowIndex, char column, double delta)
 {
-	for (auto& ev : eventos) {
-		ev.triggered = false;
-		ev.triggeredMask = 0;
+	if (windowIndex < 0 || windowIndex >= kWindowCount) {
+		return;
 	}
-}
-
-static bool ColumnReached(char column, double time)
-{
 	char target = (char)toupper((unsigned char)column);
-	int w = 0;
 	for (int c = 0; c < kColumnsPerWindow; c++) {
-		if (GetLabelForWindowColumn(w, c) == target) {
-			int idx = w * kColumnsPerWindow + c;
-			if (Times[idx] >= time) {
-				return true;
-			}
+		if (GetLabelForWindowColumn(windowIndex, c) == target) {
+			int idx = windowIndex * kColumnsPerWindow + c;
+			ApplyVelocityDelta(idx, delta);
+			break;
 		}
 	}
-	return false;
 }
 
-static bool ColumnReachedInWindow(int windowIndex, char column, double time)
+// Modelo lorentz: rellena Times/Velocidades/Factors de cada ventana con lo
+// que se ve desde su marco en su instante actual.
+static void UpdateLorentzView()
 {
-	if (windowIndex < 0 || windowIndex >= kWindowCount) {
-		return false;
-	}
-	char target = (char)toupper((unsigned char)column);
-	for (int c = 0; c < kColumnsPerWindow; c++) {
-		if (GetLabelForWindowColumn(windowIndex, c) == target) {
-			int idx = windowIndex * kColumnsPerWindow + c;
-			return Times[idx] >= time;
+	double tau[kIndexColumns];
+	double velocity[kIndexColumns];
+	for (int w = 0; w < kWindowCount; w++) {
+		particulas.View(FisicaMarcos[w], particulas.Time(), tau, NULL, velocity);
+		for (int c = 0; c < kIndexColumns; c++) {
+			int idx = GetIndexForLabelInWindow(w, (char)('A' + c));
+			Times[idx] = tau[c];
+			Velocidades[idx] = velocity[c];
+			Rates[idx] = sqrt(1.0 - velocity[c] * velocity[c]);
+			Factors[idx] = 1.0 / Rates[idx];
 		}
 	}
-	return false;
 }
 
-static void LoadEventos();
-
-static void ApplyVelocityDelta(int index, double delta)
+// Modelo lorentz: velocity se mide en el marco de la ventana.  Las demas
+// ventanas lo ven a traves de la transformacion, sin cambiar el signo a mano.
+static void SetLorentzVelocity(int windowIndex, char label, double velocity)
 {
-	Velocidades[index] += delta;
-	if (Velocidades[index] < -kVelocityLimit) {
-		Velocidades[index] = -kVelocityLimit;
-	}
-	if (Velocidades[index] > kVelocityLimit) {
-		Velocidades[index] = kVelocityLimit;
+	size_t particle = (size_t)(toupper((unsigned char)label) - 'A');
+	if (particle >= particulas.Count()) {
+		return;
 	}
-	Factors[index] = FactorFromVelocity(Velocidades[index]);
+	double frame = FisicaMarcos[windowIndex];
+	particulas.SetVelocity(particle, ClampVelocity(ComposeVelocity(frame, ClampVelocity(velocity))));
+	UpdateLorentzView();
 }
 
-static void ApplyDeltaToLabelInWindow(int windowIndex, char column, double delta)
+// Modelo lorentz: delta es un cambio de velocidad medido en el marco de la
+// ventana y se suma de forma relativista.
+static void ApplyLorentzDelta(int windowIndex, char label, double delta)
 {
-	if (windowIndex < 0 || windowIndex >= kWindowCount) {
+	size_t particle = (size_t)(toupper((unsigned char)label) - 'A');
+	if (particle >= particulas.Count()) {
 		return;
 	}
-	char target = (char)toupper((unsigned char)column);
-	for (int c = 0; c < kColumnsPerWindow; c++) {
-		if (GetLabelForWindowColumn(windowIndex, c) == target) {
-			int idx = windowIndex * kColumnsPerWindow + c;
-			ApplyVelocityDelta(idx, delta);
-			break;
-		}
-	}
+	double local = RelativeVelocity(particulas.Velocity(particle), FisicaMarcos[windowIndex]);
+	SetLorentzVelocity(windowIndex, label, ComposeVelocity(local, delta));
 }
 
 static void AdjustSelectedVelocity(int windowIndex, double delta)
@@ -244,6 +180,10 @@ static void AdjustSelectedVelocity(int windowIndex, double delta)
 	}
 	int selectedColumn = SelectedGauge[windowIndex];
 	char label = GetLabelForWindowColumn(windowIndex, selectedColumn);
+	if (Fisica == kFisicaLorentz) {
+		ApplyLorentzDelta(windowIndex, label, delta);
+		return;
+	}
 	int idx = windowIndex * kColumnsPerWindow + selectedColumn;
 	ApplyVelocityDelta(idx, delta);
 	for (int w = 0; w < kWindowCount; w++) {
@@ -259,6 +199,114 @@ static void AdjustSelectedVelocity(int windowIndex, double delta)
 	}
 }
 
+static void UpdateIntervalos()
+{
+	double values[kWindowCount * kIntervalCount];
+	GetIntervalValues(Times, values);
+	for (int w = 0; w < kWindowCount; w++) {
+		Intervalos[w].dtBA = values[w * kIntervalCount + kIntervaloBA];
+		Intervalos[w].dtAC = values[w * kIntervalCount + kIntervaloAC];
+		Intervalos[w].dtBC = values[w * kIntervalCount + kIntervaloBC];
+	}
+}
+
+static void MarkReachedEventos()
+{
+	double columnTimes[kWindowCount * kIndexColumns];
+	double intervalValues[kWindowCount * kIntervalCount];
+	GetColumnTimes(columnTimes);
+	GetIntervalValues(Times, intervalValues);
+	eventIndex.Rewind();
+	eventIndex.Seek(columnTimes, intervalValues);
+}
+
+// Estado de una ventana al llegar a un evento 'instantanea', como una linea
+// mas de instantaneas.csv.
+static void WriteSnapshot(uint32_t event, int window)
+{
+	FILE* f = fopen("instantaneas.csv", "a");
+	if (f == NULL) {
+		SDL_Log("No se pudo abrir instantaneas.csv");
+		return;
+	}
+	fprintf(f, "%llu,%u,%d", StepCount, (unsigned)event, window);
+	for (int c = 0; c < kIndexColumns; c++) {
+		int idx = GetIndexForLabelInWindow(window, (char)('A' + c));
+		fprintf(f, ",%.9f,%.6f", Times[idx], Velocidades[idx]);
+	}
+	fprintf(f, ",%.9f,%.9f,%.9f\n", Intervalos[window].dtBA, Intervalos[window].dtAC, Intervalos[window].dtBC);
+	fclose(f);
+}
+
+// Acciones de los eventos sobre el estado de la simulacion, segun el modelo
+// fisico.  En dilatacion las demas ventanas ven los cambios con el signo
+// contrario; en lorentz solo actua la ventana 0 (las demas lo ven a traves
+// de la transformacion).
+class SimulationTarget : public EventTarget {
+public:
+	void Pausa(uint32_t, int) override
+	{
+		Pause = true;
+	}
+
+	void AddVelocity(int window, char label, double delta) override
+	{
+		if (Fisica == kFisicaLorentz) {
+			if (window == 0) {
+				ApplyLorentzDelta(0, label, delta);
+			}
+			return;
+		}
+		ApplyDeltaToLabelInWindow(window, label, (window == 0) ? delta : -delta);
+	}
+
+	void SetVelocity(int window, char label, double velocity) override
+	{
+		if (Fisica == kFisicaLorentz) {
+			if (window == 0) {
+				SetLorentzVelocity(0, label, velocity);
+			}
+			return;
+		}
+		int idx = GetIndexForLabelInWindow(window, label);
+		if (idx >= 0) {
+			SetColumnVelocity(idx, (window == 0) ? velocity : -velocity);
+		}
+	}
+
+	void StartRamp(const AppEvent& ev, int window) override
+	{
+		rampas.Start(ev, window);
+	}
+
+	void Instantanea(uint32_t event, int window) override
+	{
+		WriteSnapshot(event, window);
+	}
+
+	void StartAcceleration(const AppEvent& ev, int window) override
+	{
+		char label = ColumnLabel(ev.column);
+		if (Fisica == kFisicaLorentz) {
+			// La aceleracion propia tiene el mismo sentido en todos los marcos.
+			size_t particle = (size_t)(label - 'A');
+			if (window == 0 && particle < particulas.Count()) {
+				particulas.Accelerate(particle, ev.amount, ev.duration);
+			}
+			return;
+		}
+		int idx = GetIndexForLabelInWindow(window, label);
+		if (idx >= 0) {
+			aceleraciones.Start(idx, (window == 0) ? ev.amount : -ev.amount, ev.duration);
+		}
+	}
+
+	RampSet rampas;
+	AccelerationSet aceleraciones;
+};
+
+SimulationTarget simulacion;
+
 static void ResetState()
 {
 	Pause = true;
@@ -276,10 +324,17 @@ static void ResetState()
 		Velocidades[base + 1] = 0.0;
 		Velocidades[base + 2] = 0.0;
 	}
-	for (int i = 0; i < kTotalColumns; i++) {
-		Factors[i] = FactorFromVelocity(Velocidades[i]);
+	FactorsFromVelocities(Velocidades, Factors, Rates, kTotalColumns);
+	if (Fisica == kFisicaLorentz) {
+		particulas.Reset(kIndexColumns);
+		particulas.SetSpeedLimit(kVelocityLimit);
+		UpdateLorentzView();
 	}
 	ResetEventos();
+	simulacion.rampas.Clear();
+	simulacion.aceleraciones.Clear();
+	StepCount = 0;
+	UpdateIntervalos();
 }
 
 static void quit(const char* msg)
@@ -427,6 +482,8 @@ void DrawGauge(SDL_Renderer* surf, double Pos, double Sep, int PosX, TTF_Font* f
 void SDL_AppQuit(void* appstate, SDL_AppResult result)
 {
 	/* SDL will clean up the window/renderer for us. */
+	recarga.Stop();
+	telemetria.Stop();
 	for (int i = 0; i < 10; i++)
 	{
 		TTF_CloseFont(fuentes[i]);
@@ -483,9 +540,9 @@ void DrawFactorGauges(SDL_Renderer *surf, int baseIndex, int selectedIndex, int
 		int xA = Posx[idxA - baseIndex];
 		int xC = Posx[idxC - baseIndex];
 
-		double dtBA = Times[idxB] - Times[idxA];
-		double dtAC = Times[idxA] - Times[idxC];
-		double dtBC = Times[idxB] - Times[idxC];
+		double dtBA = Intervalos[windowIndex].dtBA;
+		double dtAC = Intervalos[windowIndex].dtAC;
+		double dtBC = Intervalos[windowIndex].dtBC;
 
 		SDL_Color Green = { 20, 230, 20 };
 		SDL_SetRenderDrawColor(surf, Green.r, Green.g, Green.b, SDL_ALPHA_OPAQUE);
@@ -502,8 +559,142 @@ void DrawFactorGauges(SDL_Renderer *surf, int baseIndex, int selectedIndex, int
 	}
 }
 
+// Lineas de universo de A, B y C en el marco de la ventana (modelo lorentz).
+// x' en horizontal y t' hacia arriba con la misma escala (c = 1); el borde
+// superior es el instante actual de la ventana.
+static void DrawWorldlines(SDL_Renderer* surf, int windowIndex)
+{
+	if (Fisica != kFisicaLorentz) {
+		return;
+	}
+	const double span = 10.0;
+	static const SDL_Color colors[kIndexColumns] = {
+		{ 230, 80, 80, 255 },
+		{ 80, 220, 80, 255 },
+		{ 90, 140, 255, 255 }
+	};
+	SDL_Rect panel = { PanWidth / 40, PanHeight / 40, PanWidth / 4, PanHeight / 4 };
+	double frame = FisicaMarcos[windowIndex];
+	double gamma = 1.0 / sqrt(1.0 - frame * frame);
+	double now = particulas.Time();
+	double viewX[kIndexColumns];
+	particulas.View(frame, now, NULL, viewX, NULL);
+
+	SDL_SetRenderClipRect(surf, &panel);
+	SDL_SetRenderDrawColor(surf, 90, 90, 90, SDL_ALPHA_OPAQUE);
+	SDL_FRect border = { (float)panel.x, (float)panel.y, (float)panel.w, (float)panel.h };
+	SDL_RenderRect(surf, &border);
+
+	// Los tramos hiperbolicos se dibujan con unos cuantos puntos intermedios.
+	const int curveSamples = 8;
+	std::vector<SDL_FPoint> points;
+	for (int c = 0; c < kIndexColumns; c++) {
+		points.clear();
+		const std::vector<WorldSegment>& segs = particulas.Segments(c);
+		bool done = false;
+		for (size_t k = 0; k < segs.size() && !done; k++) {
+			int samples = (segs[k].a != 0.0) ? curveSamples : 1;
+			double end = (k + 1 < segs.size()) ? segs[k + 1].t : particulas.Time();
+			for (int j = 0; j < samples; j++) {
+				double t = segs[k].t + (end - segs[k].t) * j / samples;
+				double x, tau, v;
+				WorldlinePoint(segs[k], t, x, tau, v);
+				// Los sucesos siguen ordenados en cualquier marco (|v| < 1).
+				double tp = gamma * (t - frame * x);
+				if (tp > now) {
+					done = true;
+					break;
+				}
+				double xp = gamma * (x - frame * t);
+				SDL_FPoint p = { (float)(panel.x + panel.w / 2 + xp / span * panel.w),
+					(float)(panel.y + (now - tp) / span * panel.h) };
+				points.push_back(p);
+			}
+		}
+		SDL_FPoint last = { (float)(panel.x + panel.w / 2 + viewX[c] / span * panel.w), (float)panel.y };
+		points.push_back(last);
+		SDL_SetRenderDrawColor(surf, colors[c].r, colors[c].g, colors[c].b, SDL_ALPHA_OPAQUE);
+		SDL_RenderLines(surf, points.data(), (int)points.size());
+	}
+	SDL_SetRenderClipRect(surf, NULL);
+}
+
+// Cambia al escenario recargado, si lo hay.  Se llama entre pasos, despues
+// de procesar los eventos y antes de avanzar los relojes.
+static void ApplyPendingReload()
+{
+	ScenarioConfig* next = recarga.TakePending();
+	if (next == NULL) {
+		return;
+	}
+	escenarioMapeado.Close();
+	eventos.swap(next->eventos);
+	eventData = eventos.data();
+	eventCount = eventos.size();
+	eventIndex.Build(eventData, eventCount);
+	// Cambiar de modelo fisico obliga a empezar de nuevo.
+	bool physicsChanged = (next->fisicaModelo != Fisica);
+	Fisica = next->fisicaModelo;
+	for (int w = 0; w < kWindowCount; w++) {
+		if (next->fisicaMarcos[w] != FisicaMarcos[w]) {
+			physicsChanged = physicsChanged || Fisica == kFisicaLorentz;
+			FisicaMarcos[w] = next->fisicaMarcos[w];
+		}
+	}
+	if (next->recargaModo == kRecargaReiniciar || physicsChanged) {
+		ResetState();
+	} else {
+		MarkReachedEventos();
+	}
+	delete next;
+}
+
+void StepSimulation()
+{
+	double columnTimes[kWindowCount * kIndexColumns];
+	double intervalValues[kWindowCount * kIntervalCount];
+	GetColumnTimes(columnTimes);
+	GetIntervalValues(Times, intervalValues);
+	disparados.clear();
+	eventIndex.Collect(columnTimes, disparados, intervalValues);
+	for (size_t d = 0; d < disparados.size(); d++) {
+		const EventoDisparado& disparo = disparados[d];
+		const AppEvent& ev = eventData[disparo.event];
+		DispatchEvent(simulacion, ev, disparo.event, disparo.window);
+		telemetria.PublishEvent(StepCount, (int)disparo.event, disparo.window, (EventType)ev.type);
+	}
 
+	ApplyPendingReload();
 
+	if ((Pause==false)||(NextStep==true))
+	{
+		simulacion.rampas.Step(simulacion);
+		if (Fisica == kFisicaLorentz) {
+			particulas.Advance(kStepTime);
+			UpdateLorentzView();
+		} else {
+			// Las columnas que aceleran avanzan con la integral exacta.
+			bool acelerando = simulacion.aceleraciones.Active();
+			bool moved[kTotalColumns] = {};
+			if (acelerando) {
+				simulacion.aceleraciones.Advance(kStepTime, Times, Velocidades, moved);
+			}
+			for (int i = 0; i < kTotalColumns; i++)
+			{
+				if (!moved[i]) {
+					Times[i]+=kStepTime * Rates[i];
+				}
+			}
+			if (acelerando) {
+				FactorsFromVelocities(Velocidades, Factors, Rates, kTotalColumns);
+			}
+		}
+		NextStep=false;
+		StepCount++;
+		UpdateIntervalos();
+		telemetria.PublishStep(StepCount, Intervalos);
+	}
+}
 
 void DrawScene()
 {
@@ -518,43 +709,11 @@ void DrawScene()
 		SDL_SetRenderDrawColor(renderers[i], 0, 0, 0, SDL_ALPHA_OPAQUE);
 		SDL_RenderClear(renderers[i]);
 		DrawFactorGauges(renderers[i], i * kColumnsPerWindow, SelectedGauge[i], i);
+		DrawWorldlines(renderers[i], i);
 		SDL_RenderPresent(renderers[i]);
 	}
 
-	for (auto& ev : eventos) {
-		if (ev.type == "pausa") {
-			if (!ev.triggered && ColumnReached(ev.column, ev.time)) {
-				Pause = true;
-				ev.triggered = true;
-			}
-			continue;
-		}
-		if (ev.type == "cambio") {
-			for (int w = 0; w < kWindowCount; w++) {
-				int bit = 1 << w;
-				if ((ev.triggeredMask & bit) != 0) {
-					continue;
-				}
-				if (ColumnReachedInWindow(w, ev.column, ev.time)) {
-					double signedAmount = (w == 0) ? ev.amount : -ev.amount;
-					ApplyDeltaToLabelInWindow(w, ev.column, signedAmount);
-					ev.triggeredMask |= bit;
-				}
-			}
-			if (ev.triggeredMask == ((1 << kWindowCount) - 1)) {
-				ev.triggered = true;
-			}
-		}
-	}
-
-	if ((Pause==false)||(NextStep==true))
-	{
-		for (int i = 0; i < kTotalColumns; i++)
-		{
-			Times[i]+=(1.0/100.0) * (1/Factors[i]);
-		}
-		NextStep=false;
-	}
+	StepSimulation();
 }
 
 
@@ -618,6 +777,7 @@ SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event)
 SDL_AppResult SDL_AppIterate(void* appstate)
 {
 	DrawScene();
+	telemetria.Flush(false);
 	return SDL_APP_CONTINUE;  /* carry on with the program! */
 }
 void pruebas()
@@ -639,25 +799,76 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char* argv[])
 
 	
 	InitSdl();
-	LoadEventos();
+	if (argc > 1) {
+		// Escenario indicado en la linea de comandos (YAML o binario).
+		LoadEventosFromPath(argv[1]);
+	} else {
+		LoadEventos();
+	}
 	ResetState();
+	if (TelemetriaPuerto > 0) {
+		telemetria.Start((unsigned short)TelemetriaPuerto, TelemetriaDecimacion);
+	}
+	if (RecargaActiva && !configPath.empty()) {
+		recarga.Start(configPath);
+	}
 
 
 
 	return SDL_APP_CONTINUE;  /* carry on with the program! */
 
 }
+static bool LoadEventosFromPath(const std::string& path)
+{
+	ScenarioConfig config;
+	std::string error;
+	if (IsScenarioBinary(path.c_str())) {
+		// Se usan los registros mapeados tal cual, sin copiarlos.  Se validan
+		// y se comprueba la suma como en la recarga, que si no rechazaria lo
+		// que se acepta al arrancar.
+		if (!escenarioMapeado.Open(path.c_str(), error, true)
+			|| !ValidateEventos(escenarioMapeado.Events(), escenarioMapeado.Count(), error)) {
+			SDL_Log("Fallo al cargar %s: %s", path.c_str(), error.c_str());
+			escenarioMapeado.Close();
+			return false;
+		}
+		escenarioMapeado.CopySettingsTo(config);
+		eventos.clear();
+		eventData = escenarioMapeado.Events();
+		eventCount = escenarioMapeado.Count();
+	} else {
+		// El lector omite los eventos que no valen y sigue con el resto.
+		if (!LoadEventosFromYaml(path.c_str(), config, error)) {
+			SDL_Log("Fallo al cargar %s: %s", path.c_str(), error.c_str());
+			return false;
+		}
+		escenarioMapeado.Close();
+		eventos.swap(config.eventos);
+		eventData = eventos.data();
+		eventCount = eventos.size();
+	}
+	eventIndex.Build(eventData, eventCount);
+	TelemetriaPuerto = config.telemetriaPuerto;
+	TelemetriaDecimacion = config.telemetriaDecimacion;
+	RecargaActiva = config.recargaActiva;
+	Fisica = config.fisicaModelo;
+	for (int w = 0; w < kWindowCount; w++) {
+		FisicaMarcos[w] = config.fisicaMarcos[w];
+	}
+	configPath = path;
+	return true;
+}
+
 static void LoadEventos()
 {
 	const char* basePath = SDL_GetBasePath();
 	if (basePath != NULL) {
-		std::string configPath = std::string(basePath) + "config.yaml";
-		if (LoadEventosFromYaml(configPath.c_str())) {
+		if (LoadEventosFromPath(std::string(basePath) + "config.yaml")) {
 			return;
 		}
 	}
-	if (LoadEventosFromYaml("config.yaml")) {
+	if (LoadEventosFromPath("config.yaml")) {
 		return;
 	}
-	LoadEventosFromYaml("../config.yaml");
+	LoadEventosFromPath("../config.yaml");
 }
@@ -0,0 +1,291 @@
+#include <string.h>
+#include "RelaTelemetria.h"
+#include "FramedSocket.h"
+
+static const size_t kMaxBatchSamples = 256;
+static const size_t kMaxBatchEvents = 256;
+static const size_t kMaxQueuedBatches = 64;
+static const uint64_t kFlushIntervalMs = 100;
+static const int kPollIntervalMs = 10;
+
+static void PutLE(std::vector<unsigned char>& out, size_t& pos, uint64_t value, int bytes)
+{
+	for (int i = 0; i < bytes; i++) {
+		out[pos++] = (unsigned char)(value >> (8 * i));
+	}
+}
+
+static void PutDouble(std::vector<unsigned char>& out, size_t& pos, double value)
+{
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	PutLE(out, pos, bits, 8);
+}
+
+TelemetryPublisher::TelemetryPublisher(int windowCount)
+	: windowCount(windowCount), decimation(1), batchSequence(0), lastFlushTicks(0),
+	  server(NULL), thread(NULL), mutex(NULL)
+{
+	steps.reserve(kMaxBatchSamples);
+	columns.resize((size_t)windowCount * 3 * kMaxBatchSamples);
+	eventSteps.reserve(kMaxBatchEvents);
+	eventIndices.reserve(kMaxBatchEvents);
+	eventWindows.reserve(kMaxBatchEvents);
+	eventKinds.reserve(kMaxBatchEvents);
+	SDL_SetAtomicInt(&stopRequested, 0);
+	SDL_SetAtomicInt(&subscriberCount, 0);
+}
+
+TelemetryPublisher::~TelemetryPublisher()
+{
+	Stop();
+}
+
+bool TelemetryPublisher::Start(unsigned short port, int decimationSteps)
+{
+	if (thread != NULL) {
+		return true;
+	}
+	decimation = (decimationSteps < 1) ? 1 : decimationSteps;
+	try {
+		server = new TCPServerSocket(port);
+	} catch (const SocketException& ex) {
+		SDL_Log("Telemetria: no se pudo abrir el puerto %u: %s", port, ex.what());
+		return false;
+	}
+	mutex = SDL_CreateMutex();
+	SDL_SetAtomicInt(&stopRequested, 0);
+	thread = SDL_CreateThread(ThreadMain, "telemetria", this);
+	if (thread == NULL) {
+		SDL_Log("Telemetria: fallo al crear el hilo: %s", SDL_GetError());
+		SDL_DestroyMutex(mutex);
+		mutex = NULL;
+		delete server;
+		server = NULL;
+		return false;
+	}
+	lastFlushTicks = SDL_GetTicks();
+	return true;
+}
+
+void TelemetryPublisher::Stop()
+{
+	if (thread == NULL) {
+		return;
+	}
+	SDL_SetAtomicInt(&stopRequested, 1);
+	SDL_WaitThread(thread, NULL);
+	thread = NULL;
+	for (Subscriber* sub : subscribers) {
+		delete sub->sock;
+		delete sub;
+	}
+	subscribers.clear();
+	SDL_SetAtomicInt(&subscriberCount, 0);
+	SDL_DestroyMutex(mutex);
+	mutex = NULL;
+	delete server;
+	server = NULL;
+	ClearBatch();
+}
+
+void TelemetryPublisher::PublishStep(uint64_t step, const Intervalo* intervals)
+{
+	if (thread == NULL || (step % (uint64_t)decimation) != 0) {
+		return;
+	}
+	size_t n = steps.size();
+	steps.push_back(step);
+	for (int w = 0; w < windowCount; w++) {
+		double* base = &columns[(size_t)w * 3 * kMaxBatchSamples];
+		base[n] = intervals[w].dtBA;
+		base[kMaxBatchSamples + n] = intervals[w].dtAC;
+		base[2 * kMaxBatchSamples + n] = intervals[w].dtBC;
+	}
+	if (steps.size() == kMaxBatchSamples) {
+		Flush(true);
+	}
+}
+
+void TelemetryPublisher::PublishEvent(uint64_t step, int eventIndex, int window, EventType kind)
+{
+	if (thread == NULL) {
+		return;
+	}
+	eventSteps.push_back(step);
+	eventIndices.push_back((uint32_t)eventIndex);
+	eventWindows.push_back((uint8_t)window);
+	eventKinds.push_back((uint8_t)kind);
+	if (eventSteps.size() == kMaxBatchEvents) {
+		Flush(true);
+	}
+}
+
+void TelemetryPublisher::ClearBatch()
+{
+	steps.clear();
+	eventSteps.clear();
+	eventIndices.clear();
+	eventWindows.clear();
+	eventKinds.clear();
+}
+
+TelemetryPublisher::Batch TelemetryPublisher::EncodeBatch()
+{
+	size_t samples = steps.size();
+	size_t events = eventSteps.size();
+	size_t payload = 12 + samples * 8 + samples * 8 * 3 * (size_t)windowCount + events * (8 + 4 + 1 + 1);
+
+	std::shared_ptr<std::vector<unsigned char> > out = std::make_shared<std::vector<unsigned char> >(kMaxFrameHeader + payload);
+	size_t pos = encodeFrameLength((uint32_t)payload, out->data());
+	out->resize(pos + payload);
+
+	PutLE(*out, pos, 1, 1);
+	PutLE(*out, pos, (uint64_t)windowCount, 1);
+	PutLE(*out, pos, samples, 2);
+	PutLE(*out, pos, events, 2);
+	PutLE(*out, pos, 0, 2);
+	PutLE(*out, pos, batchSequence, 4);
+	for (size_t i = 0; i < samples; i++) {
+		PutLE(*out, pos, steps[i], 8);
+	}
+	for (int w = 0; w < windowCount; w++) {
+		const double* base = &columns[(size_t)w * 3 * kMaxBatchSamples];
+		for (int k = 0; k < 3; k++) {
+			for (size_t i = 0; i < samples; i++) {
+				PutDouble(*out, pos, base[k * kMaxBatchSamples + i]);
+			}
+		}
+	}
+	for (size_t i = 0; i < events; i++) {
+		PutLE(*out, pos, eventSteps[i], 8);
+	}
+	for (size_t i = 0; i < events; i++) {
+		PutLE(*out, pos, eventIndices[i], 4);
+	}
+	for (size_t i = 0; i < events; i++) {
+		PutLE(*out, pos, eventWindows[i], 1);
+	}
+	for (size_t i = 0; i < events; i++) {
+		PutLE(*out, pos, eventKinds[i], 1);
+	}
+	return out;
+}
+
+void TelemetryPublisher::Flush(bool force)
+{
+	if (thread == NULL || (steps.empty() && eventSteps.empty())) {
+		return;
+	}
+	uint64_t now = SDL_GetTicks();
+	if (!force && now - lastFlushTicks < kFlushIntervalMs) {
+		return;
+	}
+	lastFlushTicks = now;
+
+	// Sin suscriptores no hace falta serializar nada.
+	if (SDL_GetAtomicInt(&subscriberCount) > 0) {
+		Batch batch = EncodeBatch();
+		SDL_LockMutex(mutex);
+		for (Subscriber* sub : subscribers) {
+			if (sub->queue.size() >= kMaxQueuedBatches) {
+				sub->queue.pop_front();
+				sub->dropped++;
+			}
+			sub->queue.push_back(batch);
+		}
+		SDL_UnlockMutex(mutex);
+	}
+	batchSequence++;
+	ClearBatch();
+}
+
+int SDLCALL TelemetryPublisher::ThreadMain(void* data)
+{
+	static_cast<TelemetryPublisher*>(data)->Run();
+	return 0;
+}
+
+// Envia sin bloquear lo que el socket acepte.  Devuelve false si el suscriptor se ha ido.
+bool TelemetryPublisher::SendPending(Subscriber* sub)
+{
+	std::error_code ec;
+	char discard[256];
+	int received = sub->sock->recv(discard, sizeof(discard), ec);
+	if (!ec && received == 0) {
+		return false;  // El suscriptor ha cerrado la conexion
+	}
+	if (ec && ec != std::errc::operation_would_block && ec != std::errc::resource_unavailable_try_again) {
+		return false;
+	}
+
+	for (;;) {
+		if (!sub->current) {
+			SDL_LockMutex(mutex);
+			if (!sub->queue.empty()) {
+				sub->current = sub->queue.front();
+				sub->queue.pop_front();
+				sub->offset = 0;
+			}
+			SDL_UnlockMutex(mutex);
+			if (!sub->current) {
+				return true;
+			}
+		}
+		const std::vector<unsigned char>& bytes = *sub->current;
+		int n = sub->sock->send(bytes.data() + sub->offset, (int)(bytes.size() - sub->offset), ec);
+		if (ec) {
+			return ec == std::errc::operation_would_block || ec == std::errc::resource_unavailable_try_again;
+		}
+		sub->offset += (size_t)n;
+		if (sub->offset == bytes.size()) {
+			sub->current.reset();
+		}
+	}
+}
+
+void TelemetryPublisher::Run()
+{
+	while (SDL_GetAtomicInt(&stopRequested) == 0) {
+		try {
+			if (server->waitReadable(kPollIntervalMs)) {
+				std::error_code ec;
+				TCPSocket* sock = server->accept(ec);
+				if (sock != NULL) {
+					try {
+						sock->setBlocking(false);
+						sock->setNoDelay(true);
+					} catch (const SocketException&) {
+						delete sock;
+						throw;
+					}
+					Subscriber* sub = new Subscriber();
+					sub->sock = sock;
+					sub->offset = 0;
+					sub->dropped = 0;
+					SDL_LockMutex(mutex);
+					subscribers.push_back(sub);
+					SDL_UnlockMutex(mutex);
+					SDL_AddAtomicInt(&subscriberCount, 1);
+				}
+			}
+		} catch (const SocketException& ex) {
+			SDL_Log("Telemetria: %s", ex.what());
+		}
+
+		// Solo este hilo modifica la lista, asi que puede recorrerla sin el mutex.
+		for (size_t i = 0; i < subscribers.size(); ) {
+			Subscriber* sub = subscribers[i];
+			if (SendPending(sub)) {
+				i++;
+				continue;
+			}
+			SDL_LockMutex(mutex);
+			subscribers.erase(subscribers.begin() + i);
+			SDL_UnlockMutex(mutex);
+			SDL_AddAtomicInt(&subscriberCount, -1);
+			delete sub->sock;
+			delete sub;
+		}
+	}
+}
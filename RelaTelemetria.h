@@ -0,0 +1,97 @@
+#ifndef RELATELEMETRIA_H_INCLUDED
+#define RELATELEMETRIA_H_INCLUDED
+
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "SDL.h"
+#include "PracticalSocket.h"
+#include "RelaEventos.h"
+
+// Intervalos entre relojes de una ventana, calculados una vez por paso.
+struct Intervalo {
+	double dtBA;
+	double dtAC;
+	double dtBC;
+};
+
+/*
+ * Publica por TCP los intervalos de cada paso y el registro de eventos
+ * disparados.  El hilo de simulacion solo acumula columnas en memoria ya
+ * reservada; un hilo de red acepta suscriptores y les envia lotes.
+ *
+ * Cada lote es una trama (prefijo varint, ver FramedSocket.h) con formato
+ * columnar little-endian:
+ *
+ *   u8  version (1)          u8  windowCount
+ *   u16 sampleCount          u16 eventCount        u16 reservado
+ *   u32 batchSequence
+ *   u64 step[sampleCount]
+ *   f64 dtBA[sampleCount], dtAC[sampleCount], dtBC[sampleCount]  (por ventana)
+ *   u64 eventStep[eventCount]
+ *   u32 eventIndex[eventCount]
+ *   u8  eventWindow[eventCount]
+ *   u8  eventKind[eventCount]  (EventType)
+ *
+ * Cada suscriptor tiene una cola acotada; si no consume a tiempo se
+ * descartan sus lotes mas antiguos (los huecos se ven en batchSequence).
+ */
+class TelemetryPublisher {
+public:
+	TelemetryPublisher(int windowCount);
+	~TelemetryPublisher();
+
+	// Abre el puerto y arranca el hilo de red.  decimation = publicar uno de cada N pasos.
+	bool Start(unsigned short port, int decimation);
+	void Stop();
+	bool IsRunning() const { return thread != NULL; }
+
+	// Llamadas desde el hilo de simulacion.
+	void PublishStep(uint64_t step, const Intervalo* intervals);
+	void PublishEvent(uint64_t step, int eventIndex, int window, EventType kind);
+	void Flush(bool force);
+
+private:
+	TelemetryPublisher(const TelemetryPublisher&);
+	void operator=(const TelemetryPublisher&);
+
+	typedef std::shared_ptr<const std::vector<unsigned char> > Batch;
+
+	struct Subscriber {
+		TCPSocket* sock;
+		std::deque<Batch> queue;
+		Batch current;
+		size_t offset;
+		uint64_t dropped;
+	};
+
+	static int SDLCALL ThreadMain(void* data);
+	void Run();
+	bool SendPending(Subscriber* sub);
+	Batch EncodeBatch();
+	void ClearBatch();
+
+	int windowCount;
+	int decimation;
+	uint32_t batchSequence;
+	uint64_t lastFlushTicks;
+
+	// Columnas del lote en curso (capacidad reservada en el constructor).
+	std::vector<uint64_t> steps;
+	std::vector<double> columns;  // [window][3][sample]
+	std::vector<uint64_t> eventSteps;
+	std::vector<uint32_t> eventIndices;
+	std::vector<uint8_t> eventWindows;
+	std::vector<uint8_t> eventKinds;
+
+	TCPServerSocket* server;
+	SDL_Thread* thread;
+	SDL_Mutex* mutex;
+	SDL_AtomicInt stopRequested;
+	SDL_AtomicInt subscriberCount;
+	std::vector<Subscriber*> subscribers;  // protegido por mutex
+};
+
+#endif // RELATELEMETRIA_H_INCLUDED
@@ -0,0 +1,89 @@
+#include <math.h>
+#include "RelaTipos.h"
+#include "RelaModelo.h"
+
+static void ApplyPausa(EventTarget& target, const AppEvent&, uint32_t event, int window)
+{
+	target.Pausa(event, window);
+}
+
+static void ApplyCambio(EventTarget& target, const AppEvent& ev, uint32_t, int window)
+{
+	target.AddVelocity(window, ColumnLabel(ev.column), ev.amount);
+}
+
+static void ApplyFijar(EventTarget& target, const AppEvent& ev, uint32_t, int window)
+{
+	target.SetVelocity(window, ColumnLabel(ev.column), ev.amount);
+}
+
+static void ApplyRampa(EventTarget& target, const AppEvent& ev, uint32_t, int window)
+{
+	target.StartRamp(ev, window);
+}
+
+static void ApplyAceleracion(EventTarget& target, const AppEvent& ev, uint32_t, int window)
+{
+	target.StartAcceleration(ev, window);
+}
+
+static void ApplyInstantanea(EventTarget& target, const AppEvent&, uint32_t event, int window)
+{
+	target.Instantanea(event, window);
+}
+
+const EventTypeInfo kEventTypes[kEventTypeCount] = {
+	{ "pausa", "pausas", 0, kCampoCount, false, ApplyPausa },
+	{ "cambio", "cambios", FieldBit(kCampoCantidad), kCampoCantidad, true, ApplyCambio },
+	{ "fijar", "fijados", FieldBit(kCampoVelocidad), kCampoVelocidad, true, ApplyFijar },
+	{ "rampa", "rampas", FieldBit(kCampoCantidad) | FieldBit(kCampoDuracion), kCampoCantidad, true, ApplyRampa },
+	{ "instantanea", "instantaneas", 0, kCampoCount, true, ApplyInstantanea },
+	{ "aceleracion", "aceleraciones", FieldBit(kCampoAceleracion) | FieldBit(kCampoDuracion), kCampoAceleracion,
+		true, ApplyAceleracion }
+};
+
+bool FindEventType(const std::string& name, uint8_t& type)
+{
+	for (int i = 0; i < kEventTypeCount; i++) {
+		if (name == kEventTypes[i].name) {
+			type = (uint8_t)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+unsigned long long RampSteps(const AppEvent& ev)
+{
+	double steps = floor(ev.duration / kStepTime + 0.5);
+	if (!(steps >= 1.0)) {
+		return 1;
+	}
+	if (steps > 1.0e15) {
+		return 1000000000000000ULL;
+	}
+	return (unsigned long long)steps;
+}
+
+void RampSet::Start(const AppEvent& ev, int window)
+{
+	Ramp ramp;
+	ramp.window = window;
+	ramp.label = ColumnLabel(ev.column);
+	ramp.remaining = RampSteps(ev);
+	ramp.delta = ev.amount / (double)ramp.remaining;
+	ramps.push_back(ramp);
+}
+
+void RampSet::Step(EventTarget& target)
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < ramps.size(); i++) {
+		Ramp& ramp = ramps[i];
+		target.AddVelocity(ramp.window, ramp.label, ramp.delta);
+		if (--ramp.remaining > 0) {
+			ramps[kept++] = ramp;
+		}
+	}
+	ramps.resize(kept);
+}
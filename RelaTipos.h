@@ -0,0 +1,108 @@
+#ifndef RELATIPOS_H_INCLUDED
+#define RELATIPOS_H_INCLUDED
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "RelaEventos.h"
+
+// Campos de un evento en config.yaml, en el orden de la tabla de campos del
+// lector (RelaEventos.cpp).  Los tipos piden los suyos con FieldBit(); tipo,
+// columna y el disparo los piden todos.
+enum EventField {
+	kCampoTipo = 0,
+	kCampoColumna,
+	kCampoTiempo,
+	kCampoCantidad,
+	kCampoVelocidad,
+	kCampoDuracion,
+	kCampoPeriodo,
+	kCampoRepeticiones,
+	kCampoIntervalo,
+	kCampoUmbral,
+	kCampoSentido,
+	kCampoAceleracion,
+	kCampoCount
+};
+
+inline uint32_t FieldBit(int field)
+{
+	return 1u << field;
+}
+
+// Lo que un evento puede hacer sobre la simulacion.  La implementan el
+// programa (StepSimulation) y el motor analitico; cada uno decide como se ve
+// el cambio en las demas ventanas segun el modelo fisico.
+class EventTarget {
+public:
+	virtual ~EventTarget() {}
+
+	virtual void Pausa(uint32_t event, int window) = 0;
+	virtual void AddVelocity(int window, char label, double delta) = 0;
+	virtual void SetVelocity(int window, char label, double velocity) = 0;
+	virtual void StartRamp(const AppEvent& ev, int window) = 0;
+	virtual void Instantanea(uint32_t event, int window) = 0;
+	virtual void StartAcceleration(const AppEvent& ev, int window) = 0;
+};
+
+typedef void (*EventAction)(EventTarget& target, const AppEvent& ev, uint32_t event, int window);
+
+struct EventTypeInfo {
+	const char* name;        // 'tipo' en config.yaml
+	const char* plural;      // para los resumenes
+	uint32_t required;       // campos propios obligatorios
+	int amountField;         // campo que va a AppEvent::amount, o kCampoCount
+	bool allWindows;         // false: solo se dispara en la ventana 0
+	EventAction apply;
+};
+
+/*
+ * Registro de tipos de evento, indexado por EventType.  Anadir un tipo es
+ * anadir un valor a EventType, su entrada aqui y, si hace falta, un metodo
+ * en EventTarget; el lector, el indice y los dos bucles de simulacion no
+ * cambian.  Cada paso despacha con una llamada indirecta por evento, sin
+ * comparar nombres ni recorrer casos.
+ */
+extern const EventTypeInfo kEventTypes[kEventTypeCount];
+
+// Tipo por su nombre en config.yaml; false si no existe.
+bool FindEventType(const std::string& name, uint8_t& type);
+
+inline bool IsKnownEventType(uint8_t type)
+{
+	return type < kEventTypeCount;
+}
+
+// El tipo tiene que ser conocido (los lectores e indices ya lo comprueban).
+inline void DispatchEvent(EventTarget& target, const AppEvent& ev, uint32_t event, int window)
+{
+	kEventTypes[ev.type].apply(target, ev, event, window);
+}
+
+// Numero de pasos de una rampa (al menos uno).
+unsigned long long RampSteps(const AppEvent& ev);
+
+/*
+ * Rampas en curso.  Cada una reparte su cantidad en pasos iguales que se
+ * aplican con AddVelocity antes de avanzar los relojes, asi que en cada
+ * ventana se ve igual que una serie de cambios pequenos.
+ */
+class RampSet {
+public:
+	void Start(const AppEvent& ev, int window);
+	// Aplica un paso de cada rampa y quita las que terminan.
+	void Step(EventTarget& target);
+	void Clear() { ramps.clear(); }
+	bool Active() const { return !ramps.empty(); }
+
+private:
+	struct Ramp {
+		int window;
+		char label;
+		double delta;
+		unsigned long long remaining;
+	};
+	std::vector<Ramp> ramps;
+};
+
+#endif // RELATIPOS_H_INCLUDED
@@ -0,0 +1,152 @@
+#include <yaml-cpp/yaml.h>
+#include "RelaYaml.h"
+
+// Conversiones de escalares: las de YAML::convert<T>::decode sobre el texto,
+// sin construir nodos; aceptan exactamente lo mismo que Node::as<T>().
+bool LeerEscalar(const std::string& text, double& value)
+{
+	return YAML::conversion::DecodeScalar(text, value);
+}
+
+bool LeerEscalar(const std::string& text, int& value)
+{
+	return YAML::conversion::DecodeScalar(text, value);
+}
+
+bool LeerEscalar(const std::string& text, bool& value)
+{
+	return YAML::conversion::DecodeScalar(text, value);
+}
+
+bool LeerEscalar(const std::string& text, std::string& value)
+{
+	value = text;
+	return true;
+}
+
+const std::string& YamlLectura::Texto(int campo) const
+{
+	static const std::string empty;
+	for (size_t i = 0; i < textos.size(); i++) {
+		if (textos[i].campo == campo) {
+			return textos[i].texto;
+		}
+	}
+	return empty;
+}
+
+void YamlLectura::Anotar(int campo, const YAML::Mark& valueMark, bool ok, const std::string& text)
+{
+	presentes |= YamlBit(campo);
+	marks[campo] = valueMark;
+	// Con claves repetidas vale la ultima.
+	if (Erroneo(campo)) {
+		for (size_t i = 0; i < textos.size(); i++) {
+			if (textos[i].campo == campo) {
+				textos.erase(textos.begin() + i);
+				break;
+			}
+		}
+	}
+	if (ok) {
+		erroneos &= ~YamlBit(campo);
+	} else {
+		erroneos |= YamlBit(campo);
+		YamlTextoErroneo erroneo = { campo, text };
+		textos.push_back(erroneo);
+	}
+}
+
+const std::string* YamlAnclas::Buscar(YAML::anchor_t anchor) const
+{
+	std::map<YAML::anchor_t, std::string>::const_iterator it = valores.find(anchor);
+	return it != valores.end() ? &it->second : NULL;
+}
+
+bool YamlAnclas::Repetir(YAML::anchor_t anchor, YAML::EventHandler& handler) const
+{
+	std::map<YAML::anchor_t, std::vector<YamlEvento> >::const_iterator it = colecciones.find(anchor);
+	if (it == colecciones.end()) {
+		return false;
+	}
+	// El handler puede volver a llamar a Grabar(), que no toca esta lista.
+	const std::vector<YamlEvento>& eventos = it->second;
+	for (size_t i = 0; i < eventos.size(); i++) {
+		const YamlEvento& e = eventos[i];
+		switch (e.tipo) {
+		case YamlEvento::kNulo: handler.OnNull(e.mark, YAML::NullAnchor); break;
+		case YamlEvento::kEscalar: handler.OnScalar(e.mark, e.tag, YAML::NullAnchor, e.valor); break;
+		case YamlEvento::kInicioLista: handler.OnSequenceStart(e.mark, e.tag, YAML::NullAnchor, e.estilo); break;
+		case YamlEvento::kFinLista: handler.OnSequenceEnd(); break;
+		case YamlEvento::kInicioMapa: handler.OnMapStart(e.mark, e.tag, YAML::NullAnchor, e.estilo); break;
+		case YamlEvento::kFinMapa: handler.OnMapEnd(); break;
+		}
+	}
+	return true;
+}
+
+void YamlAnclas::OnNull(const YAML::Mark& mark, YAML::anchor_t anchor)
+{
+	if (anchor != YAML::NullAnchor) {
+		valores[anchor].clear();
+	}
+	Grabar(YamlEvento::kNulo, mark, std::string(), anchor, std::string(), YAML::EmitterStyle::Default);
+}
+
+void YamlAnclas::OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+	const std::string& value)
+{
+	if (anchor != YAML::NullAnchor) {
+		valores[anchor] = value;
+	}
+	Grabar(YamlEvento::kEscalar, mark, tag, anchor, value, YAML::EmitterStyle::Default);
+}
+
+void YamlAnclas::OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+	YAML::EmitterStyle::value style)
+{
+	Grabar(YamlEvento::kInicioLista, mark, tag, anchor, std::string(), style);
+}
+
+void YamlAnclas::OnSequenceEnd()
+{
+	Grabar(YamlEvento::kFinLista, YAML::Mark(), std::string(), YAML::NullAnchor, std::string(),
+		YAML::EmitterStyle::Default);
+}
+
+void YamlAnclas::OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+	YAML::EmitterStyle::value style)
+{
+	Grabar(YamlEvento::kInicioMapa, mark, tag, anchor, std::string(), style);
+}
+
+void YamlAnclas::OnMapEnd()
+{
+	Grabar(YamlEvento::kFinMapa, YAML::Mark(), std::string(), YAML::NullAnchor, std::string(),
+		YAML::EmitterStyle::Default);
+}
+
+// Sin grabaciones abiertas solo cuesta la comprobacion del ancla.
+void YamlAnclas::Grabar(YamlEvento::Tipo tipo, const YAML::Mark& mark, const std::string& tag,
+	YAML::anchor_t anchor, const std::string& valor, YAML::EmitterStyle::value estilo)
+{
+	bool inicio = tipo == YamlEvento::kInicioLista || tipo == YamlEvento::kInicioMapa;
+	bool fin = tipo == YamlEvento::kFinLista || tipo == YamlEvento::kFinMapa;
+	if (inicio && anchor != YAML::NullAnchor) {
+		grabando.push_back(Grabacion());
+		grabando.back().anchor = anchor;
+		grabando.back().depth = 0;
+	}
+	if (grabando.empty()) {
+		return;
+	}
+	YamlEvento evento = { tipo, mark, tag, valor, estilo };
+	for (size_t i = 0; i < grabando.size(); i++) {
+		grabando[i].eventos.push_back(evento);
+		grabando[i].depth += inicio ? 1 : (fin ? -1 : 0);
+	}
+	while (!grabando.empty() && grabando.back().depth == 0) {
+		colecciones[grabando.back().anchor].swap(grabando.back().eventos);
+		grabando.pop_back();
+	}
+}
@@ -0,0 +1,501 @@
+#ifndef RELAYAML_H_INCLUDED
+#define RELAYAML_H_INCLUDED
+
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/mark.h>
+
+/*
+ * Lectura de YAML directamente a estructuras del programa.
+ *
+ * Cada registro declara sus campos una sola vez, en una tabla de YamlCampo
+ * (nombre, miembro y si es obligatorio):
+ *
+ *   struct Punto { double x; double y; std::string nombre; YamlLectura yaml; };
+ *   static const YamlCampo<Punto> kCamposPunto[] = {
+ *       YAML_CAMPO(Punto, x, true), YAML_CAMPO(Punto, y, true),
+ *       YAML_CAMPO(Punto, nombre, false) };
+ *
+ * y YamlRegistro<Punto> rellena un Punto con los eventos del parser de un
+ * mapa, o YamlLista<Punto> un std::vector<Punto> con los de una lista de
+ * mapas, en una pasada, sin construir YAML::Node.  Cada clave se busca en
+ * una tabla de dispersion hecha con la de campos y cada valor se convierte
+ * al llegar; el registro guarda en 'yaml' donde estaba cada campo y cuales
+ * faltan o no se pudieron convertir, para que quien lo lea decida que es
+ * un error (o esta fuera de rango) y lo anote con su linea y columna.
+ */
+
+const int kYamlMaxCampos = 16;
+
+inline uint32_t YamlBit(int campo)
+{
+	return 1u << campo;
+}
+
+// Conversiones de escalares; false si el texto no vale (el valor queda sin
+// especificar).  Aceptan lo mismo que Node::as<T>().
+bool LeerEscalar(const std::string& text, double& value);
+bool LeerEscalar(const std::string& text, int& value);
+bool LeerEscalar(const std::string& text, bool& value);
+bool LeerEscalar(const std::string& text, std::string& value);
+
+struct YamlTextoErroneo {
+	int campo;
+	std::string texto;
+};
+
+// Lo que se sabe de un registro leido.  Los bits son YamlBit(i) del campo
+// i de la tabla.
+struct YamlLectura {
+	YAML::Mark mark;                    // el mapa del registro
+	uint32_t presentes;                 // campos que aparecen (aunque no valgan)
+	uint32_t erroneos;                  // presentes que no se pudieron convertir
+	uint32_t faltan;                    // obligatorios que no aparecen
+	YAML::Mark marks[kYamlMaxCampos];   // el valor de cada campo presente
+	std::vector<YamlTextoErroneo> textos;  // el texto de los erroneos
+
+	YamlLectura() : presentes(0), erroneos(0), faltan(0) {}
+
+	bool Tiene(int campo) const { return (presentes & YamlBit(campo)) != 0; }
+	bool Erroneo(int campo) const { return (erroneos & YamlBit(campo)) != 0; }
+
+	// Texto de un campo erroneo; vacio si el campo vale.
+	const std::string& Texto(int campo) const;
+
+	void Anotar(int campo, const YAML::Mark& valueMark, bool ok, const std::string& text);
+};
+
+// Un evento del parser guardado para repetirlo.
+struct YamlEvento {
+	enum Tipo { kNulo, kEscalar, kInicioLista, kFinLista, kInicioMapa, kFinMapa };
+
+	Tipo tipo;
+	YAML::Mark mark;
+	std::string tag;
+	std::string valor;
+	YAML::EmitterStyle::value estilo;
+};
+
+/*
+ * Nodos con ancla, para sustituir sus alias: de los escalares se guarda el
+ * valor y de las colecciones sus eventos, que Repetir() vuelve a dar (sin
+ * anclas y con los alias de dentro ya sustituidos).  Hay que pasarle cada
+ * evento del documento; los de los alias, despues de sustituirlos.
+ */
+class YamlAnclas : public YAML::EventHandler {
+public:
+	// Valor del escalar con esa ancla; NULL si el ancla es de una coleccion.
+	const std::string* Buscar(YAML::anchor_t anchor) const;
+
+	// Da a 'handler' los eventos de la coleccion con esa ancla; false si no
+	// hay ninguna cerrada (un alias dentro de su propia coleccion).
+	bool Repetir(YAML::anchor_t anchor, YAML::EventHandler& handler) const;
+
+	void OnDocumentStart(const YAML::Mark&) override {}
+	void OnDocumentEnd() override {}
+	void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override;
+	void OnAlias(const YAML::Mark&, YAML::anchor_t) override {}
+	void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		const std::string& value) override;
+	void OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		YAML::EmitterStyle::value style) override;
+	void OnSequenceEnd() override;
+	void OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		YAML::EmitterStyle::value style) override;
+	void OnMapEnd() override;
+
+private:
+	// Una coleccion con ancla que todavia no se ha cerrado.
+	struct Grabacion {
+		YAML::anchor_t anchor;
+		int depth;
+		std::vector<YamlEvento> eventos;
+	};
+
+	void Grabar(YamlEvento::Tipo tipo, const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		const std::string& valor, YAML::EmitterStyle::value estilo);
+
+	std::map<YAML::anchor_t, std::string> valores;
+	std::map<YAML::anchor_t, std::vector<YamlEvento> > colecciones;
+	std::vector<Grabacion> grabando;  // las de dentro al final
+};
+
+// Nombres de campo por dispersion con direccionamiento abierto.  Cada clave
+// del YAML cuesta un hash y, si acierta, una comparacion.
+class YamlClaves {
+public:
+	YamlClaves() : count(0) { memset(slots, 0, sizeof(slots)); }
+
+	// El nombre tiene que durar lo que la tabla; su indice es el orden de alta.
+	void Anadir(const char* name)
+	{
+		size_t length = strlen(name);
+		uint32_t i = Hash(name, length) & kMascara;
+		while (slots[i] != 0) {
+			i = (i + 1) & kMascara;
+		}
+		nombres[count] = name;
+		longitudes[count] = length;
+		slots[i] = (uint8_t)++count;
+	}
+
+	// Indice del nombre, o -1.
+	int Buscar(const std::string& name) const
+	{
+		for (uint32_t i = Hash(name.data(), name.size()) & kMascara; slots[i] != 0; i = (i + 1) & kMascara) {
+			int campo = slots[i] - 1;
+			if (longitudes[campo] == name.size() && memcmp(nombres[campo], name.data(), name.size()) == 0) {
+				return campo;
+			}
+		}
+		return -1;
+	}
+
+private:
+	static const uint32_t kSlots = 2 * kYamlMaxCampos;
+	static const uint32_t kMascara = kSlots - 1;
+
+	// FNV-1a
+	static uint32_t Hash(const char* text, size_t length)
+	{
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < length; i++) {
+			hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+		}
+		return hash;
+	}
+
+	const char* nombres[kYamlMaxCampos];
+	size_t longitudes[kYamlMaxCampos];
+	uint8_t slots[kSlots];  // indice + 1, 0 si esta libre
+	int count;
+};
+
+template <typename T>
+struct YamlCampo {
+	const char* name;
+	bool (*leer)(const std::string& text, T& registro);
+	bool obligatorio;
+};
+
+template <typename T, typename M, M T::*member>
+bool LeerMiembro(const std::string& text, T& registro)
+{
+	return LeerEscalar(text, registro.*member);
+}
+
+// Entrada de una tabla de campos; el nombre en el YAML es el del miembro.
+#define YAML_CAMPO(T, member, obligatorio) \
+	{ #member, &LeerMiembro<T, decltype(T::member), &T::member>, obligatorio }
+
+/*
+ * Lee un mapa en un registro T, que tiene que tener un YamlLectura llamado
+ * 'yaml'.  Las claves que no estan en la tabla y los valores que son
+ * colecciones se saltan; un alias vale lo que el nodo con su ancla.
+ *
+ * Empezar() dice en que registro (con sus valores por defecto ya puestos)
+ * dejar el siguiente mapa; a partir de su inicio se le reenvian los eventos
+ * hasta que Terminado().
+ */
+template <typename T>
+class YamlRegistro : public YAML::EventHandler {
+public:
+	template <int N>
+	explicit YamlRegistro(const YamlCampo<T> (&campos)[N])
+		: campos(campos), obligatorios(0), registro(NULL), depth(0), skipDepth(0), campo(-1),
+		  expectKey(true), skippingKey(false), terminado(false)
+	{
+		static_assert(N <= kYamlMaxCampos, "demasiados campos para YamlLectura");
+		for (int i = 0; i < N; i++) {
+			claves.Anadir(campos[i].name);
+			if (campos[i].obligatorio) {
+				obligatorios |= YamlBit(i);
+			}
+		}
+	}
+
+	void Empezar(T& destino)
+	{
+		registro = &destino;
+		depth = 0;
+		skipDepth = 0;
+		campo = -1;
+		expectKey = true;
+		skippingKey = false;
+		terminado = false;
+	}
+
+	bool Terminado() const { return terminado; }
+
+	// Indice del campo en la tabla, o -1.
+	int Buscar(const std::string& name) const { return claves.Buscar(name); }
+
+	// Si el siguiente nodo se usa: el valor de un campo de la tabla.
+	bool ValorUtil() const { return skipDepth == 0 && depth == 1 && !expectKey && campo >= 0; }
+
+	void OnDocumentStart(const YAML::Mark&) override {}
+	void OnDocumentEnd() override {}
+
+	void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override
+	{
+		anclas.OnNull(mark, anchor);
+		OnValor(mark, std::string());
+	}
+	void OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override
+	{
+		const std::string* value = anclas.Buscar(anchor);
+		if (value != NULL) {
+			OnScalar(mark, std::string(), YAML::NullAnchor, *value);
+		} else if (!anclas.Repetir(anchor, *this) && depth > 0) {
+			OnColeccion(mark, false);
+			OnFin();
+		}
+	}
+	void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		const std::string& value) override
+	{
+		anclas.OnScalar(mark, tag, anchor, value);
+		OnValor(mark, value);
+	}
+
+	void OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		YAML::EmitterStyle::value style) override
+	{
+		anclas.OnSequenceStart(mark, tag, anchor, style);
+		OnColeccion(mark, false);
+	}
+	void OnSequenceEnd() override
+	{
+		anclas.OnSequenceEnd();
+		OnFin();
+	}
+
+	void OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		YAML::EmitterStyle::value style) override
+	{
+		anclas.OnMapStart(mark, tag, anchor, style);
+		OnColeccion(mark, true);
+	}
+	void OnMapEnd() override
+	{
+		anclas.OnMapEnd();
+		OnFin();
+	}
+
+private:
+	// depth: 0 antes del mapa, 1 en el mapa.
+	void OnColeccion(const YAML::Mark& mark, bool isMap)
+	{
+		if (skipDepth > 0) {
+			skipDepth++;
+			return;
+		}
+		if (depth == 0 && isMap && registro != NULL && !terminado) {
+			registro->yaml.mark = mark;
+			depth = 1;
+			expectKey = true;
+			return;
+		}
+		skipDepth = 1;
+		skippingKey = (depth == 1 && expectKey);
+	}
+
+	void OnFin()
+	{
+		if (skipDepth > 0) {
+			if (--skipDepth == 0 && depth == 1) {
+				// Una clave compleja saltada deja su valor sin campo.
+				if (skippingKey) {
+					campo = -1;
+				}
+				expectKey = !skippingKey;
+			}
+			return;
+		}
+		if (depth == 1) {
+			YamlLectura& yaml = registro->yaml;
+			yaml.faltan = obligatorios & ~yaml.presentes;
+			depth = 0;
+			terminado = true;
+		}
+	}
+
+	void OnValor(const YAML::Mark& mark, const std::string& text)
+	{
+		if (skipDepth > 0 || depth != 1) {
+			return;
+		}
+		if (expectKey) {
+			campo = claves.Buscar(text);
+			expectKey = false;
+			return;
+		}
+		expectKey = true;
+		if (campo >= 0) {
+			registro->yaml.Anotar(campo, mark, campos[campo].leer(text, *registro), text);
+		}
+	}
+
+	const YamlCampo<T>* campos;
+	YamlClaves claves;
+	YamlAnclas anclas;
+	uint32_t obligatorios;
+	T* registro;
+	int depth;
+	int skipDepth;
+	int campo;
+	bool expectKey;
+	bool skippingKey;
+	bool terminado;
+};
+
+/*
+ * Lee una secuencia de mapas en 'out', un registro por mapa (con
+ * YamlRegistro).  Los elementos que no son mapas se saltan.  Un alias vale
+ * lo que el nodo con su ancla; si no se puede sustituir (esta dentro de su
+ * propia coleccion) se salta, y ValorUtil() dice si se iba a usar.
+ *
+ * Se puede pasar como manejador al parser (el documento es la lista) o
+ * reenviarle los eventos desde otro manejador a partir del inicio de la
+ * secuencia; Terminada() dice cuando se ha cerrado.
+ */
+template <typename T>
+class YamlLista : public YAML::EventHandler {
+public:
+	template <int N>
+	YamlLista(const YamlCampo<T> (&campos)[N], std::vector<T>& out)
+		: registro(campos), out(out), depth(0), skipDepth(0), terminada(false) {}
+
+	bool Terminada() const { return terminada; }
+
+	// Indice del campo en la tabla, o -1.
+	int Buscar(const std::string& name) const { return registro.Buscar(name); }
+
+	// Si el siguiente nodo se usa: un elemento de la lista o el valor de un
+	// campo de la tabla.
+	bool ValorUtil() const
+	{
+		return skipDepth == 0 && (depth == 1 || (depth == 2 && registro.ValorUtil()));
+	}
+
+	void OnDocumentStart(const YAML::Mark&) override {}
+	void OnDocumentEnd() override {}
+
+	void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override
+	{
+		anclas.OnNull(mark, anchor);
+		if (EnRegistro()) {
+			registro.OnNull(mark, YAML::NullAnchor);
+		}
+	}
+	void OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override
+	{
+		const std::string* value = anclas.Buscar(anchor);
+		if (value != NULL) {
+			OnScalar(mark, std::string(), YAML::NullAnchor, *value);
+		} else if (!anclas.Repetir(anchor, *this) && EnRegistro()) {
+			registro.OnAlias(mark, anchor);
+		}
+	}
+	void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		const std::string& value) override
+	{
+		anclas.OnScalar(mark, tag, anchor, value);
+		if (EnRegistro()) {
+			registro.OnScalar(mark, tag, YAML::NullAnchor, value);
+		}
+	}
+
+	void OnSequenceStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		YAML::EmitterStyle::value style) override
+	{
+		anclas.OnSequenceStart(mark, tag, anchor, style);
+		if (EnRegistro()) {
+			registro.OnSequenceStart(mark, tag, YAML::NullAnchor, style);
+		} else {
+			OnColeccion(false);
+		}
+	}
+	void OnSequenceEnd() override
+	{
+		anclas.OnSequenceEnd();
+		if (EnRegistro()) {
+			registro.OnSequenceEnd();
+		} else {
+			OnFin();
+		}
+	}
+
+	void OnMapStart(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+		YAML::EmitterStyle::value style) override
+	{
+		anclas.OnMapStart(mark, tag, anchor, style);
+		if (EnRegistro()) {
+			registro.OnMapStart(mark, tag, YAML::NullAnchor, style);
+			return;
+		}
+		if (skipDepth == 0 && depth == 1) {
+			out.push_back(T());
+			registro.Empezar(out.back());
+			registro.OnMapStart(mark, tag, YAML::NullAnchor, style);
+			depth = 2;
+			return;
+		}
+		OnColeccion(true);
+	}
+	void OnMapEnd() override
+	{
+		anclas.OnMapEnd();
+		if (!EnRegistro()) {
+			OnFin();
+			return;
+		}
+		registro.OnMapEnd();
+		if (registro.Terminado()) {
+			depth = 1;
+		}
+	}
+
+private:
+	// depth: 0 fuera de la lista, 1 en la lista, 2 en un registro.
+	bool EnRegistro() const { return depth == 2; }
+
+	void OnColeccion(bool isMap)
+	{
+		if (skipDepth > 0) {
+			skipDepth++;
+			return;
+		}
+		if (depth == 0 && !isMap) {
+			depth = 1;
+			terminada = false;
+			return;
+		}
+		skipDepth = 1;
+	}
+
+	void OnFin()
+	{
+		if (skipDepth > 0) {
+			skipDepth--;
+			return;
+		}
+		if (depth == 1) {
+			depth = 0;
+			terminada = true;
+		}
+	}
+
+	YamlRegistro<T> registro;
+	YamlAnclas anclas;
+	std::vector<T>& out;
+	int depth;
+	int skipDepth;
+	bool terminada;
+};
+
+#endif // RELAYAML_H_INCLUDED
@@ -0,0 +1,286 @@
+/*
+ * Comprobacion y medida de las aceleraciones.
+ *
+ *   - AcceleratedClock (modelo de dilatacion) contra RK4 con pasos finos, y
+ *     AccelerationSet con pasos de 0.5 s contra pasos de kStepTime.
+ *   - LorentzSystem con N particulas que aceleran y cambian de velocidad:
+ *     en el marco de laboratorio contra RK4 de (u, x, tau) y en los demas
+ *     marcos contra una biseccion sobre la linea de universo.
+ *
+ * Las dos implementaciones usan formulas cerradas, asi que el error no
+ * depende del paso.  Devuelve 1 si falla alguna comprobacion.
+ *
+ *   aceleracion_bench [--particles N] [--steps N]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "RelaAceleracion.h"
+#include "RelaLorentz.h"
+#include "RelaModelo.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// Ritmo del reloj en el modelo de dilatacion en funcion de la celeridad.
+static double RateFromCelerity(double u)
+{
+	return 1.0 / FactorFromVelocity(VelocityFromCelerity(u));
+}
+
+// RK4 de d(clock)/dt = ritmo(u), du/dt = a, en subtramos que terminan
+// justo donde acaba la aceleracion o se llega al limite.
+static double ReferenceClock(double v, double a, double accelTime, double dt, double h)
+{
+	double limit = CelerityFromVelocity(kVelocityLimit);
+	double u = CelerityFromVelocity(v);
+	double end = (accelTime < dt) ? accelTime : dt;
+	double saturation = ((a > 0.0 ? limit : -limit) - u) / a;
+	if (saturation < end) {
+		end = saturation > 0.0 ? saturation : 0.0;
+	}
+	double clock = 0.0;
+	double t = 0.0;
+	while (t < end) {
+		double step = (end - t < h) ? end - t : h;
+		double k1 = RateFromCelerity(u);
+		double k2 = RateFromCelerity(u + 0.5 * step * a);
+		double k4 = RateFromCelerity(u + step * a);
+		clock += step * (k1 + 4.0 * k2 + k4) / 6.0;
+		u += step * a;
+		t += step;
+	}
+	if (end < accelTime && end < dt) {
+		u = (a > 0.0) ? limit : -limit;
+	}
+	return clock + (dt - t) * RateFromCelerity(u);
+}
+
+struct ReferenceParticle {
+	double u;
+	double x;
+	double tau;
+	double a;
+	int remaining;   // pasos de aceleracion que quedan
+};
+
+// Un paso de RK4 de dx/dt = u / gamma, dtau/dt = 1 / gamma, du/dt = a.
+static void ReferenceStep(ReferenceParticle& p, double a, double h)
+{
+	double u[3] = { p.u, p.u + 0.5 * h * a, p.u + h * a };
+	double dx[3], dtau[3];
+	for (int k = 0; k < 3; k++) {
+		double g = sqrt(1.0 + u[k] * u[k]);
+		dx[k] = u[k] / g;
+		dtau[k] = 1.0 / g;
+	}
+	p.x += h * (dx[0] + 4.0 * dx[1] + dx[2]) / 6.0;
+	p.tau += h * (dtau[0] + 4.0 * dtau[1] + dtau[2]) / 6.0;
+	p.u = u[2];
+}
+
+// Suceso de la linea de universo con gamma * (t - frame * x) = frameTime,
+// buscado por biseccion en [0, now].  false si no cae en ese rango.
+static bool BisectionPoint(const std::vector<WorldSegment>& segs, double now, double frame, double frameTime,
+	double& tau, double& x, double& t)
+{
+	double s = frameTime * sqrt(1.0 - frame * frame);
+	auto at = [&](double time, double& xOut, double& tauOut) {
+		size_t k = 0;
+		while (k + 1 < segs.size() && segs[k + 1].t <= time) {
+			k++;
+		}
+		double v;
+		WorldlinePoint(segs[k], time, xOut, tauOut, v);
+	};
+	double lo = 0.0;
+	double hi = now;
+	double xLo, tauLo, xHi, tauHi;
+	at(lo, xLo, tauLo);
+	at(hi, xHi, tauHi);
+	if (lo - frame * xLo > s || hi - frame * xHi < s) {
+		return false;
+	}
+	for (int it = 0; it < 200 && hi - lo > 1.0e-14; it++) {
+		double mid = 0.5 * (lo + hi);
+		double xm, taum;
+		at(mid, xm, taum);
+		if (mid - frame * xm <= s) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+	t = 0.5 * (lo + hi);
+	at(t, x, tau);
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t particles = 500;
+	int steps = 3000;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		if (arg == "--particles") {
+			particles = (size_t)atoll(argv[i + 1]);
+		} else if (arg == "--steps") {
+			steps = atoi(argv[i + 1]);
+		} else {
+			fprintf(stderr, "Opcion desconocida %s\n", argv[i]);
+			return 1;
+		}
+	}
+	if (particles < 1) {
+		particles = 1;
+	}
+	long long failures = 0;
+	std::mt19937 rng(11);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+	// Modelo de dilatacion: un paso grande contra RK4.
+	double clockError = 0.0;
+	for (int k = 0; k < 2000; k++) {
+		double v = unit(rng) * 1.9 - 0.95;
+		double a = (unit(rng) < 0.5 ? -1.0 : 1.0) * (0.05 + unit(rng) * 2.0);
+		double accelTime = unit(rng) * 3.0;
+		double dt = 2.0;
+		double velocity;
+		double got = AcceleratedClock(v, a, accelTime, dt, velocity);
+		double want = ReferenceClock(v, a, accelTime, dt, 1.0e-4);
+		double e = fabs(got - want);
+		if (e > clockError) {
+			clockError = e;
+		}
+	}
+	if (clockError > 1.0e-9) {
+		failures++;
+	}
+
+	// Los mismos 5 s con pasos de 0.5 y de kStepTime.
+	double stepError = 0.0;
+	for (int k = 0; k < 200; k++) {
+		double v0 = unit(rng) * 1.9 - 0.95;
+		double a = (unit(rng) < 0.5 ? -1.0 : 1.0) * (0.05 + unit(rng) * 1.0);
+		double duration = 0.5 * (1 + (int)(unit(rng) * 8));
+		double coarse[2] = { 0.0, v0 };
+		double fine[2] = { 0.0, v0 };
+		bool moved[1];
+		AccelerationSet set;
+		set.Start(0, a, duration);
+		for (int s = 0; s < 10; s++) {
+			set.Advance(0.5, &coarse[0], &coarse[1], moved);
+		}
+		set.Start(0, a, duration);
+		for (int s = 0; s < 500; s++) {
+			set.Advance(kStepTime, &fine[0], &fine[1], moved);
+		}
+		double e = fabs(coarse[0] - fine[0]) + fabs(coarse[1] - fine[1]);
+		if (e > stepError) {
+			stepError = e;
+		}
+	}
+	if (stepError > 1.0e-9) {
+		failures++;
+	}
+
+	// Modelo lorentz.
+	const double dt = kStepTime;
+	const double frames[2] = { 0.5, -0.8 };
+	std::uniform_int_distribution<size_t> particleDist(0, particles - 1);
+	std::vector<double> x0(particles);
+	std::vector<ReferenceParticle> reference(particles);
+	for (size_t i = 0; i < particles; i++) {
+		x0[i] = (double)i - (double)particles / 2;
+		ReferenceParticle p = { 0.0, x0[i], 0.0, 0.0, 0 };
+		reference[i] = p;
+	}
+	LorentzSystem system;
+	system.Reset(particles, x0.data());
+
+	std::vector<double> tau(particles), x(particles), velocity(particles);
+	double labError = 0.0;
+	double frameError = 0.0;
+	long long frameChecks = 0;
+	double simSeconds = 0.0;
+	for (int step = 0; step < steps; step++) {
+		for (int k = 0; k < 4; k++) {
+			size_t i = particleDist(rng);
+			if (unit(rng) < 0.7) {
+				double a = unit(rng) - 0.5;
+				int n = 1 + (int)(unit(rng) * 200);
+				system.Accelerate(i, a, n * dt);
+				reference[i].a = a;
+				reference[i].remaining = n;
+			} else {
+				double v = unit(rng) * 1.8 - 0.9;
+				system.SetVelocity(i, v);
+				reference[i].u = CelerityFromVelocity(v);
+			}
+		}
+
+		Clock::time_point t0 = Clock::now();
+		system.Advance(dt);
+		system.View(0.0, system.Time(), tau.data(), x.data(), velocity.data());
+		simSeconds += std::chrono::duration<double>(Clock::now() - t0).count();
+
+		for (size_t i = 0; i < particles; i++) {
+			ReferenceParticle& p = reference[i];
+			double a = (p.remaining > 0) ? p.a : 0.0;
+			for (int sub = 0; sub < 4; sub++) {
+				ReferenceStep(p, a, dt / 4);
+			}
+			if (p.remaining > 0) {
+				p.remaining--;
+			}
+		}
+
+		if (step % 50 != 0 && step != steps - 1) {
+			continue;
+		}
+		for (size_t i = 0; i < particles; i++) {
+			const ReferenceParticle& p = reference[i];
+			double e = fabs(tau[i] - p.tau) + fabs(x[i] - p.x) + fabs(velocity[i] - VelocityFromCelerity(p.u));
+			if (e > labError) {
+				labError = e;
+			}
+		}
+		for (int f = 0; f < 2; f++) {
+			double frame = frames[f];
+			double gamma = 1.0 / sqrt(1.0 - frame * frame);
+			double frameTime = system.Time() * gamma * 0.75;
+			system.View(frame, frameTime, tau.data(), x.data(), velocity.data());
+			for (size_t i = 0; i < particles; i++) {
+				double tauE, xE, tE;
+				if (!BisectionPoint(system.Segments(i), system.Time(), frame, frameTime, tauE, xE, tE)) {
+					continue;
+				}
+				double e = fabs(tau[i] - tauE) + fabs(x[i] - gamma * (xE - frame * tE));
+				if (e > frameError) {
+					frameError = e;
+				}
+				frameChecks++;
+			}
+		}
+	}
+	// RK4 con h = dt / 4 y redondeo acumulado en miles de pasos.
+	if (labError > 1.0e-8) {
+		failures++;
+	}
+	if (frameError > 1.0e-8 || frameChecks == 0) {
+		failures++;
+	}
+
+	printf("{\n  \"benchmark\": \"aceleracion\",\n  \"particles\": %llu,\n  \"steps\": %d,\n",
+		(unsigned long long)particles, steps);
+	printf("  \"dilatacion_clock_max_error\": %.3g,\n  \"dilatacion_step_max_error\": %.3g,\n", clockError,
+		stepError);
+	printf("  \"lab_max_error\": %.3g,\n  \"frame_max_error\": %.3g,\n  \"frame_checks\": %lld,\n", labError,
+		frameError, frameChecks);
+	printf("  \"steps_per_second\": %.0f,\n  \"failures\": %lld\n}\n", (double)steps / simSeconds, failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,382 @@
+/*
+ * Motor analitico frente al bucle por pasos.
+ *
+ * Genera escenarios aleatorios, los simula paso a paso igual que
+ * StepSimulation (EventIndex y suma de kStepTime / factor en cada paso) y
+ * con AnalyticEngine en modo kPorPasos, y compara en que paso se dispara
+ * cada evento y los relojes al final.  Imprime los tiempos medios por
+ * escenario como JSON.
+ *
+ * Despues repite la comparacion con escenarios que mezclan todos los tipos
+ * del registro (rampas, periodicos, disparos por intervalo), despachados
+ * con DispatchEvent en los dos lados, durante un numero fijo de pasos.
+ *
+ *   analytic_bench [--scenarios N] [--events N] [--horizon T]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "RelaAnalitico.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static std::vector<AppEvent> MakeScenario(int count, double horizon, std::mt19937_64& rng)
+{
+	std::uniform_real_distribution<double> time(0.0, horizon);
+	std::uniform_real_distribution<double> amount(-0.3, 0.3);
+	std::uniform_int_distribution<int> column(0, kIndexColumns - 1);
+	std::uniform_int_distribution<int> kind(0, 9);
+	std::vector<AppEvent> events(count);
+	for (int i = 0; i < count; i++) {
+		AppEvent& ev = events[i];
+		memset(&ev, 0, sizeof(ev));
+		ev.type = (kind(rng) == 0) ? kEventoPausa : kEventoCambio;
+		ev.column = (uint8_t)column(rng);
+		ev.time = time(rng);
+		ev.amount = amount(rng);
+	}
+	return events;
+}
+
+// Copia del bucle de StepSimulation sin ventanas ni telemetria; las pausas
+// se reanudan solas.
+static void RunStepped(const std::vector<AppEvent>& events, std::vector<unsigned long long>& triggerStep,
+	AnalyticState& state)
+{
+	EventIndex index(kWindowCount);
+	index.Build(events.data(), events.size());
+	int keyColumn[kWindowCount * kIndexColumns];
+	for (int w = 0; w < kWindowCount; w++) {
+		for (int c = 0; c < kIndexColumns; c++) {
+			keyColumn[w * kIndexColumns + c] = GetIndexForLabelInWindow(w, (char)('A' + c));
+		}
+	}
+	double Times[kTotalColumns];
+	double Velocidades[kTotalColumns];
+	double Factors[kTotalColumns];
+	for (int i = 0; i < kTotalColumns; i++) {
+		Times[i] = 0.0;
+		Velocidades[i] = 0.0;
+		Factors[i] = 1.0;
+	}
+	std::vector<EventoDisparado> fired;
+	double columnTimes[kWindowCount * kIndexColumns];
+	unsigned long long step = 0;
+	for (;;) {
+		for (int k = 0; k < kWindowCount * kIndexColumns; k++) {
+			columnTimes[k] = Times[keyColumn[k]];
+		}
+		fired.clear();
+		index.Collect(columnTimes, fired);
+		for (size_t d = 0; d < fired.size(); d++) {
+			const AppEvent& ev = events[fired[d].event];
+			int w = fired[d].window;
+			triggerStep[fired[d].event * kWindowCount + w] = step;
+			int idx = GetIndexForLabelInWindow(w, ColumnLabel(ev.column));
+			if (ev.type == kEventoCambio && idx >= 0) {
+				Velocidades[idx] = ClampVelocity(Velocidades[idx] + ((w == 0) ? ev.amount : -ev.amount));
+				Factors[idx] = FactorFromVelocity(Velocidades[idx]);
+			}
+		}
+		bool pending = false;
+		double head;
+		for (int k = 0; k < index.KeyCount() && !pending; k++) {
+			pending = index.Peek(k, head);
+		}
+		if (!pending) {
+			break;
+		}
+		for (int i = 0; i < kTotalColumns; i++) {
+			Times[i] += kStepTime * (1 / Factors[i]);
+		}
+		step++;
+	}
+	for (int i = 0; i < kTotalColumns; i++) {
+		state.clock[i] = Times[i];
+		state.velocity[i] = Velocidades[i];
+		state.factor[i] = Factors[i];
+	}
+	state.step = step;
+	state.elapsed = step * kStepTime;
+}
+
+static std::vector<AppEvent> MakeMixedScenario(int count, double horizon, std::mt19937_64& rng)
+{
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::uniform_int_distribution<int> type(0, kEventTypeCount - 1);
+	std::uniform_int_distribution<int> column(0, kIndexColumns - 1);
+	std::uniform_int_distribution<int> small(0, 4);
+	std::vector<AppEvent> events(count);
+	for (int i = 0; i < count; i++) {
+		AppEvent& ev = events[i];
+		memset(&ev, 0, sizeof(ev));
+		ev.type = (uint8_t)type(rng);
+		ev.column = (uint8_t)column(rng);
+		ev.amount = (ev.type == kEventoFijar) ? unit(rng) * 1.2 - 0.6 : unit(rng) * 0.6 - 0.3;
+		ev.duration = 0.05 + unit(rng) * 3.0;
+		if (unit(rng) < 0.2) {
+			ev.trigger = kDisparoIntervalo;
+			ev.interval = (uint8_t)(small(rng) % 3);
+			ev.direction = (uint8_t)(small(rng) % 2);
+			ev.time = unit(rng) * 4.0 - 2.0;
+			continue;
+		}
+		ev.time = unit(rng) * horizon;
+		if (unit(rng) < 0.1) {
+			ev.period = 0.5 + unit(rng) * 5.0;
+			ev.repeats = (uint16_t)small(rng);
+		}
+	}
+	return events;
+}
+
+struct Disparo {
+	unsigned long long step;
+	uint32_t event;
+	int window;
+
+	bool operator==(const Disparo& o) const
+	{
+		return step == o.step && event == o.event && window == o.window;
+	}
+};
+
+// Lo que hace StepSimulation con el modelo de dilatacion, sin ventanas.
+class SteppedTarget : public EventTarget {
+public:
+	SteppedTarget()
+	{
+		for (int i = 0; i < kTotalColumns; i++) {
+			Times[i] = 0.0;
+			Velocidades[i] = 0.0;
+			Factors[i] = 1.0;
+		}
+	}
+
+	void Pausa(uint32_t, int) override {}
+	void AddVelocity(int window, char label, double delta) override
+	{
+		int idx = GetIndexForLabelInWindow(window, label);
+		if (idx >= 0) {
+			Set(idx, Velocidades[idx] + ((window == 0) ? delta : -delta));
+		}
+	}
+	void SetVelocity(int window, char label, double velocity) override
+	{
+		int idx = GetIndexForLabelInWindow(window, label);
+		if (idx >= 0) {
+			Set(idx, (window == 0) ? velocity : -velocity);
+		}
+	}
+	void StartRamp(const AppEvent& ev, int window) override { rampas.Start(ev, window); }
+	void Instantanea(uint32_t, int) override {}
+	void StartAcceleration(const AppEvent& ev, int window) override
+	{
+		int idx = GetIndexForLabelInWindow(window, ColumnLabel(ev.column));
+		if (idx >= 0) {
+			aceleraciones.Start(idx, (window == 0) ? ev.amount : -ev.amount, ev.duration);
+		}
+	}
+
+	// Tras AccelerationSet::Advance.
+	void Refresh(const bool* moved)
+	{
+		for (int i = 0; i < kTotalColumns; i++) {
+			if (moved[i]) {
+				Factors[i] = FactorFromVelocity(Velocidades[i]);
+			}
+		}
+	}
+
+	double Times[kTotalColumns];
+	double Velocidades[kTotalColumns];
+	double Factors[kTotalColumns];
+	RampSet rampas;
+	AccelerationSet aceleraciones;
+
+private:
+	void Set(int idx, double v)
+	{
+		Velocidades[idx] = ClampVelocity(v);
+		Factors[idx] = FactorFromVelocity(Velocidades[idx]);
+	}
+};
+
+static void RunSteppedMixed(const std::vector<AppEvent>& events, unsigned long long steps,
+	std::vector<Disparo>& triggers, AnalyticState& state)
+{
+	EventIndex index(kWindowCount);
+	index.Build(events.data(), events.size());
+	SteppedTarget sim;
+	std::vector<EventoDisparado> fired;
+	// Como AnalyticEngine::keyColumn: las claves A-C de cada ventana siempre
+	// existen, asi que la tabla no tiene huecos.
+	int keyColumn[kWindowCount * kIndexColumns];
+	for (int w = 0; w < kWindowCount; w++) {
+		for (int c = 0; c < kIndexColumns; c++) {
+			int idx = GetIndexForLabelInWindow(w, (char)('A' + c));
+			keyColumn[w * kIndexColumns + c] = idx >= 0 ? idx : 0;
+		}
+	}
+	double columnTimes[kWindowCount * kIndexColumns];
+	double intervals[kWindowCount * kIntervalCount];
+	for (unsigned long long step = 0; step < steps; step++) {
+		for (int k = 0; k < kWindowCount * kIndexColumns; k++) {
+			columnTimes[k] = sim.Times[keyColumn[k]];
+		}
+		GetIntervalValues(sim.Times, intervals);
+		fired.clear();
+		index.Collect(columnTimes, fired, intervals);
+		for (size_t d = 0; d < fired.size(); d++) {
+			Disparo disparo = { step, fired[d].event, fired[d].window };
+			triggers.push_back(disparo);
+			DispatchEvent(sim, events[fired[d].event], fired[d].event, fired[d].window);
+		}
+		sim.rampas.Step(sim);
+		bool moved[kTotalColumns] = {};
+		sim.aceleraciones.Advance(kStepTime, sim.Times, sim.Velocidades, moved);
+		for (int i = 0; i < kTotalColumns; i++) {
+			if (!moved[i]) {
+				sim.Times[i] += kStepTime * (1 / sim.Factors[i]);
+			}
+		}
+		sim.Refresh(moved);
+	}
+	for (int i = 0; i < kTotalColumns; i++) {
+		state.clock[i] = sim.Times[i];
+		state.velocity[i] = sim.Velocidades[i];
+	}
+	state.step = steps;
+}
+
+static double ElapsedUs(Clock::time_point from, Clock::time_point to)
+{
+	return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+int main(int argc, char* argv[])
+{
+	int scenarios = 100;
+	int eventCount = 200;
+	double horizon = 100.0;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		if (arg == "--scenarios") {
+			scenarios = atoi(argv[i + 1]);
+		} else if (arg == "--events") {
+			eventCount = atoi(argv[i + 1]);
+		} else if (arg == "--horizon") {
+			horizon = atof(argv[i + 1]);
+		} else {
+			fprintf(stderr, "Opcion desconocida %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	std::mt19937_64 rng(42);
+	double steppedUs = 0.0;
+	double analyticUs = 0.0;
+	unsigned long long totalSteps = 0;
+	long long triggers = 0;
+	long long mismatches = 0;
+	double maxClockError = 0.0;
+	AnalyticEngine engine(AnalyticEngine::kPorPasos);
+	std::vector<AnalyticTrigger> fired;
+	for (int s = 0; s < scenarios; s++) {
+		std::vector<AppEvent> events = MakeScenario(eventCount, horizon, rng);
+		const unsigned long long kNever = ~0ULL;
+		std::vector<unsigned long long> expected(events.size() * kWindowCount, kNever);
+		AnalyticState reference;
+
+		Clock::time_point t0 = Clock::now();
+		RunStepped(events, expected, reference);
+		Clock::time_point t1 = Clock::now();
+		fired.clear();
+		engine.Load(events.data(), events.size());
+		engine.Run(&fired);
+		Clock::time_point t2 = Clock::now();
+		steppedUs += ElapsedUs(t0, t1);
+		analyticUs += ElapsedUs(t1, t2);
+		totalSteps += reference.step;
+
+		std::vector<unsigned long long> got(events.size() * kWindowCount, kNever);
+		for (size_t i = 0; i < fired.size(); i++) {
+			got[fired[i].event * kWindowCount + fired[i].window] = fired[i].step;
+		}
+		for (size_t i = 0; i < got.size(); i++) {
+			if (expected[i] != kNever) {
+				triggers++;
+			}
+			if (got[i] != expected[i]) {
+				mismatches++;
+			}
+		}
+		// Relojes en el ultimo paso del bucle.
+		engine.AdvanceToStep(reference.step, NULL);
+		const AnalyticState& state = engine.State();
+		for (int i = 0; i < kTotalColumns; i++) {
+			double error = fabs(state.clock[i] - reference.clock[i]) / (fabs(reference.clock[i]) + 1.0);
+			if (error > maxClockError) {
+				maxClockError = error;
+			}
+		}
+	}
+
+	// Todos los tipos, durante un numero fijo de pasos.
+	const unsigned long long mixedSteps = (unsigned long long)(horizon / kStepTime);
+	long long mixedTriggers = 0;
+	long long mixedMismatches = 0;
+	double mixedClockError = 0.0;
+	double mixedSteppedUs = 0.0;
+	double mixedAnalyticUs = 0.0;
+	for (int s = 0; s < scenarios; s++) {
+		std::vector<AppEvent> events = MakeMixedScenario(eventCount, horizon, rng);
+		std::vector<Disparo> expected;
+		AnalyticState reference;
+		Clock::time_point t0 = Clock::now();
+		RunSteppedMixed(events, mixedSteps, expected, reference);
+		Clock::time_point t1 = Clock::now();
+		fired.clear();
+		engine.Load(events.data(), events.size());
+		engine.AdvanceToStep(mixedSteps, &fired);
+		Clock::time_point t2 = Clock::now();
+		mixedSteppedUs += ElapsedUs(t0, t1);
+		mixedAnalyticUs += ElapsedUs(t1, t2);
+
+		mixedTriggers += (long long)expected.size();
+		size_t common = expected.size() < fired.size() ? expected.size() : fired.size();
+		mixedMismatches += (long long)(expected.size() - common + fired.size() - common);
+		for (size_t i = 0; i < common; i++) {
+			Disparo got = { fired[i].step, fired[i].event, fired[i].window };
+			if (!(got == expected[i])) {
+				mixedMismatches++;
+			}
+		}
+		const AnalyticState& state = engine.State();
+		for (int i = 0; i < kTotalColumns; i++) {
+			double error = fabs(state.clock[i] - reference.clock[i]) / (fabs(reference.clock[i]) + 1.0);
+			if (error > mixedClockError) {
+				mixedClockError = error;
+			}
+		}
+	}
+
+	printf("{\n  \"benchmark\": \"analytic_engine\",\n");
+	printf("  \"scenarios\": %d,\n  \"events_per_scenario\": %d,\n", scenarios, eventCount);
+	printf("  \"steps_per_scenario\": %.0f,\n  \"triggers\": %lld,\n", (double)totalSteps / scenarios, triggers);
+	printf("  \"stepped_us_per_scenario\": %.2f,\n  \"analytic_us_per_scenario\": %.2f,\n",
+		steppedUs / scenarios, analyticUs / scenarios);
+	printf("  \"mismatched_triggers\": %lld,\n  \"max_relative_clock_error\": %.3g,\n", mismatches, maxClockError);
+	printf("  \"mixed\": {\"steps\": %llu, \"triggers\": %lld, \"mismatched_triggers\": %lld,\n", mixedSteps,
+		mixedTriggers, mixedMismatches);
+	printf("    \"max_relative_clock_error\": %.3g, \"stepped_us_per_scenario\": %.2f, "
+		"\"analytic_us_per_scenario\": %.2f}\n}\n", mixedClockError, mixedSteppedUs / scenarios,
+		mixedAnalyticUs / scenarios);
+	return (mismatches == 0 && mixedMismatches == 0) ? 0 : 1;
+}
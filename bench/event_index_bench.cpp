@@ -0,0 +1,244 @@
+/*
+ * Coste por paso de la deteccion de eventos con EventIndex frente al
+ * recorrido completo de la lista, con escenarios sinteticos grandes.
+ *
+ * Los relojes avanzan como en StepSimulation (dt / factor por columna).
+ * Se mide el coste medio del paso en varios tramos de la simulacion para
+ * comprobar que no crece con el numero de eventos ni con el avance, y se
+ * compara el resultado con el recorrido completo en los primeros pasos.
+ * Tambien se comprueba que Seek salta las repeticiones pendientes de golpe.
+ *
+ *   event_index_bench [--events N] [--steps N] [--scan-steps N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "RelaIndice.h"
+
+typedef std::chrono::steady_clock Clock;
+
+const int kWindows = 3;
+const int kKeys = kWindows * kIndexColumns;
+const double kDt = 1.0 / 100.0;
+const int kSegments = 10;
+
+struct Clocks {
+	double times[kKeys];
+	double rates[kKeys];
+
+	void Advance()
+	{
+		for (int k = 0; k < kKeys; k++) {
+			times[k] += kDt * rates[k];
+		}
+	}
+};
+
+static void InitClocks(Clocks& clocks, std::mt19937_64& rng)
+{
+	std::uniform_real_distribution<double> rate(0.5, 1.0);
+	for (int k = 0; k < kKeys; k++) {
+		clocks.times[k] = 0.0;
+		clocks.rates[k] = rate(rng);
+	}
+}
+
+static std::vector<AppEvent> MakeEvents(size_t count, double horizon, std::mt19937_64& rng)
+{
+	std::uniform_real_distribution<double> time(0.0, horizon);
+	std::uniform_int_distribution<int> column(0, kIndexColumns - 1);
+	std::uniform_int_distribution<int> kind(0, 9);
+	std::vector<AppEvent> events(count);
+	for (size_t i = 0; i < count; i++) {
+		AppEvent& ev = events[i];
+		memset(&ev, 0, sizeof(ev));
+		ev.type = (kind(rng) == 0) ? kEventoPausa : kEventoCambio;
+		ev.column = (uint8_t)column(rng);
+		ev.time = time(rng);
+		ev.amount = 0.001;
+	}
+	return events;
+}
+
+// El recorrido de antes: todos los eventos en cada paso, con una mascara
+// de ventanas ya disparadas por evento.
+static void ScanStep(const std::vector<AppEvent>& events, std::vector<unsigned char>& masks,
+	const double* times, std::vector<EventoDisparado>& fired)
+{
+	const unsigned char all = (1 << kWindows) - 1;
+	for (size_t e = 0; e < events.size(); e++) {
+		const AppEvent& ev = events[e];
+		if (masks[e] == all) {
+			continue;
+		}
+		if (ev.type == kEventoPausa) {
+			if (times[ev.column] >= ev.time) {
+				masks[e] = all;
+				EventoDisparado d = { (uint32_t)e, 0 };
+				fired.push_back(d);
+			}
+			continue;
+		}
+		for (int w = 0; w < kWindows; w++) {
+			if ((masks[e] & (1 << w)) == 0 && times[w * kIndexColumns + ev.column] >= ev.time) {
+				masks[e] |= 1 << w;
+				EventoDisparado d = { (uint32_t)e, w };
+				fired.push_back(d);
+			}
+		}
+	}
+}
+
+// Seek sobre repeticiones ya armadas: con un periodo minimo los disparos
+// saltados se cuentan de golpe, no de uno en uno.  Devuelve los fallos.
+static long long CheckSeek()
+{
+	std::vector<AppEvent> events(2);
+	memset(events.data(), 0, events.size() * sizeof(AppEvent));
+	for (size_t e = 0; e < events.size(); e++) {
+		events[e].type = kEventoCambio;
+		events[e].trigger = kDisparoReloj;
+		events[e].amount = 0.001;
+	}
+	events[0].period = 1e-6;     // sin limite
+	events[1].period = 1.0;
+	events[1].repeats = 5;
+	EventIndex index(kWindows);
+	index.Build(events.data(), events.size());
+	double times[kKeys] = {};
+	std::vector<EventoDisparado> fired;
+	index.Collect(times, fired);
+	long long failures = (fired.size() == 2 * kWindows) ? 0 : 1;
+	for (int k = 0; k < kKeys; k++) {
+		times[k] = 1000.0;
+	}
+	index.Seek(times);
+	fired.clear();
+	index.Collect(times, fired);
+	if (!fired.empty()) {
+		failures++;
+	}
+	// Solo sigue el de periodo sin limite; el otro agoto sus repeticiones.
+	for (int k = 0; k < kKeys; k++) {
+		times[k] = 1000.0 + 2e-6;
+	}
+	fired.clear();
+	index.Collect(times, fired);
+	if (fired.size() != kWindows) {
+		failures++;
+	}
+	for (size_t i = 0; i < fired.size(); i++) {
+		if (fired[i].event != 0) {
+			failures++;
+		}
+	}
+	return failures;
+}
+
+static double ElapsedNs(Clock::time_point from, Clock::time_point to)
+{
+	return std::chrono::duration<double, std::nano>(to - from).count();
+}
+
+int main(int argc, char* argv[])
+{
+	size_t eventCount = 1000000;
+	int steps = 100000;
+	int scanSteps = 200;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		if (arg == "--events") {
+			eventCount = (size_t)atoll(argv[i + 1]);
+		} else if (arg == "--steps") {
+			steps = atoi(argv[i + 1]);
+		} else if (arg == "--scan-steps") {
+			scanSteps = atoi(argv[i + 1]);
+		} else {
+			fprintf(stderr, "Opcion desconocida %s\n", argv[i]);
+			return 1;
+		}
+	}
+	if (steps < kSegments) {
+		steps = kSegments;
+	}
+
+	std::mt19937_64 rng(1234);
+	Clocks clocks;
+	InitClocks(clocks, rng);
+	// Los eventos se reparten por todo el recorrido del reloj mas lento.
+	double horizon = steps * kDt * 0.5;
+	std::vector<AppEvent> events = MakeEvents(eventCount, horizon, rng);
+
+	Clock::time_point buildStart = Clock::now();
+	EventIndex index(kWindows);
+	index.Build(events.data(), events.size());
+	double buildMs = ElapsedNs(buildStart, Clock::now()) / 1e6;
+
+	// Comprobacion frente al recorrido completo (y su coste por paso).
+	Clocks scanClocks = clocks;
+	std::vector<unsigned char> masks(events.size(), 0);
+	std::vector<EventoDisparado> expected, fired;
+	long long mismatches = 0;
+	double scanNs = 0.0;
+	for (int s = 0; s < scanSteps; s++) {
+		expected.clear();
+		fired.clear();
+		Clock::time_point t0 = Clock::now();
+		ScanStep(events, masks, scanClocks.times, expected);
+		scanNs += ElapsedNs(t0, Clock::now());
+		index.Collect(scanClocks.times, fired);
+		if (fired.size() != expected.size()) {
+			mismatches++;
+		} else {
+			for (size_t i = 0; i < fired.size(); i++) {
+				if (fired[i].event != expected[i].event || fired[i].window != expected[i].window) {
+					mismatches++;
+					break;
+				}
+			}
+		}
+		scanClocks.Advance();
+	}
+
+	Clock::time_point seekStart = Clock::now();
+	long long seekFailures = CheckSeek();
+	double seekMs = ElapsedNs(seekStart, Clock::now()) / 1e6;
+
+	// Paso completo con el indice, medido por tramos.
+	index.Rewind();
+	double segmentNs[kSegments] = {};
+	long long segmentFired[kSegments] = {};
+	int perSegment = steps / kSegments;
+	long long totalFired = 0;
+	for (int seg = 0; seg < kSegments; seg++) {
+		Clock::time_point t0 = Clock::now();
+		for (int s = 0; s < perSegment; s++) {
+			fired.clear();
+			index.Collect(clocks.times, fired);
+			segmentFired[seg] += (long long)fired.size();
+			clocks.Advance();
+		}
+		segmentNs[seg] = ElapsedNs(t0, Clock::now()) / perSegment;
+		totalFired += segmentFired[seg];
+	}
+
+	printf("{\n  \"benchmark\": \"event_index\",\n");
+	printf("  \"events\": %llu,\n  \"indexed_entries\": %llu,\n  \"build_ms\": %.3f,\n",
+		(unsigned long long)eventCount, (unsigned long long)index.Size(), buildMs);
+	printf("  \"steps\": %d,\n  \"fired\": %lld,\n", perSegment * kSegments, totalFired);
+	printf("  \"scan_steps\": %d,\n  \"scan_ns_per_step\": %.1f,\n  \"mismatched_steps\": %lld,\n",
+		scanSteps, scanSteps > 0 ? scanNs / scanSteps : 0.0, mismatches);
+	printf("  \"seek_failures\": %lld,\n  \"seek_ms\": %.3f,\n", seekFailures, seekMs);
+	printf("  \"segments\": [\n");
+	for (int seg = 0; seg < kSegments; seg++) {
+		printf("    {\"segment\": %d, \"ns_per_step\": %.1f, \"fired_per_step\": %.2f}%s\n", seg,
+			segmentNs[seg], (double)segmentFired[seg] / perSegment, seg + 1 == kSegments ? "" : ",");
+	}
+	printf("  ]\n}\n");
+	return (mismatches == 0 && seekFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/*
+ * Comprobacion y medida de la conversion por lotes velocidad <-> factor.
+ *
+ * Compara FactorsFromVelocities y VelocitiesFromFactors con las funciones
+ * escalares de RelaModelo.h en todo [-kVelocityLimit, kVelocityLimit]
+ * (mas los extremos, fuera de rango, +-0 y NaN): tienen que coincidir bit
+ * a bit, y el ritmo ser 1 / factor.  Despues mide el coste por elemento de
+ * cada camino.  Devuelve 1 si falla alguna comprobacion.
+ *
+ *   factor_bench [--samples N] [--rounds N]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+#include "RelaFactores.h"
+#include "RelaModelo.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static bool SameBits(double a, double b)
+{
+	if (isnan(a) && isnan(b)) {
+		return true;
+	}
+	return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+static std::vector<double> MakeVelocities(size_t samples)
+{
+	std::vector<double> v;
+	v.reserve(samples + 16);
+	for (size_t i = 0; i < samples; i++) {
+		v.push_back(-kVelocityLimit + 2.0 * kVelocityLimit * (double)i / (double)(samples - 1));
+	}
+	const double extra[] = {
+		0.0, -0.0, kVelocityLimit, -kVelocityLimit, 1.0, -1.0, 2.0, -5.0,
+		nextafter(kVelocityLimit, 1.0), nextafter(-kVelocityLimit, -1.0),
+		std::numeric_limits<double>::quiet_NaN(), INFINITY, -INFINITY, 1.0e-300, -1.0e-300
+	};
+	for (size_t i = 0; i < sizeof(extra) / sizeof(extra[0]); i++) {
+		v.push_back(extra[i]);
+	}
+	return v;
+}
+
+static double NsPerItem(Clock::time_point from, Clock::time_point to, size_t items)
+{
+	return std::chrono::duration<double, std::nano>(to - from).count() / (double)items;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t samples = 1000001;
+	int rounds = 20;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		if (arg == "--samples") {
+			samples = (size_t)atoll(argv[i + 1]);
+		} else if (arg == "--rounds") {
+			rounds = atoi(argv[i + 1]);
+		} else {
+			fprintf(stderr, "Opcion desconocida %s\n", argv[i]);
+			return 1;
+		}
+	}
+	if (samples < 2) {
+		samples = 2;
+	}
+
+	std::vector<double> velocities = MakeVelocities(samples);
+	size_t n = velocities.size();
+	std::vector<double> factors(n), rates(n), back(n);
+
+	// Exactitud.
+	FactorsFromVelocities(velocities.data(), factors.data(), rates.data(), n);
+	long long exactFailures = 0;
+	for (size_t i = 0; i < n; i++) {
+		double expected = FactorFromVelocity(velocities[i]);
+		if (!SameBits(factors[i], expected) || !SameBits(rates[i], 1 / expected)) {
+			if (exactFailures < 5) {
+				fprintf(stderr, "exacto: v=%.17g factor %.17g/%.17g\n", velocities[i], factors[i], expected);
+			}
+			exactFailures++;
+		}
+	}
+	// La inversa con factores de todo el rango (y sus casos especiales).
+	std::vector<double> factorInputs(factors);
+	factorInputs.push_back(0.0);
+	factorInputs.push_back(-1.0);
+	factorInputs.push_back(1.0);
+	factorInputs.push_back(INFINITY);
+	std::vector<double> inverse(factorInputs.size());
+	VelocitiesFromFactors(factorInputs.data(), inverse.data(), factorInputs.size());
+	long long inverseFailures = 0;
+	for (size_t i = 0; i < factorInputs.size(); i++) {
+		if (!SameBits(inverse[i], VelocityFromFactor(factorInputs[i]))) {
+			if (inverseFailures < 5) {
+				fprintf(stderr, "inversa: factor=%.17g %.17g/%.17g\n", factorInputs[i], inverse[i],
+					VelocityFromFactor(factorInputs[i]));
+			}
+			inverseFailures++;
+		}
+	}
+
+	// Coste.
+	volatile double sink = 0.0;
+	Clock::time_point t0 = Clock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (size_t i = 0; i < n; i++) {
+			factors[i] = FactorFromVelocity(velocities[i]);
+			rates[i] = 1 / factors[i];
+		}
+		sink = sink + rates[r % n];
+	}
+	Clock::time_point t1 = Clock::now();
+	for (int r = 0; r < rounds; r++) {
+		FactorsFromVelocities(velocities.data(), factors.data(), rates.data(), n);
+		sink = sink + rates[r % n];
+	}
+	Clock::time_point t2 = Clock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (size_t i = 0; i < n; i++) {
+			back[i] = VelocityFromFactor(factors[i]);
+		}
+		sink = sink + back[r % n];
+	}
+	Clock::time_point t3 = Clock::now();
+	for (int r = 0; r < rounds; r++) {
+		VelocitiesFromFactors(factors.data(), back.data(), n);
+		sink = sink + back[r % n];
+	}
+	Clock::time_point t4 = Clock::now();
+	size_t items = n * (size_t)rounds;
+
+	printf("{\n  \"benchmark\": \"factor_batch\",\n  \"samples\": %llu,\n", (unsigned long long)n);
+	printf("  \"exact_mismatches\": %lld,\n  \"inverse_mismatches\": %lld,\n", exactFailures, inverseFailures);
+	printf("  \"scalar_ns\": %.3f,\n  \"batch_ns\": %.3f,\n",
+		NsPerItem(t0, t1, items), NsPerItem(t1, t2, items));
+	printf("  \"inverse_scalar_ns\": %.3f,\n  \"inverse_batch_ns\": %.3f\n}\n",
+		NsPerItem(t2, t3, items), NsPerItem(t3, t4, items));
+	return (exactFailures == 0 && inverseFailures == 0) ? 0 : 1;
+}
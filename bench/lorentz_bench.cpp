@@ -0,0 +1,148 @@
+/*
+ * Comprobacion y medida de LorentzSystem.
+ *
+ * Simula N particulas con cambios de velocidad aleatorios y en cada paso
+ * pide View() desde tres marcos.  Comprueba:
+ *   - en el marco de laboratorio, el tiempo propio coincide con la suma
+ *     paso a paso de dt * sqrt(1 - v^2) y la posicion con la de v * dt;
+ *   - en los demas marcos, el resultado coincide con una busqueda lineal
+ *     en los tramos y transformar de vuelta el suceso da el tiempo pedido.
+ * Devuelve 1 si falla alguna comprobacion.
+ *
+ *   lorentz_bench [--particles N] [--steps N]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "RelaLorentz.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// Suceso de la linea de universo con gamma * (t - frame * x) = frameTime,
+// recorriendo todos los tramos.
+static void ReferencePoint(const std::vector<WorldSegment>& segs, double frame, double frameTime,
+	double& tau, double& x, double& t)
+{
+	double gamma = 1.0 / sqrt(1.0 - frame * frame);
+	double s = frameTime / gamma;
+	size_t k = 0;
+	while (k + 1 < segs.size() && segs[k + 1].t - frame * segs[k + 1].x <= s) {
+		k++;
+	}
+	const WorldSegment& seg = segs[k];
+	t = (s + frame * (seg.x - seg.v * seg.t)) / (1.0 - frame * seg.v);
+	x = seg.x + seg.v * (t - seg.t);
+	tau = seg.tau + sqrt(1.0 - seg.v * seg.v) * (t - seg.t);
+}
+
+int main(int argc, char* argv[])
+{
+	size_t particles = 500;
+	int steps = 5000;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		if (arg == "--particles") {
+			particles = (size_t)atoll(argv[i + 1]);
+		} else if (arg == "--steps") {
+			steps = atoi(argv[i + 1]);
+		} else {
+			fprintf(stderr, "Opcion desconocida %s\n", argv[i]);
+			return 1;
+		}
+	}
+	if (particles < 1) {
+		particles = 1;
+	}
+
+	const double dt = 1.0 / 100.0;
+	const double frames[3] = { 0.0, 0.5, -0.8 };
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<double> velocityDist(-0.95, 0.95);
+	std::uniform_int_distribution<size_t> particleDist(0, particles - 1);
+
+	std::vector<double> x0(particles);
+	for (size_t i = 0; i < particles; i++) {
+		x0[i] = (double)i - (double)particles / 2;
+	}
+	LorentzSystem system;
+	system.Reset(particles, x0.data());
+
+	// Integracion directa en el marco de laboratorio.
+	std::vector<double> tauRef(particles, 0.0);
+	std::vector<double> xRef(x0);
+	std::vector<double> vRef(particles, 0.0);
+
+	std::vector<double> tau(particles), x(particles), velocity(particles);
+	double labError = 0.0;
+	double frameError = 0.0;
+	long long failures = 0;
+	double viewSeconds = 0.0;
+	for (int step = 0; step < steps; step++) {
+		// Unos pocos cambios por paso.
+		for (int k = 0; k < 4; k++) {
+			size_t i = particleDist(rng);
+			double v = velocityDist(rng);
+			system.SetVelocity(i, v);
+			vRef[i] = v;
+		}
+		system.Advance(dt);
+		for (size_t i = 0; i < particles; i++) {
+			tauRef[i] += dt * sqrt(1.0 - vRef[i] * vRef[i]);
+			xRef[i] += dt * vRef[i];
+		}
+
+		Clock::time_point t0 = Clock::now();
+		for (int f = 0; f < 3; f++) {
+			double gamma = 1.0 / sqrt(1.0 - frames[f] * frames[f]);
+			system.View(frames[f], system.Time() * gamma, tau.data(), x.data(), velocity.data());
+		}
+		viewSeconds += std::chrono::duration<double>(Clock::now() - t0).count();
+
+		// Las comprobaciones solo en algunos pasos para no dominar el tiempo.
+		if (step % 50 != 0 && step != steps - 1) {
+			continue;
+		}
+		system.View(0.0, system.Time(), tau.data(), x.data(), velocity.data());
+		for (size_t i = 0; i < particles; i++) {
+			double e = fabs(tau[i] - tauRef[i]) + fabs(x[i] - xRef[i]) + fabs(velocity[i] - vRef[i]);
+			if (e > labError) {
+				labError = e;
+			}
+		}
+		for (int f = 1; f < 3; f++) {
+			double frame = frames[f];
+			double gamma = 1.0 / sqrt(1.0 - frame * frame);
+			double frameTime = system.Time() * gamma * 0.75;
+			system.View(frame, frameTime, tau.data(), x.data(), velocity.data());
+			for (size_t i = 0; i < particles; i++) {
+				double tauE, xE, tE;
+				ReferencePoint(system.Segments(i), frame, frameTime, tauE, xE, tE);
+				double xp = gamma * (xE - frame * tE);
+				double tp = gamma * (tE - frame * xE);
+				double e = fabs(tau[i] - tauE) + fabs(x[i] - xp) + fabs(tp - frameTime);
+				if (e > frameError) {
+					frameError = e;
+				}
+			}
+		}
+	}
+	// Errores de redondeo acumulados en miles de pasos.
+	if (labError > 1.0e-8) {
+		failures++;
+	}
+	if (frameError > 1.0e-8) {
+		failures++;
+	}
+
+	printf("{\n  \"benchmark\": \"lorentz_view\",\n  \"particles\": %llu,\n  \"steps\": %d,\n",
+		(unsigned long long)particles, steps);
+	printf("  \"lab_max_error\": %.3g,\n  \"frame_max_error\": %.3g,\n", labError, frameError);
+	printf("  \"view_ns_per_particle\": %.3f,\n  \"failures\": %lld\n}\n",
+		viewSeconds * 1.0e9 / ((double)steps * 3.0 * (double)particles), failures);
+	return failures == 0 ? 0 : 1;
+}
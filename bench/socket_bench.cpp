@@ -0,0 +1,392 @@
+/*
+ *   Loopback latency and throughput benchmark for PracticalSocket
+ *
+ *   Runs TCP echo, one-way TCP streaming and UDP ping-pong against
+ *   127.0.0.1 at several message sizes and client thread counts and
+ *   prints the results as JSON on stdout.
+ *
+ *   Usage: socket_bench [--iterations N] [--threads 1,4] [--sizes 16,1024]
+ */
+
+#include "PracticalSocket.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+  int iterations;
+  int warmup;
+  vector<int> threads;
+  vector<int> sizes;
+};
+
+struct Result {
+  string name;
+  int threads;
+  int size;
+  long long messages;
+  long long lost;
+  double seconds;
+  vector<double> latenciesUs;  // Round trip times, empty for streaming
+};
+
+static double elapsedUs(Clock::time_point from, Clock::time_point to) {
+  return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+static double percentile(const vector<double> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  size_t idx = (size_t) (p * (double) (sorted.size() - 1) + 0.5);
+  return sorted[idx];
+}
+
+// Receive exactly len bytes or fail
+static bool recvAll(TCPSocket &sock, char *buffer, int len) {
+  int got = 0;
+  while (got < len) {
+    int rtn = sock.recv(buffer + got, len - got);
+    if (rtn <= 0) {
+      return false;
+    }
+    got += rtn;
+  }
+  return true;
+}
+
+// TCP echo
+
+static void tcpEchoServer(TCPSocket *sock) {
+  vector<char> buffer(64 * 1024);
+  try {
+    sock->setNoDelay(true);
+    int rtn;
+    while ((rtn = sock->recv(&buffer[0], (int) buffer.size())) > 0) {
+      sock->send(&buffer[0], rtn);
+    }
+  } catch (const SocketException &) {
+  }
+  delete sock;
+}
+
+static void tcpEchoClient(unsigned short port, int size, int iterations,
+                          int warmup, vector<double> &latencies) {
+  try {
+    TCPSocket sock("127.0.0.1", port);
+    sock.setNoDelay(true);
+    vector<char> out(size, 'x');
+    vector<char> in(size);
+    latencies.reserve(iterations);
+    for (int i = 0; i < warmup + iterations; i++) {
+      Clock::time_point start = Clock::now();
+      sock.send(&out[0], size);
+      if (!recvAll(sock, &in[0], size)) {
+        throw SocketException("Echo connection closed");
+      }
+      if (i >= warmup) {
+        latencies.push_back(elapsedUs(start, Clock::now()));
+      }
+    }
+  } catch (const SocketException &e) {
+    fprintf(stderr, "tcp_echo client: %s\n", e.what());
+  }
+}
+
+static Result runTcpEcho(int threads, int size, const Options &opt) {
+  TCPServerSocket server("127.0.0.1", 0, threads);
+  unsigned short port = server.getLocalPort();
+
+  vector<std::thread> servers;
+  std::thread acceptor([&]() {
+    for (int t = 0; t < threads; t++) {
+      servers.push_back(std::thread(tcpEchoServer, server.accept()));
+    }
+  });
+
+  vector<vector<double> > latencies(threads);
+  vector<std::thread> clients;
+  Clock::time_point start = Clock::now();
+  for (int t = 0; t < threads; t++) {
+    clients.push_back(std::thread(tcpEchoClient, port, size, opt.iterations,
+                                  opt.warmup, std::ref(latencies[t])));
+  }
+  for (size_t t = 0; t < clients.size(); t++) {
+    clients[t].join();
+  }
+  Clock::time_point end = Clock::now();
+  acceptor.join();
+  for (size_t t = 0; t < servers.size(); t++) {
+    servers[t].join();
+  }
+
+  Result r;
+  r.name = "tcp_echo";
+  r.threads = threads;
+  r.size = size;
+  r.lost = 0;
+  r.seconds = elapsedUs(start, end) / 1e6;
+  for (int t = 0; t < threads; t++) {
+    r.latenciesUs.insert(r.latenciesUs.end(), latencies[t].begin(),
+                         latencies[t].end());
+  }
+  r.messages = (long long) r.latenciesUs.size();
+  return r;
+}
+
+// One-way TCP streaming
+
+static void tcpSink(TCPSocket *sock, long long expected) {
+  vector<char> buffer(256 * 1024);
+  long long got = 0;
+  try {
+    int rtn;
+    while (got < expected &&
+           (rtn = sock->recv(&buffer[0], (int) buffer.size())) > 0) {
+      got += rtn;
+    }
+    char ack = 1;
+    sock->send(&ack, 1);
+  } catch (const SocketException &) {
+  }
+  delete sock;
+}
+
+static void tcpStreamClient(unsigned short port, int size, long long total) {
+  try {
+    TCPSocket sock("127.0.0.1", port);
+    vector<char> out(size, 'x');
+    for (long long sent = 0; sent < total; sent += size) {
+      sock.send(&out[0], size);
+    }
+    char ack;
+    sock.recv(&ack, 1);
+  } catch (const SocketException &e) {
+    fprintf(stderr, "tcp_stream client: %s\n", e.what());
+  }
+}
+
+static Result runTcpStream(int threads, int size, const Options &opt) {
+  TCPServerSocket server("127.0.0.1", 0, threads);
+  unsigned short port = server.getLocalPort();
+  long long perThread = (long long) size * opt.iterations;
+
+  vector<std::thread> sinks;
+  std::thread acceptor([&]() {
+    for (int t = 0; t < threads; t++) {
+      sinks.push_back(std::thread(tcpSink, server.accept(), perThread));
+    }
+  });
+
+  vector<std::thread> clients;
+  Clock::time_point start = Clock::now();
+  for (int t = 0; t < threads; t++) {
+    clients.push_back(std::thread(tcpStreamClient, port, size, perThread));
+  }
+  for (size_t t = 0; t < clients.size(); t++) {
+    clients[t].join();
+  }
+  Clock::time_point end = Clock::now();
+  acceptor.join();
+  for (size_t t = 0; t < sinks.size(); t++) {
+    sinks[t].join();
+  }
+
+  Result r;
+  r.name = "tcp_stream";
+  r.threads = threads;
+  r.size = size;
+  r.messages = (long long) threads * opt.iterations;
+  r.lost = 0;
+  r.seconds = elapsedUs(start, end) / 1e6;
+  return r;
+}
+
+// UDP ping-pong
+
+static void udpEchoServer(UDPSocket *sock) {
+  vector<char> buffer(65536);
+  string address;
+  unsigned short port;
+  std::error_code ec;
+  for (;;) {
+    int rtn = sock->recvFrom(&buffer[0], (int) buffer.size(), address, port, ec);
+    if (ec || rtn == 0) {
+      break;                   // Empty datagram asks the server to stop
+    }
+    sock->sendTo(&buffer[0], rtn, address, port, ec);
+  }
+}
+
+static void udpPingClient(unsigned short port, int size, int iterations,
+                          int warmup, vector<double> &latencies,
+                          long long &lost) {
+  UDPSocket sock("127.0.0.1", 0);
+  sock.setReceiveTimeout(1000);
+  vector<char> out(size, 'x');
+  vector<char> in(size);
+  std::error_code ec;
+  latencies.reserve(iterations);
+  lost = 0;
+  for (int i = 0; i < warmup + iterations; i++) {
+    Clock::time_point start = Clock::now();
+    sock.sendTo(&out[0], size, "127.0.0.1", port, ec);
+    sock.recv(&in[0], size, ec);
+    if (ec) {
+      lost++;
+      continue;
+    }
+    if (i >= warmup) {
+      latencies.push_back(elapsedUs(start, Clock::now()));
+    }
+  }
+}
+
+static Result runUdpPingPong(int threads, int size, const Options &opt) {
+  vector<UDPSocket *> servers;
+  vector<std::thread> serverThreads;
+  for (int t = 0; t < threads; t++) {
+    servers.push_back(new UDPSocket("127.0.0.1", 0));
+    serverThreads.push_back(std::thread(udpEchoServer, servers[t]));
+  }
+
+  vector<vector<double> > latencies(threads);
+  vector<long long> lost(threads);
+  vector<std::thread> clients;
+  Clock::time_point start = Clock::now();
+  for (int t = 0; t < threads; t++) {
+    clients.push_back(std::thread(udpPingClient, servers[t]->getLocalPort(),
+                                  size, opt.iterations, opt.warmup,
+                                  std::ref(latencies[t]), std::ref(lost[t])));
+  }
+  for (size_t t = 0; t < clients.size(); t++) {
+    clients[t].join();
+  }
+  Clock::time_point end = Clock::now();
+
+  UDPSocket stopper;
+  for (int t = 0; t < threads; t++) {
+    stopper.sendTo("", 0, "127.0.0.1", servers[t]->getLocalPort());
+    serverThreads[t].join();
+    delete servers[t];
+  }
+
+  Result r;
+  r.name = "udp_pingpong";
+  r.threads = threads;
+  r.size = size;
+  r.messages = 0;
+  r.lost = 0;
+  r.seconds = elapsedUs(start, end) / 1e6;
+  for (int t = 0; t < threads; t++) {
+    r.latenciesUs.insert(r.latenciesUs.end(), latencies[t].begin(),
+                         latencies[t].end());
+    r.lost += lost[t];
+  }
+  r.messages = (long long) r.latenciesUs.size();
+  return r;
+}
+
+// Output
+
+static void printResult(const Result &r, bool last) {
+  vector<double> sorted = r.latenciesUs;
+  std::sort(sorted.begin(), sorted.end());
+  double mean = 0.0;
+  for (size_t i = 0; i < sorted.size(); i++) {
+    mean += sorted[i];
+  }
+  if (!sorted.empty()) {
+    mean /= (double) sorted.size();
+  }
+  double rate = r.seconds > 0.0 ? (double) r.messages / r.seconds : 0.0;
+
+  printf("    {\"name\": \"%s\", \"threads\": %d, \"size\": %d, "
+         "\"messages\": %lld, \"lost\": %lld, \"seconds\": %.6f, "
+         "\"msgs_per_sec\": %.1f, \"mb_per_sec\": %.3f",
+         r.name.c_str(), r.threads, r.size, r.messages, r.lost, r.seconds,
+         rate, rate * r.size / (1024.0 * 1024.0));
+  if (!sorted.empty()) {
+    printf(", \"p50_us\": %.2f, \"p99_us\": %.2f, \"mean_us\": %.2f, "
+           "\"min_us\": %.2f, \"max_us\": %.2f",
+           percentile(sorted, 0.50), percentile(sorted, 0.99), mean,
+           sorted.front(), sorted.back());
+  }
+  printf("}%s\n", last ? "" : ",");
+}
+
+static vector<int> parseList(const char *text) {
+  vector<int> values;
+  string item;
+  for (const char *p = text; ; p++) {
+    if (*p == ',' || *p == '\0') {
+      if (!item.empty()) {
+        values.push_back(atoi(item.c_str()));
+      }
+      item.clear();
+      if (*p == '\0') {
+        break;
+      }
+    } else {
+      item += *p;
+    }
+  }
+  return values;
+}
+
+int main(int argc, char *argv[]) {
+  Options opt;
+  opt.iterations = 20000;
+  opt.warmup = 500;
+  opt.threads = parseList("1,4");
+  opt.sizes = parseList("16,256,4096,65536");
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    string arg = argv[i];
+    if (arg == "--iterations") {
+      opt.iterations = atoi(argv[i + 1]);
+    } else if (arg == "--threads") {
+      opt.threads = parseList(argv[i + 1]);
+    } else if (arg == "--sizes") {
+      opt.sizes = parseList(argv[i + 1]);
+    } else {
+      fprintf(stderr, "Unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  vector<Result> results;
+  try {
+    for (size_t t = 0; t < opt.threads.size(); t++) {
+      for (size_t s = 0; s < opt.sizes.size(); s++) {
+        int threads = opt.threads[t];
+        int size = opt.sizes[s];
+        results.push_back(runTcpEcho(threads, size, opt));
+        results.push_back(runTcpStream(threads, size, opt));
+        if (size <= 65507) {   // Largest UDP payload over IPv4
+          results.push_back(runUdpPingPong(threads, size, opt));
+        }
+      }
+    }
+  } catch (const SocketException &e) {
+    fprintf(stderr, "socket_bench: %s\n", e.what());
+    return 1;
+  }
+
+  printf("{\n  \"benchmark\": \"practicalsocket_loopback\",\n");
+  printf("  \"iterations\": %d,\n  \"results\": [\n", opt.iterations);
+  for (size_t i = 0; i < results.size(); i++) {
+    printResult(results[i], i + 1 == results.size());
+  }
+  printf("  ]\n}\n");
+  return 0;
+}
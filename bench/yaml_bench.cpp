@@ -0,0 +1,314 @@
+/*
+ * Medida del escaneo de yaml-cpp con un escenario sintetico grande.
+ *
+ * Genera una lista de eventos como la de config.yaml (mapas en bloque y en
+ * flujo, cadenas entre comillas, comentarios) y mide:
+ *   - Parser con un EventHandler que solo cuenta (escaneo y analisis, sin
+ *     construir nodos) leyendo de un istringstream;
+ *   - YAML::Load de la cadena entera (escaneo en sitio y nodos).
+ * Comprueba que los dos caminos ven los mismos escalares y que los eventos
+ * cargados son los generados, que el lector de escenarios sustituye los
+ * alias y lee las secciones con sus rangos, y que LeerEscalar
+ * acepta lo mismo que Node::as<T>().
+ * Devuelve 1 si falla alguna comprobacion.
+ *
+ *   yaml_bench [--megabytes N] [--rounds N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/yaml.h"
+#include "RelaEventos.h"
+#include "RelaYaml.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* const kTipos[] = { "pausa", "cambio", "fijar", "rampa", "instantanea", "aceleracion" };
+
+// Cuenta los escalares y suma sus longitudes.
+class CountingHandler : public YAML::EventHandler {
+public:
+	CountingHandler() : scalars(0), bytes(0), collections(0) {}
+
+	void OnDocumentStart(const YAML::Mark&) override {}
+	void OnDocumentEnd() override {}
+	void OnNull(const YAML::Mark&, YAML::anchor_t) override { scalars++; }
+	void OnAlias(const YAML::Mark&, YAML::anchor_t) override {}
+	void OnScalar(const YAML::Mark&, const std::string&, YAML::anchor_t, const std::string& value) override
+	{
+		scalars++;
+		bytes += value.size();
+	}
+	void OnSequenceStart(const YAML::Mark&, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value) override
+	{
+		collections++;
+	}
+	void OnSequenceEnd() override {}
+	void OnMapStart(const YAML::Mark&, const std::string&, YAML::anchor_t, YAML::EmitterStyle::value) override
+	{
+		collections++;
+	}
+	void OnMapEnd() override {}
+
+	long long scalars;
+	long long bytes;
+	long long collections;
+};
+
+static void CountScalars(const YAML::Node& node, long long& scalars, long long& bytes)
+{
+	if (node.IsScalar()) {
+		scalars++;
+		bytes += (long long)node.Scalar().size();
+		return;
+	}
+	for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
+		if (node.IsMap()) {
+			CountScalars(it->first, scalars, bytes);
+			CountScalars(it->second, scalars, bytes);
+		} else {
+			CountScalars(*it, scalars, bytes);
+		}
+	}
+}
+
+// Un evento por vuelta, alternando bloque y flujo.  Devuelve cuantos hay.
+static long long BuildScenario(size_t targetBytes, std::string& out)
+{
+	out = "# Escenario sintetico para yaml_bench\nrecarga:\n  activa: true\n  estado: preservar\neventos:\n";
+	char line[256];
+	long long count = 0;
+	while (out.size() < targetBytes) {
+		const char* tipo = kTipos[count % 6];
+		char columna = (char)('A' + count % 3);
+		double tiempo = 0.25 * (double)count;
+		if (count % 2 == 0) {
+			snprintf(line, sizeof(line),
+				"  - tipo: %s\n    columna: %c\n    tiempo: %.2f\n    cantidad: %.3f\n"
+				"    nota: \"evento numero %lld con texto entre comillas\"  # comentario\n",
+				tipo, columna, tiempo, 0.001 * (double)(count % 997), count);
+		} else {
+			snprintf(line, sizeof(line),
+				"  - {tipo: %s, columna: %c, tiempo: %.2f, duracion: 2.0, nota: 'en flujo %lld'}\n",
+				tipo, columna, tiempo, count);
+		}
+		out += line;
+		count++;
+	}
+	return count;
+}
+
+// Los lectores de escenarios leen ficheros.
+static std::string WriteScenario(const std::string& text)
+{
+	std::string path = (std::filesystem::temp_directory_path() / "yaml_bench_escenario.yaml").string();
+	std::ofstream file(path, std::ios::binary);
+	file << text;
+	return path;
+}
+
+// Alias dentro y fuera de la lista: los de escalares valen su valor y los
+// de colecciones repiten sus eventos, tambien con alias dentro.
+static long long CheckAliases()
+{
+	std::string path = WriteScenario(
+		"base: &t 2.5\n"
+		"plantilla: &m {tipo: cambio, columna: C, tiempo: *t, cantidad: 1}\n"
+		"eventos:\n"
+		"  - {tipo: cambio, columna: &col B, tiempo: *t, cantidad: &c 0.5}\n"
+		"  - tipo: cambio\n"
+		"    columna: A\n"
+		"    tiempo: *t\n"
+		"    cantidad: *c\n"
+		"  - &pausa {tipo: pausa, columna: *col, tiempo: 1}\n"
+		"  - *pausa\n"
+		"  - *m\n");
+	long long failures = 0;
+	ScenarioConfig config;
+	ScenarioDiagnostics diagnostics;
+	std::string error;
+	LoadEventosFromYaml(path.c_str(), config, error, &diagnostics);
+	const std::vector<AppEvent>& ev = config.eventos;
+	if (ev.size() != 5 || ev[0].column != 1 || ev[0].time != 2.5 || ev[0].amount != 0.5 ||
+		ev[1].column != 0 || ev[1].time != 2.5 || ev[1].amount != 0.5 || ev[2].column != 1 ||
+		ev[3].type != ev[2].type || ev[3].column != 1 || ev[3].time != 1.0 ||
+		ev[4].column != 2 || ev[4].time != 2.5 || ev[4].amount != 1.0) {
+		failures++;
+	}
+	if (!diagnostics.problems.empty()) {
+		failures++;
+	}
+	// La lista entera tambien puede ser un alias.
+	std::filesystem::remove(path);
+	path = WriteScenario(
+		"lista: &l\n"
+		"  - {tipo: pausa, columna: A, tiempo: 1}\n"
+		"eventos: *l\n");
+	ScenarioConfig aliased;
+	if (!LoadEventosFromYaml(path.c_str(), aliased, error) || aliased.eventos.size() != 1) {
+		failures++;
+	}
+	std::filesystem::remove(path);
+	return failures;
+}
+
+// Las secciones se leen con sus tablas de campos; lo que esta fuera de rango
+// se anota y se queda el valor por defecto.
+static long long CheckSecciones()
+{
+	std::string path = WriteScenario(
+		"telemetria: {puerto: 0x1F90, decimacion: 0}\n"
+		"recarga: {activa: Off, estado: reiniciar}\n"
+		"fisica: {modelo: dilatacion, marco1: -.5, marco2: 1.5}\n"
+		"eventos:\n"
+		"  - {tipo: cambio, columna: A, tiempo: 1, cantidad: 010}\n");
+	long long failures = 0;
+	ScenarioConfig config;
+	ScenarioDiagnostics diagnostics;
+	std::string error;
+	if (!LoadEventosFromYaml(path.c_str(), config, error, &diagnostics) || config.telemetriaPuerto != 8080 ||
+		config.telemetriaDecimacion != 1 || config.recargaActiva || config.recargaModo != kRecargaReiniciar ||
+		config.fisicaModelo != kFisicaDilatacion || config.fisicaMarcos[1] != -0.5 || config.fisicaMarcos[2] != 0.0 ||
+		config.eventos.size() != 1 || config.eventos[0].amount != 10.0) {
+		failures++;
+	}
+	if (diagnostics.problems.size() != 2 || diagnostics.problems[0].line != 1 || diagnostics.problems[1].line != 3) {
+		failures++;
+	}
+	std::filesystem::remove(path);
+	return failures;
+}
+
+// LeerEscalar tiene que dar lo mismo que Node::as<T>() con cada texto.
+template <typename T>
+static long long CheckEscalar(const std::string& text)
+{
+	T leido = T();
+	bool ok = LeerEscalar(text, leido);
+	try {
+		T esperado = YAML::Node(text).as<T>();
+		return ok && (leido == esperado || (leido != leido && esperado != esperado)) ? 0 : 1;
+	} catch (const YAML::Exception&) {
+		return ok ? 1 : 0;
+	}
+}
+
+static long long CheckEscalares()
+{
+	static const char* const textos[] = { "0", "10", "010", "0x10", "-7", "+1", " 1", "1 ", "1e3", "2.5", "-.5",
+		".inf", "-.Inf", ".NaN", "inf", "nan", "0x1p3", "99999999999", "", "y", "Yes", "TRUE", "tRuE", "off", "No",
+		"1,5" };
+	long long failures = 0;
+	for (const char* texto : textos) {
+		failures += CheckEscalar<int>(texto) + CheckEscalar<double>(texto) + CheckEscalar<bool>(texto);
+	}
+	int entero = 0;
+	bool booleano = false;
+	if (!LeerEscalar("010", entero) || entero != 8 || !LeerEscalar("0x10", entero) || entero != 16 ||
+		LeerEscalar("tRuE", booleano) || !LeerEscalar("TRUE", booleano) || !booleano) {
+		failures++;
+	}
+	return failures;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t megabytes = 8;
+	int rounds = 3;
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		if (arg == "--megabytes") {
+			megabytes = (size_t)atoll(argv[i + 1]);
+		} else if (arg == "--rounds") {
+			rounds = atoi(argv[i + 1]);
+		} else {
+			fprintf(stderr, "Opcion desconocida %s\n", argv[i]);
+			return 1;
+		}
+	}
+	if (megabytes < 1) {
+		megabytes = 1;
+	}
+	if (rounds < 1) {
+		rounds = 1;
+	}
+	std::string text;
+	long long events = BuildScenario(megabytes << 20, text);
+	double mb = (double)text.size() / (1024.0 * 1024.0);
+	long long failures = 0;
+
+	// Se queda con la mejor vuelta de cada camino.
+	double parseSeconds = 1.0e30;
+	double loadSeconds = 1.0e30;
+	CountingHandler counted;
+	for (int r = 0; r < rounds; r++) {
+		CountingHandler handler;
+		std::istringstream input(text);
+		Clock::time_point t0 = Clock::now();
+		YAML::Parser parser(input);
+		while (parser.HandleNextDocument(handler)) {
+		}
+		double s = std::chrono::duration<double>(Clock::now() - t0).count();
+		if (s < parseSeconds) {
+			parseSeconds = s;
+		}
+		counted = handler;
+	}
+
+	YAML::Node root;
+	for (int r = 0; r < rounds; r++) {
+		Clock::time_point t0 = Clock::now();
+		root = YAML::Load(text);
+		double s = std::chrono::duration<double>(Clock::now() - t0).count();
+		if (s < loadSeconds) {
+			loadSeconds = s;
+		}
+	}
+
+	// Los escalares que ve el Parser tienen que ser los del arbol.
+	long long treeScalars = 0;
+	long long treeBytes = 0;
+	CountScalars(root, treeScalars, treeBytes);
+	if (treeScalars != counted.scalars || treeBytes != counted.bytes) {
+		failures++;
+	}
+	long long loaded = 0;
+	try {
+		YAML::Node eventos = root["eventos"];
+		loaded = (long long)eventos.size();
+		for (long long i = 0; i < loaded; i++) {
+			YAML::Node ev = eventos[(size_t)i];
+			if (ev["tipo"].as<std::string>() != kTipos[i % 6] ||
+				ev["columna"].as<std::string>() != std::string(1, (char)('A' + i % 3)) ||
+				ev["tiempo"].as<double>() != 0.25 * (double)i) {
+				failures++;
+			}
+		}
+	} catch (const YAML::Exception& e) {
+		fprintf(stderr, "%s\n", e.what());
+		failures++;
+	}
+	if (loaded != events) {
+		failures++;
+	}
+	// 6 escalares de recarga y eventos, y 10 por evento.
+	if (counted.scalars != 6 + 10 * events) {
+		failures++;
+	}
+
+	failures += CheckAliases();
+	failures += CheckEscalares();
+	failures += CheckSecciones();
+
+	printf("{\n  \"benchmark\": \"yaml_scan\",\n  \"megabytes\": %.2f,\n  \"events\": %lld,\n", mb, events);
+	printf("  \"parse_mb_per_second\": %.2f,\n  \"load_mb_per_second\": %.2f,\n", mb / parseSeconds,
+		mb / loadSeconds);
+	printf("  \"scalars\": %lld,\n  \"failures\": %lld\n}\n", counted.scalars, failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -20,6 +20,17 @@
 
 #if ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
 #include <string_view>
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+#endif
+
+// The floating point overloads of std::from_chars came later than the integer
+// ones; __cpp_lib_to_chars is only defined once the library has both.
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define YAML_CPP_HAS_FROM_CHARS
 #endif
 
 #include "yaml-cpp/binary.h"
@@ -118,28 +129,111 @@ struct convert<_Null> {
 };
 
 namespace conversion {
+// Which numbers have a fast path without a stream.  The character types are
+// read and written as characters (char) or through an int (signed and
+// unsigned char), so they always go through the stream, as does long double.
+template <typename T>
+struct is_chars_integer
+    : std::integral_constant<bool,
+#ifdef YAML_CPP_HAS_FROM_CHARS
+                             std::is_integral<T>::value &&
+                                 !std::is_same<T, char>::value &&
+                                 !std::is_same<T, signed char>::value &&
+                                 !std::is_same<T, unsigned char>::value
+#else
+                             false
+#endif
+                             > {
+};
+
 template <typename T>
-typename std::enable_if< std::is_floating_point<T>::value, void>::type
-inner_encode(const T& rhs, std::stringstream& stream){
+struct is_chars_float
+    : std::integral_constant<bool,
+#ifdef YAML_CPP_HAS_FROM_CHARS
+                             std::is_same<T, float>::value ||
+                                 std::is_same<T, double>::value
+#else
+                             false
+#endif
+                             > {
+};
+
+// Each of these returns false for the values it leaves to the classic-locale
+// stream, and otherwise gives exactly the result the stream would.
+
+// Floating point values are written by FpToString (dragonbox).
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+ToChars(const T& rhs, std::string& output) {
   if (std::isnan(rhs)) {
-    stream << ".nan";
+    output = ".nan";
   } else if (std::isinf(rhs)) {
-    if (std::signbit(rhs)) {
-      stream << "-.inf";
-    } else {
-      stream << ".inf";
-    }
+    output = std::signbit(rhs) ? "-.inf" : ".inf";
   } else {
-    stream << FpToString(rhs, stream.precision());
+    output = FpToString(rhs, std::numeric_limits<T>::max_digits10);
   }
+  return true;
+}
+
+template <typename T>
+typename std::enable_if<!std::is_floating_point<T>::value &&
+                            !is_chars_integer<T>::value,
+                        bool>::type
+ToChars(const T& /* rhs */, std::string& /* output */) {
+  return false;
+}
+
+template <typename T>
+typename std::enable_if<!is_chars_integer<T>::value &&
+                            !is_chars_float<T>::value,
+                        bool>::type
+FromChars(const std::string& /* input */, T& /* rhs */) {
+  return false;
+}
+
+#ifdef YAML_CPP_HAS_FROM_CHARS
+template <typename T>
+typename std::enable_if<is_chars_integer<T>::value, bool>::type ToChars(
+    const T& rhs, std::string& output) {
+  char buffer[std::numeric_limits<T>::digits10 + 3];
+  std::to_chars_result result =
+      std::to_chars(buffer, buffer + sizeof(buffer), rhs);
+  output.assign(buffer, result.ptr);
+  return true;
 }
 
+// Plain decimal integers: an optional '-', then no leading zero (which would
+// make the stream read octal) and nothing after the digits.  Out of range
+// values are left to the stream, which rejects them too.
 template <typename T>
-typename std::enable_if<!std::is_floating_point<T>::value, void>::type
-inner_encode(const T& rhs, std::stringstream& stream){
-  stream << rhs;
+typename std::enable_if<is_chars_integer<T>::value, bool>::type FromChars(
+    const std::string& input, T& rhs) {
+  const char* begin = input.data();
+  const char* end = begin + input.size();
+  const char* digits = (begin != end && *begin == '-') ? begin + 1 : begin;
+  if (digits == end || *digits < '0' || *digits > '9' ||
+      (*digits == '0' && end - digits > 1))
+    return false;
+  std::from_chars_result result = std::from_chars(begin, end, rhs);
+  return result.ec == std::errc() && result.ptr == end;
 }
 
+// Decimal floating point numbers.  std::from_chars also reads "inf", "nan"
+// and such, which the stream does not, so the number has to start with a
+// digit or a '.'; hex floats stop at the 'x' and are left to the stream.
+template <typename T>
+typename std::enable_if<is_chars_float<T>::value, bool>::type FromChars(
+    const std::string& input, T& rhs) {
+  const char* begin = input.data();
+  const char* end = begin + input.size();
+  const char* digits = (begin != end && *begin == '-') ? begin + 1 : begin;
+  if (digits == end || !((*digits >= '0' && *digits <= '9') || *digits == '.'))
+    return false;
+  std::from_chars_result result = std::from_chars(begin, end, rhs);
+  return result.ec == std::errc() && result.ptr == end;
+}
+#endif
+
 template <typename T>
 typename std::enable_if<(std::is_same<T, unsigned char>::value ||
                          std::is_same<T, signed char>::value), bool>::type
@@ -164,6 +258,70 @@ ConvertStreamTo(std::stringstream& stream, T& rhs) {
   }
   return false;
 }
+
+template <typename T>
+typename std::enable_if<std::numeric_limits<T>::has_infinity, bool>::type
+DecodeInfinity(const std::string& input, T& rhs) {
+  if (IsInfinity(input)) {
+    rhs = std::numeric_limits<T>::infinity();
+    return true;
+  }
+  if (IsNegativeInfinity(input)) {
+    rhs = -std::numeric_limits<T>::infinity();
+    return true;
+  }
+  return false;
+}
+
+template <typename T>
+typename std::enable_if<!std::numeric_limits<T>::has_infinity, bool>::type
+DecodeInfinity(const std::string& /* input */, T& /* rhs */) {
+  return false;
+}
+
+template <typename T>
+typename std::enable_if<std::numeric_limits<T>::has_quiet_NaN, bool>::type
+DecodeNaN(const std::string& input, T& rhs) {
+  if (IsNaN(input)) {
+    rhs = std::numeric_limits<T>::quiet_NaN();
+    return true;
+  }
+  return false;
+}
+
+template <typename T>
+typename std::enable_if<!std::numeric_limits<T>::has_quiet_NaN, bool>::type
+DecodeNaN(const std::string& /* input */, T& /* rhs */) {
+  return false;
+}
+
+/**
+ * Decodes the text of a scalar into an arithmetic type, accepting exactly
+ * what convert<T>::decode accepts for a scalar node with that text.  Lets
+ * event handlers convert scalars without building nodes.
+ */
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value &&
+                            !std::is_same<T, bool>::value,
+                        bool>::type
+DecodeScalar(const std::string& input, T& rhs) {
+  if (!input.empty() && input[0] == '-' && std::is_unsigned<T>::value) {
+    return false;
+  }
+  if (FromChars(input, rhs)) {
+    return true;
+  }
+  std::stringstream stream(input);
+  stream.imbue(std::locale::classic());
+  stream.unsetf(std::ios::dec);
+  if (ConvertStreamTo(stream, rhs)) {
+    return true;
+  }
+  return DecodeInfinity(input, rhs) || DecodeNaN(input, rhs);
+}
+
+/** Decodes the text of a scalar like convert<bool>::decode. */
+YAML_CPP_API bool DecodeScalar(const std::string& input, bool& rhs);
 }
 
 #define YAML_DEFINE_CONVERT_STREAMABLE(type, negative_op)                  \
@@ -171,10 +329,13 @@ ConvertStreamTo(std::stringstream& stream, T& rhs) {
   struct convert<type> {                                                   \
                                                                            \
     static Node encode(const type& rhs) {                                  \
+      std::string output;                                                  \
+      if (conversion::ToChars(rhs, output)) {                              \
+        return Node(output);                                               \
+      }                                                                    \
       std::stringstream stream;                                            \
       stream.imbue(std::locale::classic());                                \
-      stream.precision(std::numeric_limits<type>::max_digits10);           \
-      conversion::inner_encode(rhs, stream);                               \
+      stream << rhs;                                                       \
       return Node(stream.str());                                           \
     }                                                                      \
                                                                            \
@@ -182,34 +343,7 @@ ConvertStreamTo(std::stringstream& stream, T& rhs) {
       if (node.Type() != NodeType::Scalar) {                               \
         return false;                                                      \
       }                                                                    \
-      const std::string& input = node.Scalar();                            \
-      std::stringstream stream(input);                                     \
-      stream.imbue(std::locale::classic());                                \
-      stream.unsetf(std::ios::dec);                                        \
-      if ((stream.peek() == '-') && std::is_unsigned<type>::value) {       \
-        return false;                                                      \
-      }                                                                    \
-      if (conversion::ConvertStreamTo(stream, rhs)) {                      \
-        return true;                                                       \
-      }                                                                    \
-      if (std::numeric_limits<type>::has_infinity) {                       \
-        if (conversion::IsInfinity(input)) {                               \
-          rhs = std::numeric_limits<type>::infinity();                     \
-          return true;                                                     \
-        } else if (conversion::IsNegativeInfinity(input)) {                \
-          rhs = negative_op std::numeric_limits<type>::infinity();         \
-          return true;                                                     \
-        }                                                                  \
-      }                                                                    \
-                                                                           \
-      if (std::numeric_limits<type>::has_quiet_NaN) {                      \
-        if (conversion::IsNaN(input)) {                                    \
-          rhs = std::numeric_limits<type>::quiet_NaN();                    \
-          return true;                                                     \
-        }                                                                  \
-      }                                                                    \
-                                                                           \
-      return false;                                                        \
+      return conversion::DecodeScalar(node.Scalar(), rhs);                 \
     }                                                                      \
   }
 
@@ -11,7 +11,11 @@
 #include "yaml-cpp/node/detail/node_data.h"
 
 #include <algorithm>
+#include <cstring>
 #include <type_traits>
+#if ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+#include <string_view>
+#endif
 
 namespace YAML {
 namespace detail {
@@ -96,6 +100,44 @@ struct remove_idx<Key,
   }
 };
 
+// Keys that equal a map key exactly when that key is a scalar with the same
+// text, so they can be looked up in node_data's key index.
+template <typename Key>
+struct scalar_key {
+  static const bool value = false;
+  static const char* data(const Key&) { return nullptr; }
+  static std::size_t size(const Key&) { return 0; }
+};
+
+template <>
+struct scalar_key<std::string> {
+  static const bool value = true;
+  static const char* data(const std::string& key) { return key.data(); }
+  static std::size_t size(const std::string& key) { return key.size(); }
+};
+
+template <>
+struct scalar_key<const char*> {
+  static const bool value = true;
+  static const char* data(const char* key) { return key; }
+  static std::size_t size(const char* key) { return std::strlen(key); }
+};
+
+template <>
+struct scalar_key<char*> : scalar_key<const char*> {};
+
+template <std::size_t N>
+struct scalar_key<char[N]> : scalar_key<const char*> {};
+
+#if ((defined(_MSVC_LANG) && _MSVC_LANG >= 201703L) || __cplusplus >= 201703L)
+template <>
+struct scalar_key<std::string_view> {
+  static const bool value = true;
+  static const char* data(std::string_view key) { return key.data(); }
+  static std::size_t size(std::string_view key) { return key.size(); }
+};
+#endif
+
 template <typename T>
 inline bool node::equals(const T& rhs, shared_memory_holder pMemory) {
   T lhs;
@@ -114,6 +156,22 @@ inline bool node::equals(const char* rhs, shared_memory_holder pMemory) {
 }
 
 // indexing
+template <typename Key>
+inline std::size_t node_data::find_key(
+    const Key& key, const shared_memory_holder& pMemory) const {
+  std::size_t pos;
+  if (scalar_key<Key>::value &&
+      find_scalar_key(scalar_key<Key>::data(key), scalar_key<Key>::size(key),
+                      pos)) {
+    return pos;
+  }
+
+  auto it = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
+    return m.first->equals(key, pMemory);
+  });
+  return static_cast<std::size_t>(it - m_map.begin());
+}
+
 template <typename Key>
 inline node* node_data::get(const Key& key,
                             shared_memory_holder pMemory) const {
@@ -131,11 +189,8 @@ inline node* node_data::get(const Key& key,
       throw BadSubscript(m_mark, key);
   }
 
-  auto it = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
-    return m.first->equals(key, pMemory);
-  });
-
-  return it != m_map.end() ? it->second : nullptr;
+  std::size_t pos = find_key(key, pMemory);
+  return pos < m_map.size() ? m_map[pos].second : nullptr;
 }
 
 template <typename Key>
@@ -157,12 +212,9 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
       throw BadSubscript(m_mark, key);
   }
 
-  auto it = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
-    return m.first->equals(key, pMemory);
-  });
-
-  if (it != m_map.end()) {
-    return *it->second;
+  std::size_t pos = find_key(key, pMemory);
+  if (pos < m_map.size()) {
+    return *m_map[pos].second;
   }
 
   node& k = convert_to_node(key, pMemory);
@@ -187,12 +239,10 @@ inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
       it = jt;
     }
 
-    auto iter = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
-      return m.first->equals(key, pMemory);
-    });
-
-    if (iter != m_map.end()) {
-      m_map.erase(iter);
+    std::size_t pos = find_key(key, pMemory);
+    if (pos < m_map.size()) {
+      m_map.erase(m_map.begin() + pos);
+      clear_key_index();
       return true;
     }
   }
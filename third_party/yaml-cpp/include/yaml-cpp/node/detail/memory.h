@@ -7,6 +7,8 @@
 #pragma once
 #endif
 
+#include <cstddef>
+#include <memory>
 #include <set>
 
 #include "yaml-cpp/dll.h"
@@ -20,16 +22,33 @@ class node;
 
 namespace YAML {
 namespace detail {
+// Owns every node of a document.  Nodes are constructed in place inside
+// chunks whose capacity doubles up to a fixed maximum, so creating a node
+// is a bump of the current chunk instead of a separate allocation, and a
+// node's address never changes.
+//
+// Chunks are shared between memories: merge() adds the other memory's
+// chunks to this one (both keep them alive, as with the old per-node set),
+// so it costs one insertion per chunk rather than one per node.
 class YAML_CPP_API memory {
  public:
-  memory() : m_nodes{} {}
+  memory() : m_chunks{}, m_current(nullptr), m_nextCapacity(1) {}
+  memory(const memory&) = delete;
+  memory& operator=(const memory&) = delete;
   node& create_node();
   void merge(const memory& rhs);
+  // Number of nodes, counted over the chunks.
   size_t size() const;
+  std::size_t chunk_count() const { return m_chunks.size(); }
 
  private:
-  using Nodes = std::set<shared_node>;
-  Nodes m_nodes;
+  class chunk;
+  using shared_chunk = std::shared_ptr<chunk>;
+  using Chunks = std::set<shared_chunk>;
+
+  Chunks m_chunks;
+  chunk* m_current;
+  std::size_t m_nextCapacity;
 };
 
 class YAML_CPP_API memory_holder {
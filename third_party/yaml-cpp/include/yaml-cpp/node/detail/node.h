@@ -63,6 +63,7 @@ class node {
   void set_ref(const node& rhs) {
     if (rhs.is_defined())
       mark_defined();
+    m_pRef->key_changed();
     m_pRef = rhs.m_pRef;
   }
   void set_data(const node& rhs) {
@@ -164,6 +165,10 @@ class node {
     m_pRef->force_insert(key, value, pMemory);
   }
 
+  void mark_as_indexed_key(const node_data::key_generation& owner) const {
+    m_pRef->mark_as_indexed_key(owner);
+  }
+
  private:
   shared_node_ref m_pRef;
   using nodes = std::set<node*, less>;
@@ -7,8 +7,11 @@
 #pragma once
 #endif
 
+#include <atomic>
+#include <cstddef>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,6 +33,7 @@ namespace detail {
 class YAML_CPP_API node_data {
  public:
   node_data();
+  ~node_data();
   node_data(const node_data&) = delete;
   node_data& operator=(const node_data&) = delete;
 
@@ -80,6 +84,12 @@ class YAML_CPP_API node_data {
   void force_insert(const Key& key, const Value& value,
                     shared_memory_holder pMemory);
 
+  // key index: the data of a key of an indexed map reports any change that
+  // could alter its equality with a string to the generation of that map
+  using key_generation = std::shared_ptr<std::atomic<std::size_t>>;
+  void mark_as_indexed_key(const key_generation& owner) const;
+  void key_changed() const;
+
  public:
   static const std::string& empty_scalar();
 
@@ -91,6 +101,17 @@ class YAML_CPP_API node_data {
   void reset_map();
 
   void insert_map_pair(node& key, node& value);
+  template <typename Key>
+  std::size_t find_key(const Key& key,
+                       const shared_memory_holder& pMemory) const;
+  bool find_scalar_key(const char* key, std::size_t length,
+                       std::size_t& pos) const;
+  struct key_index;
+  key_index& get_key_index() const;
+  void rebuild_key_index(key_index& index) const;
+  void add_to_key_index(key_index& index, std::size_t pos) const;
+  void mark_indexed_keys(const key_index& index, std::size_t first) const;
+  void clear_key_index();
   void convert_to_map(const shared_memory_holder& pMemory);
   void convert_sequence_to_map(const shared_memory_holder& pMemory);
 
@@ -120,6 +141,16 @@ class YAML_CPP_API node_data {
   using kv_pair = std::pair<node*, node*>;
   using kv_pairs = std::list<kv_pair>;
   mutable kv_pairs m_undefinedPairs;
+
+  // Hash index over the scalar keys of large maps, used by lookups with
+  // string keys.  It is created on the first such lookup, extended as pairs
+  // are appended and dropped when a pair is removed or one of its keys
+  // changes.  Const lookups may race to create it, so it is installed
+  // atomically and guarded by its own mutex.
+  mutable std::atomic<key_index*> m_keyIndex;
+
+  // generation of the map this is a key of, if indexed
+  mutable key_generation m_keyOwner;
 };
 }
 }
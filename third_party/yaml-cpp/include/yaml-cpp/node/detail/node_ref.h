@@ -28,7 +28,14 @@ class node_ref {
   EmitterStyle::value style() const { return m_pData->style(); }
 
   void mark_defined() { m_pData->mark_defined(); }
-  void set_data(const node_ref& rhs) { m_pData = rhs.m_pData; }
+  void set_data(const node_ref& rhs) {
+    key_changed();
+    m_pData = rhs.m_pData;
+  }
+  void mark_as_indexed_key(const node_data::key_generation& owner) const {
+    m_pData->mark_as_indexed_key(owner);
+  }
+  void key_changed() const { m_pData->key_changed(); }
 
   void set_mark(const Mark& mark) { m_pData->set_mark(mark); }
   void set_type(NodeType::value type) { m_pData->set_type(type); }
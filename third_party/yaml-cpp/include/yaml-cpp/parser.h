@@ -7,13 +7,16 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <ios>
 #include <memory>
+#include <string>
 
 #include "yaml-cpp/dll.h"
 
 namespace YAML {
 class EventHandler;
+class MappedFile;
 class Node;
 class Scanner;
 struct Directives;
@@ -50,6 +53,20 @@ class YAML_CPP_API Parser {
    */
   void Load(std::istream& in);
 
+  /**
+   * Resets the parser with the given buffer, which is scanned in place. The
+   * buffer must live as long as the parser.
+   */
+  void Load(const char* data, std::size_t size);
+
+  /**
+   * Resets the parser with the contents of the given file, which is mapped
+   * (or read) and scanned in place until the parser is reset or destroyed.
+   *
+   * @throw a BadFile if the file cannot be opened.
+   */
+  void LoadFile(const std::string& filename);
+
   /**
    * Handles the next document by calling events on the {@code eventHandler}.
    *
@@ -82,6 +99,12 @@ class YAML_CPP_API Parser {
   void HandleTagDirective(const Token& token);
 
  private:
+  struct Input;
+
+  // The input the parser owns, if any; declared first so that the scanner
+  // reading it goes away before it does.
+  std::unique_ptr<MappedFile> m_pFile;
+  std::unique_ptr<Input> m_pInput;
   std::unique_ptr<Scanner> m_pScanner;
   std::unique_ptr<Directives> m_pDirectives;
 };
@@ -38,10 +38,7 @@ bool IsFlexibleCase(const std::string& str) {
 }  // namespace
 
 namespace YAML {
-bool convert<bool>::decode(const Node& node, bool& rhs) {
-  if (!node.IsScalar())
-    return false;
-
+bool conversion::DecodeScalar(const std::string& input, bool& rhs) {
   // we can't use iostream bool extraction operators as they don't
   // recognize all possible values in the table below (taken from
   // http://yaml.org/type/bool.html)
@@ -54,16 +51,17 @@ bool convert<bool>::decode(const Node& node, bool& rhs) {
       {"on", "off"},
   };
 
-  if (!IsFlexibleCase(node.Scalar()))
+  if (!IsFlexibleCase(input))
     return false;
 
+  const std::string lower = tolower(input);
   for (const auto& name : names) {
-    if (name.truename == tolower(node.Scalar())) {
+    if (name.truename == lower) {
       rhs = true;
       return true;
     }
 
-    if (name.falsename == tolower(node.Scalar())) {
+    if (name.falsename == lower) {
       rhs = false;
       return true;
     }
@@ -71,4 +69,11 @@ bool convert<bool>::decode(const Node& node, bool& rhs) {
 
   return false;
 }
+
+bool convert<bool>::decode(const Node& node, bool& rhs) {
+  if (!node.IsScalar())
+    return false;
+
+  return conversion::DecodeScalar(node.Scalar(), rhs);
+}
 }  // namespace YAML
@@ -1,5 +1,14 @@
 #include <sstream>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YAML_CPP_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(YAML_CPP_SSE2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include "exp.h"
 #include "stream.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
@@ -10,6 +19,119 @@ struct Mark;
 
 namespace YAML {
 namespace Exp {
+namespace {
+constexpr bool IsOneOf(const char* chars, int ch) {
+  return *chars != 0 &&
+         (static_cast<unsigned char>(*chars) == ch || IsOneOf(chars + 1, ch));
+}
+
+constexpr unsigned char Classify(int ch) {
+  return static_cast<unsigned char>(
+      (ch == ' ' || ch == '\t' ? CC_BLANK : 0) |
+      (ch == '\n' || ch == '\r' ? CC_BREAK : 0) |
+      (ch >= '0' && ch <= '9' ? CC_DIGIT | CC_HEX | CC_WORD : 0) |
+      ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z')
+           ? CC_ALPHA | CC_WORD
+           : 0) |
+      ((ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F') ? CC_HEX : 0) |
+      (ch == '-' ? CC_WORD : 0) |
+      (IsOneOf(",[]{}#&*!|>\'\"%@`", ch) ? CC_INDICATOR : 0) |
+      (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == 0 ||
+               ch == Stream::eof() || IsOneOf(":,?[]{}\'\"\\", ch)
+           ? CC_SCALAR_STOP
+           : 0));
+}
+}  // namespace
+
+#define YAML_CLASSIFY4(n) \
+  Classify(n), Classify(n + 1), Classify(n + 2), Classify(n + 3)
+#define YAML_CLASSIFY16(n)                                     \
+  YAML_CLASSIFY4(n), YAML_CLASSIFY4(n + 4), YAML_CLASSIFY4(n + 8), \
+      YAML_CLASSIFY4(n + 12)
+#define YAML_CLASSIFY64(n)                                           \
+  YAML_CLASSIFY16(n), YAML_CLASSIFY16(n + 16), YAML_CLASSIFY16(n + 32), \
+      YAML_CLASSIFY16(n + 48)
+
+const unsigned char CharClasses[256] = {YAML_CLASSIFY64(0), YAML_CLASSIFY64(64),
+                                        YAML_CLASSIFY64(128),
+                                        YAML_CLASSIFY64(192)};
+
+#undef YAML_CLASSIFY64
+#undef YAML_CLASSIFY16
+#undef YAML_CLASSIFY4
+
+#ifdef YAML_CPP_SSE2
+namespace {
+inline std::size_t LowestBit(unsigned mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return static_cast<std::size_t>(__builtin_ctz(mask));
+#endif
+}
+
+inline __m128i Equal(__m128i bytes, char ch) {
+  return _mm_cmpeq_epi8(bytes, _mm_set1_epi8(ch));
+}
+
+// Bytes that may be scalar stops: everything up to ' ' (blanks, breaks, NUL,
+// eof and other control characters) and : , ? ' " \ [ ] { }.  OR-ing in
+// 0x20 folds '[' into '{' and ']' into '}'.
+inline unsigned ScalarStopMask(__m128i bytes) {
+  __m128i space = _mm_set1_epi8(' ');
+  __m128i stops = _mm_cmpeq_epi8(_mm_min_epu8(bytes, space), bytes);
+  stops = _mm_or_si128(stops, Equal(bytes, ':'));
+  stops = _mm_or_si128(stops, Equal(bytes, ','));
+  stops = _mm_or_si128(stops, Equal(bytes, '?'));
+  stops = _mm_or_si128(stops, Equal(bytes, '\''));
+  stops = _mm_or_si128(stops, Equal(bytes, '"'));
+  stops = _mm_or_si128(stops, Equal(bytes, '\\'));
+  __m128i folded = _mm_or_si128(bytes, space);
+  stops = _mm_or_si128(stops, Equal(folded, '{'));
+  stops = _mm_or_si128(stops, Equal(folded, '}'));
+  return static_cast<unsigned>(_mm_movemask_epi8(stops));
+}
+
+inline unsigned BreakOrEofMask(__m128i bytes) {
+  __m128i found = _mm_or_si128(Equal(bytes, '\n'), Equal(bytes, '\r'));
+  found = _mm_or_si128(found, Equal(bytes, Stream::eof()));
+  return static_cast<unsigned>(_mm_movemask_epi8(found));
+}
+}  // namespace
+#endif
+
+std::size_t FindScalarStop(const char* begin, const char* end) {
+  const char* p = begin;
+#ifdef YAML_CPP_SSE2
+  for (; end - p >= 16; p += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    unsigned mask = ScalarStopMask(bytes);
+    if (mask)
+      return static_cast<std::size_t>(p - begin) + LowestBit(mask);
+  }
+#endif
+  while (p != end && !IsScalarStop(*p))
+    ++p;
+  return static_cast<std::size_t>(p - begin);
+}
+
+std::size_t FindBreakOrEof(const char* begin, const char* end) {
+  const char* p = begin;
+#ifdef YAML_CPP_SSE2
+  for (; end - p >= 16; p += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    unsigned mask = BreakOrEofMask(bytes);
+    if (mask)
+      return static_cast<std::size_t>(p - begin) + LowestBit(mask);
+  }
+#endif
+  while (p != end && !IsBreak(*p) && *p != Stream::eof())
+    ++p;
+  return static_cast<std::size_t>(p - begin);
+}
+
 unsigned ParseHex(const std::string& str, const Mark& mark) {
   unsigned value = 0;
   for (char ch : str) {
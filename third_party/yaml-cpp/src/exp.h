@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <ios>
 #include <string>
 
@@ -19,6 +20,107 @@ namespace YAML {
 // file.
 
 namespace Exp {
+// Single-character classes, as bits of CharClasses[(unsigned char)ch].  The
+// scanner tests these per character instead of walking the RegEx trees below.
+enum CharClass : unsigned char {
+  CC_BLANK = 1,       // ' ' '\t'
+  CC_BREAK = 2,       // '\n' '\r'
+  CC_DIGIT = 4,       // 0-9
+  CC_ALPHA = 8,       // a-z A-Z
+  CC_HEX = 16,        // 0-9 a-f A-F
+  CC_WORD = 32,       // alphanumeric and '-'
+  CC_INDICATOR = 64,  // , [ ] { } # & * ! | > ' " % @ `
+  // Anything that may end, escape or break a scalar in ScanScalar: blanks,
+  // breaks, : , ? [ ] { } ' " \, NUL and Stream::eof().
+  CC_SCALAR_STOP = 128
+};
+extern const unsigned char CharClasses[256];
+
+inline bool HasClass(char ch, unsigned char classes) {
+  return (CharClasses[static_cast<unsigned char>(ch)] & classes) != 0;
+}
+inline bool IsBlank(char ch) { return HasClass(ch, CC_BLANK); }
+inline bool IsBreak(char ch) { return HasClass(ch, CC_BREAK); }
+inline bool IsBlankOrBreak(char ch) { return HasClass(ch, CC_BLANK | CC_BREAK); }
+inline bool IsDigit(char ch) { return HasClass(ch, CC_DIGIT); }
+inline bool IsAlphaNumeric(char ch) { return HasClass(ch, CC_ALPHA | CC_DIGIT); }
+inline bool IsWord(char ch) { return HasClass(ch, CC_WORD); }
+inline bool IsHex(char ch) { return HasClass(ch, CC_HEX); }
+inline bool IsScalarStop(char ch) { return HasClass(ch, CC_SCALAR_STOP); }
+
+// Bulk scans over [begin, end), 16 bytes at a time with SSE2.  Each returns
+// the offset of the first byte of interest, or end - begin if there is none.
+// FindScalarStop may also stop at other control characters, so callers
+// classify the byte it stops at again.
+std::size_t FindScalarStop(const char* begin, const char* end);
+// '\n', '\r' or Stream::eof()
+std::size_t FindBreakOrEof(const char* begin, const char* end);
+
+// Hand-written matchers for the patterns tested at every token.  Each one
+// agrees with the RegEx of the same name below.
+
+// Length of the line break at the start of `in`, or -1 (Break()).
+inline int MatchBreak(const Stream& in) {
+  char ch = in.peek();
+  if (ch == '\n')
+    return 1;
+  if (ch == '\r')
+    return in.peek(1) == '\n' ? 2 : 1;
+  return -1;
+}
+// A blank, a break or the end of the stream at `i`.
+inline bool IsSeparatorAt(const Stream& in, std::size_t i) {
+  char ch = in.peek(i);
+  return IsBlankOrBreak(ch) || ch == Stream::eof();
+}
+inline bool MatchesThreeAndSeparator(const Stream& in, char ch) {
+  return in.peek() == ch && in.peek(1) == ch && in.peek(2) == ch &&
+         IsSeparatorAt(in, 3);
+}
+inline bool MatchesDocStart(const Stream& in) {
+  return MatchesThreeAndSeparator(in, '-');
+}
+inline bool MatchesDocEnd(const Stream& in) {
+  return MatchesThreeAndSeparator(in, '.');
+}
+inline bool MatchesDocIndicator(const Stream& in) {
+  return MatchesDocStart(in) || MatchesDocEnd(in);
+}
+inline bool MatchesBlockEntry(const Stream& in) {
+  return in.peek() == '-' && IsSeparatorAt(in, 1);
+}
+// Key() and KeyInFlow()
+inline bool MatchesKey(const Stream& in) {
+  return in.peek() == '?' && IsBlankOrBreak(in.peek(1));
+}
+inline bool MatchesValue(const Stream& in) {
+  return in.peek() == ':' && IsSeparatorAt(in, 1);
+}
+inline bool MatchesValueInFlow(const Stream& in) {
+  if (in.peek() != ':')
+    return false;
+  char ch = in.peek(1);
+  return IsBlankOrBreak(ch) || ch == ',' || ch == ']' || ch == '}';
+}
+inline bool MatchesEscBreak(const Stream& in) {
+  return in.peek() == '\\' && IsBreak(in.peek(1));
+}
+inline bool MatchesPlainScalar(const Stream& in) {
+  char ch = in.peek();
+  if (HasClass(ch, CC_BLANK | CC_BREAK | CC_INDICATOR))
+    return false;
+  return !((ch == '-' || ch == '?' || ch == ':') && IsSeparatorAt(in, 1));
+}
+inline bool MatchesPlainScalarInFlow(const Stream& in) {
+  char ch = in.peek();
+  if (ch == '?' || HasClass(ch, CC_BLANK | CC_BREAK | CC_INDICATOR))
+    return false;
+  if (ch != '-' && ch != ':')
+    return true;
+  ch = in.peek(1);
+  return !(IsBlank(ch) || ch == Stream::eof());
+}
+
 // misc
 inline const RegEx& Empty() {
   static const RegEx e;
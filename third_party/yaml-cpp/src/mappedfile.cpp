@@ -0,0 +1,114 @@
+#include "mappedfile.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace YAML {
+MappedFile::MappedFile()
+    : m_data(nullptr), m_size(0), m_mapping(nullptr), m_buffer{} {}
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Open(const std::string& filename) {
+  Close();
+  return Map(filename) || Read(filename);
+}
+
+#if defined(_WIN32)
+bool MappedFile::Map(const std::string& filename) {
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER size;
+  void* view = nullptr;
+  if (GetFileSizeEx(file, &size) && size.QuadPart > 0 &&
+      static_cast<unsigned long long>(size.QuadPart) <= SIZE_MAX) {
+    HANDLE mapping =
+        CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+      view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      // The view keeps the mapping alive.
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+  if (view == nullptr)
+    return false;
+  m_mapping = view;
+  m_data = static_cast<const char*>(view);
+  m_size = static_cast<std::size_t>(size.QuadPart);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (m_mapping != nullptr)
+    UnmapViewOfFile(m_mapping);
+  m_mapping = nullptr;
+  m_data = nullptr;
+  m_size = 0;
+  m_buffer.clear();
+}
+#else
+bool MappedFile::Map(const std::string& filename) {
+  int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  void* p = MAP_FAILED;
+  // Only regular files can be mapped; a zero-length mapping is an error.
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ,
+             MAP_PRIVATE, fd, 0);
+  }
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (p == MAP_FAILED)
+    return false;
+#ifdef MADV_SEQUENTIAL
+  madvise(p, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+#endif
+  m_mapping = p;
+  m_data = static_cast<const char*>(p);
+  m_size = static_cast<std::size_t>(st.st_size);
+  return true;
+}
+
+void MappedFile::Close() {
+  if (m_mapping != nullptr)
+    munmap(m_mapping, m_size);
+  m_mapping = nullptr;
+  m_data = nullptr;
+  m_size = 0;
+  m_buffer.clear();
+}
+#endif
+
+bool MappedFile::Read(const std::string& filename) {
+  std::ifstream fin(filename, std::ios_base::in | std::ios_base::binary);
+  if (!fin)
+    return false;
+  m_buffer.assign(std::istreambuf_iterator<char>(fin),
+                  std::istreambuf_iterator<char>());
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+  return true;
+}
+}  // namespace YAML
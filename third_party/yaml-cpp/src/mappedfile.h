@@ -0,0 +1,42 @@
+#ifndef MAPPEDFILE_H_ED674038_4065_4394_A384_6031BCC0662B
+#define MAPPEDFILE_H_ED674038_4065_4394_A384_6031BCC0662B
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace YAML {
+// The contents of a file, memory-mapped when possible.  Files that cannot be
+// mapped (pipes, empty files, ...) are read into a buffer instead.
+class MappedFile {
+ public:
+  MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  // Returns false if the file cannot be opened.
+  bool Open(const std::string& filename);
+
+  const char* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+
+ private:
+  bool Map(const std::string& filename);
+  bool Read(const std::string& filename);
+  void Close();
+
+  const char* m_data;
+  std::size_t m_size;
+  void* m_mapping;
+  std::vector<char> m_buffer;
+};
+}  // namespace YAML
+
+#endif  // MAPPEDFILE_H_ED674038_4065_4394_A384_6031BCC0662B
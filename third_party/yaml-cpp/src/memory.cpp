@@ -1,3 +1,5 @@
+#include <new>
+
 #include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node.h"  // IWYU pragma: keep
 #include "yaml-cpp/node/ptr.h"
@@ -5,11 +7,52 @@
 namespace YAML {
 namespace detail {
 
+namespace {
+// Largest chunk, in nodes; bigger documents just use more chunks.
+const std::size_t kMaxChunkCapacity = 1024;
+}  // namespace
+
+// Fixed-capacity block of nodes, constructed in order and destroyed
+// together.
+class memory::chunk {
+ public:
+  explicit chunk(std::size_t capacity)
+      : m_slots(new slot[capacity]), m_capacity(capacity), m_size(0) {}
+  chunk(const chunk&) = delete;
+  chunk& operator=(const chunk&) = delete;
+
+  ~chunk() {
+    for (std::size_t i = m_size; i > 0; --i)
+      at(i - 1)->~node();
+  }
+
+  bool full() const { return m_size == m_capacity; }
+  std::size_t size() const { return m_size; }
+
+  node& allocate() {
+    node* pNode = new (&m_slots[m_size]) node;
+    ++m_size;
+    return *pNode;
+  }
+
+ private:
+  struct alignas(node) slot {
+    unsigned char bytes[sizeof(node)];
+  };
+
+  node* at(std::size_t i) { return reinterpret_cast<node*>(&m_slots[i]); }
+
+  std::unique_ptr<slot[]> m_slots;
+  std::size_t m_capacity;
+  std::size_t m_size;
+};
+
 void memory_holder::merge(memory_holder& rhs) {
   if (m_pMemory == rhs.m_pMemory)
     return;
 
-  if (m_pMemory->size() < rhs.m_pMemory->size()) {
+  // Merging costs one insertion per chunk, so keep the memory with more.
+  if (m_pMemory->chunk_count() < rhs.m_pMemory->chunk_count()) {
     std::swap(m_pMemory, rhs.m_pMemory);
   }
 
@@ -18,17 +61,29 @@ void memory_holder::merge(memory_holder& rhs) {
 }
 
 node& memory::create_node() {
-  shared_node pNode(new node);
-  m_nodes.insert(pNode);
-  return *pNode;
+  if (m_current == nullptr || m_current->full()) {
+    shared_chunk pChunk = std::make_shared<chunk>(m_nextCapacity);
+    m_chunks.insert(pChunk);
+    m_current = pChunk.get();
+    if (m_nextCapacity < kMaxChunkCapacity)
+      m_nextCapacity *= 2;
+  }
+  return m_current->allocate();
 }
 
 void memory::merge(const memory& rhs) {
-  m_nodes.insert(rhs.m_nodes.begin(), rhs.m_nodes.end());
+  // A memory that was merged before can still be reached through another
+  // holder, so some of its chunks may already be here.
+  m_chunks.insert(rhs.m_chunks.begin(), rhs.m_chunks.end());
 }
 
+// Counted from the chunks: a shared chunk keeps growing while the memory
+// that created it allocates, so a running total would go stale.
 size_t memory::size() const {
-    return m_nodes.size();
+  std::size_t total = 0;
+  for (const shared_chunk& pChunk : m_chunks)
+    total += pChunk->size();
+  return total;
 }
 }  // namespace detail
 }  // namespace YAML
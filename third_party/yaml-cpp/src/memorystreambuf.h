@@ -0,0 +1,36 @@
+#ifndef MEMORYSTREAMBUF_H_0ABE072C_8A0B_4BFA_B97C_C40D57DE4A43
+#define MEMORYSTREAMBUF_H_0ABE072C_8A0B_4BFA_B97C_C40D57DE4A43
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <streambuf>
+
+namespace YAML {
+// A read-only streambuf over bytes that stay alive for the whole parse (an
+// std::string, a mapped file, ...).  Stream recognizes it and scans UTF-8
+// input in place instead of copying it through the readahead.
+class MemoryStreamBuf : public std::streambuf {
+ public:
+  MemoryStreamBuf(const char* data, std::size_t size) {
+    // The get area is never written to.
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+  MemoryStreamBuf(const MemoryStreamBuf&) = delete;
+  MemoryStreamBuf& operator=(const MemoryStreamBuf&) = delete;
+
+  // Hands out the bytes not read yet and marks them as read.
+  void TakeRest(const char*& begin, const char*& end) {
+    begin = gptr();
+    end = egptr();
+    setg(eback(), egptr(), egptr());
+  }
+};
+}  // namespace YAML
+
+#endif  // MEMORYSTREAMBUF_H_0ABE072C_8A0B_4BFA_B97C_C40D57DE4A43
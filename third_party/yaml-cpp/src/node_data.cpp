@@ -1,6 +1,9 @@
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstring>
 #include <iterator>
+#include <mutex>
 #include <sstream>
 
 #include "yaml-cpp/exceptions.h"
@@ -15,6 +18,64 @@ namespace YAML {
 namespace detail {
 YAML_CPP_API std::atomic<size_t> node::m_amount{0};
 
+namespace {
+// Maps smaller than this are searched linearly.
+const std::size_t kKeyIndexMinSize = 16;
+
+// Generation of the keys indexed by more than one map.  A change to any of
+// them makes every index stale.
+const node_data::key_generation& SharedKeyGeneration() {
+  static const node_data::key_generation generation =
+      std::make_shared<std::atomic<std::size_t>>(0);
+  return generation;
+}
+
+// Guards m_keyOwner of the keys, which maps indexed from different threads
+// may share.
+std::mutex& KeyOwnerMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::size_t HashKey(const char* key, std::size_t length) {
+  // FNV-1a
+  std::size_t hash = static_cast<std::size_t>(14695981039346656037ULL);
+  for (std::size_t i = 0; i < length; i++) {
+    hash ^= static_cast<unsigned char>(key[i]);
+    hash *= static_cast<std::size_t>(1099511628211ULL);
+  }
+  return hash;
+}
+
+bool ScalarKeyEquals(const node& key, const char* text, std::size_t length) {
+  if (key.type() != NodeType::Scalar)
+    return false;
+  const std::string& scalar = key.scalar();
+  return scalar.size() == length &&
+         std::memcmp(scalar.data(), text, length) == 0;
+}
+}  // namespace
+
+// Open addressing; each slot holds a position in m_map plus one, or zero if
+// empty.  The generations are those of the map and of the shared keys when
+// the index was built.
+struct node_data::key_index {
+  key_index()
+      : mutex{},
+        slots{},
+        indexed(0),
+        generation(0),
+        sharedGeneration(0),
+        changes(std::make_shared<std::atomic<std::size_t>>(0)) {}
+
+  std::mutex mutex;
+  std::vector<std::size_t> slots;
+  std::size_t indexed;
+  std::size_t generation;
+  std::size_t sharedGeneration;
+  key_generation changes;
+};
+
 const std::string& node_data::empty_scalar() {
   static const std::string svalue;
   return svalue;
@@ -30,9 +91,15 @@ node_data::node_data()
       m_sequence{},
       m_seqSize(0),
       m_map{},
-      m_undefinedPairs{} {}
+      m_undefinedPairs{},
+      m_keyIndex{nullptr},
+      m_keyOwner{} {}
+
+node_data::~node_data() { delete m_keyIndex.load(); }
 
 void node_data::mark_defined() {
+  if (!m_isDefined)
+    key_changed();
   if (m_type == NodeType::Undefined)
     m_type = NodeType::Null;
   m_isDefined = true;
@@ -41,6 +108,7 @@ void node_data::mark_defined() {
 void node_data::set_mark(const Mark& mark) { m_mark = mark; }
 
 void node_data::set_type(NodeType::value type) {
+  key_changed();
   if (type == NodeType::Undefined) {
     m_type = type;
     m_isDefined = false;
@@ -76,11 +144,13 @@ void node_data::set_tag(const std::string& tag) { m_tag = tag; }
 void node_data::set_style(EmitterStyle::value style) { m_style = style; }
 
 void node_data::set_null() {
+  key_changed();
   m_isDefined = true;
   m_type = NodeType::Null;
 }
 
 void node_data::set_scalar(const std::string& scalar) {
+  key_changed();
   m_isDefined = true;
   m_type = NodeType::Scalar;
   m_scalar = scalar;
@@ -263,6 +333,7 @@ bool node_data::remove(node& key, const shared_memory_holder& /* pMemory */) {
 
   if (it != m_map.end()) {
     m_map.erase(it);
+    clear_key_index();
     return true;
   }
 
@@ -277,6 +348,7 @@ void node_data::reset_sequence() {
 void node_data::reset_map() {
   m_map.clear();
   m_undefinedPairs.clear();
+  clear_key_index();
 }
 
 void node_data::insert_map_pair(node& key, node& value) {
@@ -286,6 +358,109 @@ void node_data::insert_map_pair(node& key, node& value) {
     m_undefinedPairs.emplace_back(&key, &value);
 }
 
+void node_data::mark_as_indexed_key(const key_generation& owner) const {
+  if (!m_keyOwner)
+    m_keyOwner = owner;
+  else if (m_keyOwner != owner)
+    m_keyOwner = SharedKeyGeneration();
+}
+
+void node_data::key_changed() const {
+  if (m_keyOwner)
+    ++*m_keyOwner;
+}
+
+node_data::key_index& node_data::get_key_index() const {
+  key_index* pIndex = m_keyIndex.load(std::memory_order_acquire);
+  if (!pIndex) {
+    std::unique_ptr<key_index> pCreated(new key_index);
+    if (m_keyIndex.compare_exchange_strong(pIndex, pCreated.get(),
+                                           std::memory_order_acq_rel)) {
+      pIndex = pCreated.release();
+    }
+  }
+  return *pIndex;
+}
+
+void node_data::clear_key_index() {
+  if (key_index* pIndex = m_keyIndex.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(pIndex->mutex);
+    pIndex->slots.clear();
+  }
+}
+
+bool node_data::find_scalar_key(const char* key, std::size_t length,
+                                std::size_t& pos) const {
+  if (m_map.size() < kKeyIndexMinSize)
+    return false;
+
+  key_index& index = get_key_index();
+  std::lock_guard<std::mutex> lock(index.mutex);
+  if (index.slots.empty() || index.generation != index.changes->load() ||
+      index.sharedGeneration != SharedKeyGeneration()->load()) {
+    rebuild_key_index(index);
+  } else if (index.indexed < m_map.size()) {
+    // pairs appended since the last lookup
+    if (m_map.size() * 2 > index.slots.size()) {
+      rebuild_key_index(index);
+    } else {
+      const std::size_t first = index.indexed;
+      for (; index.indexed < m_map.size(); index.indexed++)
+        add_to_key_index(index, index.indexed);
+      mark_indexed_keys(index, first);
+    }
+  }
+
+  const std::size_t mask = index.slots.size() - 1;
+  for (std::size_t i = HashKey(key, length) & mask; index.slots[i] != 0;
+       i = (i + 1) & mask) {
+    std::size_t candidate = index.slots[i] - 1;
+    if (ScalarKeyEquals(*m_map[candidate].first, key, length)) {
+      pos = candidate;
+      return true;
+    }
+  }
+  pos = m_map.size();
+  return true;
+}
+
+void node_data::rebuild_key_index(key_index& index) const {
+  std::size_t capacity = 2 * kKeyIndexMinSize;
+  while (capacity < 2 * m_map.size())
+    capacity *= 2;
+  index.slots.assign(capacity, 0);
+  index.generation = index.changes->load();
+  index.sharedGeneration = SharedKeyGeneration()->load();
+  for (index.indexed = 0; index.indexed < m_map.size(); index.indexed++)
+    add_to_key_index(index, index.indexed);
+  mark_indexed_keys(index, 0);
+}
+
+// Only the first of several equal keys is kept, which is the one a linear
+// search would find.
+void node_data::add_to_key_index(key_index& index, std::size_t pos) const {
+  const node& key = *m_map[pos].first;
+  if (key.type() != NodeType::Scalar)
+    return;
+
+  const std::string& scalar = key.scalar();
+  const std::size_t mask = index.slots.size() - 1;
+  std::size_t i = HashKey(scalar.data(), scalar.size()) & mask;
+  for (; index.slots[i] != 0; i = (i + 1) & mask) {
+    if (ScalarKeyEquals(*m_map[index.slots[i] - 1].first, scalar.data(),
+                        scalar.size()))
+      return;
+  }
+  index.slots[i] = pos + 1;
+}
+
+void node_data::mark_indexed_keys(const key_index& index,
+                                  std::size_t first) const {
+  std::lock_guard<std::mutex> lock(KeyOwnerMutex());
+  for (std::size_t pos = first; pos < m_map.size(); pos++)
+    m_map[pos].first->mark_as_indexed_key(index.changes);
+}
+
 void node_data::convert_to_map(const shared_memory_holder& pMemory) {
   switch (m_type) {
     case NodeType::Undefined:
@@ -1,8 +1,10 @@
 #include "yaml-cpp/node/parse.h"
 
-#include <fstream>
-#include <sstream>
+#include <cstring>
+#include <istream>
 
+#include "mappedfile.h"
+#include "memorystreambuf.h"
 #include "nodebuilder.h"
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/node.h"
@@ -10,12 +12,14 @@
 
 namespace YAML {
 Node Load(const std::string& input) {
-  std::stringstream stream(input);
+  MemoryStreamBuf buffer(input.data(), input.size());
+  std::istream stream(&buffer);
   return Load(stream);
 }
 
 Node Load(const char* input) {
-  std::stringstream stream(input);
+  MemoryStreamBuf buffer(input, std::strlen(input));
+  std::istream stream(&buffer);
   return Load(stream);
 }
 
@@ -29,21 +33,27 @@ Node Load(std::istream& input) {
   return builder.Root();
 }
 
+// The file is mapped (or read) only while it is parsed; nodes own copies of
+// their scalars.
 Node LoadFile(const std::string& filename) {
-  std::ifstream fin(filename);
-  if (!fin) {
+  MappedFile file;
+  if (!file.Open(filename)) {
     throw BadFile(filename);
   }
-  return Load(fin);
+  MemoryStreamBuf buffer(file.data(), file.size());
+  std::istream stream(&buffer);
+  return Load(stream);
 }
 
 std::vector<Node> LoadAll(const std::string& input) {
-  std::stringstream stream(input);
+  MemoryStreamBuf buffer(input.data(), input.size());
+  std::istream stream(&buffer);
   return LoadAll(stream);
 }
 
 std::vector<Node> LoadAll(const char* input) {
-  std::stringstream stream(input);
+  MemoryStreamBuf buffer(input, std::strlen(input));
+  std::istream stream(&buffer);
   return LoadAll(stream);
 }
 
@@ -63,10 +73,12 @@ std::vector<Node> LoadAll(std::istream& input) {
 }
 
 std::vector<Node> LoadAllFromFile(const std::string& filename) {
-  std::ifstream fin(filename);
-  if (!fin) {
+  MappedFile file;
+  if (!file.Open(filename)) {
     throw BadFile(filename);
   }
-  return LoadAll(fin);
+  MemoryStreamBuf buffer(file.data(), file.size());
+  std::istream stream(&buffer);
+  return LoadAll(stream);
 }
 }  // namespace YAML
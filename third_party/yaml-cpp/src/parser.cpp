@@ -1,7 +1,10 @@
 #include <cstdio>
+#include <istream>
 #include <sstream>
 
 #include "directives.h"  // IWYU pragma: keep
+#include "mappedfile.h"
+#include "memorystreambuf.h"
 #include "scanner.h"     // IWYU pragma: keep
 #include "singledocparser.h"
 #include "token.h"
@@ -11,7 +14,16 @@
 namespace YAML {
 class EventHandler;
 
-Parser::Parser() : m_pScanner{}, m_pDirectives{} {}
+struct Parser::Input {
+  Input(const char* data, std::size_t size)
+      : buffer(data, size), stream(&buffer) {}
+
+  MemoryStreamBuf buffer;
+  std::istream stream;
+};
+
+Parser::Parser()
+    : m_pFile{}, m_pInput{}, m_pScanner{}, m_pDirectives{} {}
 
 Parser::Parser(std::istream& in) : Parser() { Load(in); }
 
@@ -22,6 +34,23 @@ Parser::operator bool() const { return m_pScanner && !m_pScanner->empty(); }
 void Parser::Load(std::istream& in) {
   m_pScanner.reset(new Scanner(in));
   m_pDirectives.reset(new Directives);
+  m_pInput.reset();
+  m_pFile.reset();
+}
+
+void Parser::Load(const char* data, std::size_t size) {
+  std::unique_ptr<Input> pInput(new Input(data, size));
+  Load(pInput->stream);
+  m_pInput = std::move(pInput);
+}
+
+void Parser::LoadFile(const std::string& filename) {
+  std::unique_ptr<MappedFile> pFile(new MappedFile);
+  if (!pFile->Open(filename)) {
+    throw BadFile(filename);
+  }
+  Load(pFile->data(), pFile->size());
+  m_pFile = std::move(pFile);
 }
 
 bool Parser::HandleNextDocument(EventHandler& eventHandler) {
@@ -1,5 +1,4 @@
 #include <cassert>
-#include <memory>
 
 #include "exp.h"
 #include "scanner.h"
@@ -17,8 +16,10 @@ Scanner::Scanner(std::istream& in)
       m_canBeJSONFlow(false),
       m_simpleKeys{},
       m_indents{},
-      m_indentRefs{},
-      m_flows{} {}
+      m_flows{},
+      m_indentPool{},
+      m_freeIndents{},
+      m_poppedIndents{} {}
 
 Scanner::~Scanner() = default;
 
@@ -109,11 +110,11 @@ void Scanner::ScanNextToken() {
   }
 
   // document token
-  if (INPUT.column() == 0 && Exp::DocStart().Matches(INPUT)) {
+  if (INPUT.column() == 0 && Exp::MatchesDocStart(INPUT)) {
     return ScanDocStart();
   }
 
-  if (INPUT.column() == 0 && Exp::DocEnd().Matches(INPUT)) {
+  if (INPUT.column() == 0 && Exp::MatchesDocEnd(INPUT)) {
     return ScanDocEnd();
   }
 
@@ -143,15 +144,15 @@ void Scanner::ScanNextToken() {
   }
 
   // block/map stuff
-  if (Exp::BlockEntry().Matches(INPUT)) {
+  if (Exp::MatchesBlockEntry(INPUT)) {
     return ScanBlockEntry();
   }
 
-  if ((InBlockContext() ? Exp::Key() : Exp::KeyInFlow()).Matches(INPUT)) {
+  if (Exp::MatchesKey(INPUT)) {
     return ScanKey();
   }
 
-  if (GetValueRegex().Matches(INPUT)) {
+  if (MatchesValue()) {
     return ScanValue();
   }
 
@@ -183,8 +184,8 @@ void Scanner::ScanNextToken() {
   }
 
   // plain scalars
-  if ((InBlockContext() ? Exp::PlainScalar() : Exp::PlainScalarInFlow())
-          .Matches(INPUT)) {
+  if (InBlockContext() ? Exp::MatchesPlainScalar(INPUT)
+                       : Exp::MatchesPlainScalarInFlow(INPUT)) {
     return ScanPlainScalar();
   }
 
@@ -196,27 +197,30 @@ void Scanner::ScanToNextToken() {
   while (true) {
     // first eat whitespace
     while (INPUT && IsWhitespaceToBeEaten(INPUT.peek())) {
-      if (InBlockContext() && Exp::Tab().Matches(INPUT)) {
+      if (InBlockContext() && INPUT.peek() == '\t') {
         m_simpleKeyAllowed = false;
       }
       INPUT.eat(1);
     }
 
     // then eat a comment
-    if (Exp::Comment().Matches(INPUT)) {
+    if (INPUT.peek() == '#') {
       // eat until line break
-      while (INPUT && !Exp::Break().Matches(INPUT)) {
-        INPUT.eat(1);
+      while (INPUT && !Exp::IsBreak(INPUT.peek())) {
+        const char* rest = INPUT.readahead();
+        std::size_t n =
+            Exp::FindBreakOrEof(rest, rest + INPUT.readaheadSize());
+        INPUT.eatInLine(n > 0 ? n : 1);
       }
     }
 
     // if it's NOT a line break, then we're done!
-    if (!Exp::Break().Matches(INPUT)) {
+    if (!Exp::IsBreak(INPUT.peek())) {
       break;
     }
 
     // otherwise, let's eat the line break and keep going
-    int n = Exp::Break().Match(INPUT);
+    int n = Exp::MatchBreak(INPUT);
     INPUT.eat(n);
 
     // oh yeah, and let's get rid of that simple key
@@ -256,22 +260,20 @@ bool Scanner::IsWhitespaceToBeEaten(char ch) {
   return false;
 }
 
-const RegEx& Scanner::GetValueRegex() const {
+bool Scanner::MatchesValue() const {
   if (InBlockContext()) {
-    return Exp::Value();
+    return Exp::MatchesValue(INPUT);
   }
 
-  return m_canBeJSONFlow ? Exp::ValueInJSONFlow() : Exp::ValueInFlow();
+  // Exp::ValueInJSONFlow()
+  return m_canBeJSONFlow ? INPUT.peek() == ':' : Exp::MatchesValueInFlow(INPUT);
 }
 
 void Scanner::StartStream() {
   m_startedStream = true;
   m_simpleKeyAllowed = true;
   m_scalarValueAllowed = true;
-  std::unique_ptr<IndentMarker> pIndent(
-      new IndentMarker(-1, IndentMarker::NONE));
-  m_indentRefs.push_back(std::move(pIndent));
-  m_indents.push(&m_indentRefs.back());
+  m_indents.push_back(NewIndentMarker(-1, IndentMarker::NONE));
 }
 
 void Scanner::EndStream() {
@@ -289,8 +291,7 @@ void Scanner::EndStream() {
 }
 
 Token* Scanner::PushToken(Token::TYPE type) {
-  m_tokens.push(Token(type, INPUT.mark()));
-  return &m_tokens.back();
+  return &m_tokens.push(type, INPUT.mark());
 }
 
 Token::TYPE Scanner::GetStartTokenFor(IndentMarker::INDENT_TYPE type) const {
@@ -314,27 +315,43 @@ Scanner::IndentMarker* Scanner::PushIndentTo(int column,
     return nullptr;
   }
 
-  std::unique_ptr<IndentMarker> pIndent(new IndentMarker(column, type));
-  IndentMarker& indent = *pIndent;
-  const IndentMarker& lastIndent = *m_indents.top();
+  const IndentMarker& lastIndent = *m_indents.back();
 
   // is this actually an indentation?
-  if (indent.column < lastIndent.column) {
+  if (column < lastIndent.column) {
     return nullptr;
   }
-  if (indent.column == lastIndent.column &&
-      !(indent.type == IndentMarker::SEQ &&
-        lastIndent.type == IndentMarker::MAP)) {
+  if (column == lastIndent.column &&
+      !(type == IndentMarker::SEQ && lastIndent.type == IndentMarker::MAP)) {
     return nullptr;
   }
 
+  IndentMarker* pIndent = NewIndentMarker(column, type);
+
   // push a start token
-  indent.pStartToken = PushToken(GetStartTokenFor(type));
+  pIndent->pStartToken = PushToken(GetStartTokenFor(type));
 
   // and then the indent
-  m_indents.push(&indent);
-  m_indentRefs.push_back(std::move(pIndent));
-  return &m_indentRefs.back();
+  m_indents.push_back(pIndent);
+  return pIndent;
+}
+
+Scanner::IndentMarker* Scanner::NewIndentMarker(
+    int column, IndentMarker::INDENT_TYPE type) {
+  if (m_simpleKeys.empty()) {
+    m_freeIndents.insert(m_freeIndents.end(), m_poppedIndents.begin(),
+                         m_poppedIndents.end());
+    m_poppedIndents.clear();
+  }
+
+  if (m_freeIndents.empty()) {
+    m_indentPool.emplace_back(column, type);
+    return &m_indentPool.back();
+  }
+  IndentMarker* pIndent = m_freeIndents.back();
+  m_freeIndents.pop_back();
+  *pIndent = IndentMarker(column, type);
+  return pIndent;
 }
 
 void Scanner::PopIndentToHere() {
@@ -345,13 +362,13 @@ void Scanner::PopIndentToHere() {
 
   // now pop away
   while (!m_indents.empty()) {
-    const IndentMarker& indent = *m_indents.top();
+    const IndentMarker& indent = *m_indents.back();
     if (indent.column < INPUT.column()) {
       break;
     }
     if (indent.column == INPUT.column() &&
         !(indent.type == IndentMarker::SEQ &&
-          !Exp::BlockEntry().Matches(INPUT))) {
+          !Exp::MatchesBlockEntry(INPUT))) {
       break;
     }
 
@@ -359,7 +376,7 @@ void Scanner::PopIndentToHere() {
   }
 
   while (!m_indents.empty() &&
-         m_indents.top()->status == IndentMarker::INVALID) {
+         m_indents.back()->status == IndentMarker::INVALID) {
     PopIndent();
   }
 }
@@ -372,7 +389,7 @@ void Scanner::PopAllIndents() {
 
   // now pop away
   while (!m_indents.empty()) {
-    const IndentMarker& indent = *m_indents.top();
+    const IndentMarker& indent = *m_indents.back();
     if (indent.type == IndentMarker::NONE) {
       break;
     }
@@ -382,8 +399,10 @@ void Scanner::PopAllIndents() {
 }
 
 void Scanner::PopIndent() {
-  const IndentMarker& indent = *m_indents.top();
-  m_indents.pop();
+  IndentMarker* pIndent = m_indents.back();
+  const IndentMarker& indent = *pIndent;
+  m_indents.pop_back();
+  m_poppedIndents.push_back(pIndent);
 
   if (indent.status != IndentMarker::VALID) {
     InvalidateSimpleKey();
@@ -391,9 +410,9 @@ void Scanner::PopIndent() {
   }
 
   if (indent.type == IndentMarker::SEQ) {
-    m_tokens.push(Token(Token::BLOCK_SEQ_END, INPUT.mark()));
+    PushToken(Token::BLOCK_SEQ_END);
   } else if (indent.type == IndentMarker::MAP) {
-    m_tokens.push(Token(Token::BLOCK_MAP_END, INPUT.mark()));
+    PushToken(Token::BLOCK_MAP_END);
   }
 }
 
@@ -401,7 +420,7 @@ int Scanner::GetTopIndent() const {
   if (m_indents.empty()) {
     return 0;
   }
-  return m_indents.top()->column;
+  return m_indents.back()->column;
 }
 
 void Scanner::ThrowParserException(const std::string& msg) const {
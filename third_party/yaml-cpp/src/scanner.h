@@ -8,14 +8,14 @@
 #endif
 
 #include <cstddef>
+#include <deque>
 #include <ios>
-#include <queue>
-#include <stack>
 #include <string>
+#include <vector>
 
-#include "ptr_vector.h"
 #include "stream.h"
 #include "token.h"
+#include "tokenqueue.h"
 #include "yaml-cpp/mark.h"
 
 namespace YAML {
@@ -98,6 +98,12 @@ class Scanner {
    */
   IndentMarker *PushIndentTo(int column, IndentMarker::INDENT_TYPE type);
 
+  /**
+   * Returns a marker from the pool, recycling the popped ones once no simple
+   * key can refer to them.
+   */
+  IndentMarker *NewIndentMarker(int column, IndentMarker::INDENT_TYPE type);
+
   /**
    * Pops indentations off the stack until it reaches the current indentation
    * level, and enqueues the proper token each time. Then pops all invalid
@@ -132,9 +138,10 @@ class Scanner {
   bool IsWhitespaceToBeEaten(char ch);
 
   /**
-   * Returns the appropriate regex to check if the next token is a value token.
+   * Returns true if the next token is a value token (for the current
+   * context).
    */
-  const RegEx &GetValueRegex() const;
+  bool MatchesValue() const;
 
   struct SimpleKey {
     SimpleKey(const Mark &mark_, std::size_t flowLevel_);
@@ -172,17 +179,22 @@ class Scanner {
   Stream INPUT;
 
   // the output (tokens)
-  std::queue<Token> m_tokens;
+  TokenQueue m_tokens;
 
   // state info
   bool m_startedStream, m_endedStream;
   bool m_simpleKeyAllowed;
   bool m_scalarValueAllowed;
   bool m_canBeJSONFlow;
-  std::stack<SimpleKey> m_simpleKeys;
-  std::stack<IndentMarker *> m_indents;
-  ptr_vector<IndentMarker> m_indentRefs;  // for "garbage collection"
-  std::stack<FLOW_MARKER> m_flows;
+  std::vector<SimpleKey> m_simpleKeys;
+  std::vector<IndentMarker *> m_indents;
+  std::vector<FLOW_MARKER> m_flows;
+
+  // Indent markers live in a pool that never shrinks, so simple keys can
+  // refer to them after they are popped (for "garbage collection").
+  std::deque<IndentMarker> m_indentPool;
+  std::vector<IndentMarker *> m_freeIndents;
+  std::vector<IndentMarker *> m_poppedIndents;
 };
 }
 
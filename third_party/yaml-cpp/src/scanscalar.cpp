@@ -1,6 +1,7 @@
 #include "scanscalar.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include "exp.h"
 #include "regeximpl.h"
@@ -8,6 +9,75 @@
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 
 namespace YAML {
+namespace {
+// The scalar scanned so far.  While every character read from an in-place
+// input is kept, it is only a view of the input; the first escape, dropped
+// character or line break copies it into a string.
+class ScalarText {
+ public:
+  ScalarText(const char* source, std::string& text)
+      : m_view(source), m_viewSize(0), m_text(text) {
+    m_text.clear();
+  }
+  ScalarText(const ScalarText&) = delete;
+  ScalarText& operator=(const ScalarText&) = delete;
+
+  std::size_t size() const { return m_view ? m_viewSize : m_text.size(); }
+
+  // Appends `ch`, the character just read from the input.
+  void AppendInput(char ch) {
+    if (m_view)
+      ++m_viewSize;
+    else
+      m_text += ch;
+  }
+  // Appends the `n` characters at `input`, which the input is about to eat.
+  void AppendInput(const char* input, std::size_t n) {
+    if (m_view)
+      m_viewSize += n;
+    else
+      m_text.append(input, n);
+  }
+
+  std::string& Text() {
+    if (m_view) {
+      m_text.assign(m_view, m_viewSize);
+      m_view = nullptr;
+    }
+    return m_text;
+  }
+
+  // Keeps the first `n` characters.
+  void Truncate(std::size_t n) {
+    if (m_view)
+      m_viewSize = std::min(m_viewSize, n);
+    else if (n < m_text.size())
+      m_text.erase(n);
+  }
+
+  std::size_t FindLastNotOf(const char* chars) const {
+    const char* data = m_view ? m_view : m_text.data();
+    std::size_t count = std::strlen(chars);
+    for (std::size_t i = size(); i > 0; --i) {
+      if (!std::memchr(chars, data[i - 1], count))
+        return i - 1;
+    }
+    return std::string::npos;
+  }
+
+  // Hands the result out as a view when possible.
+  void Finish(ScanScalarParams& params) {
+    params.view = m_view;
+    params.viewSize = m_view ? m_viewSize : 0;
+  }
+
+ private:
+  const char* m_view;
+  std::size_t m_viewSize;
+  std::string& m_text;
+};
+}  // namespace
+
 // ScanScalar
 // . This is where the scalar magic happens.
 //
@@ -18,15 +88,17 @@ namespace YAML {
 //
 // . Depending on the parameters given, we store or stop
 //   and different places in the above flow.
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
+void ScanScalar(Stream& INPUT, ScanScalarParams& params, std::string& value) {
   bool foundNonEmptyLine = false;
   bool pastOpeningBreak = (params.fold == FOLD_FLOW);
   bool emptyLine = false, moreIndented = false;
   int foldedNewlineCount = 0;
   bool foldedNewlineStartedMoreIndented = false;
   std::size_t lastEscapedChar = std::string::npos;
-  std::string scalar;
+  ScalarText scalar(INPUT.InPlaceData(), value);
   params.leadingSpaces = false;
+  params.view = nullptr;
+  params.viewSize = 0;
 
   if (!params.end) {
     params.end = &Exp::Empty();
@@ -38,13 +110,29 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
     std::size_t lastNonWhitespaceChar = scalar.size();
     bool escapedNewline = false;
-    while (!params.end->Matches(INPUT) && !Exp::Break().Matches(INPUT)) {
-      if (!INPUT) {
+    while (true) {
+      // Ordinary characters cannot end, escape or break the scalar, and a
+      // document indicator needs column 0.
+      char next = INPUT.peek();
+      if (!Exp::IsScalarStop(next) && INPUT.column() != 0) {
+        foundNonEmptyLine = true;
+        pastOpeningBreak = true;
+        // Take the whole run of them that is already read ahead.
+        const char* run = INPUT.readahead();
+        std::size_t n =
+            1 + Exp::FindScalarStop(run + 1, run + INPUT.readaheadSize());
+        scalar.AppendInput(run, n);
+        INPUT.eatInLine(n);
+        lastNonWhitespaceChar = scalar.size();
+        continue;
+      }
+
+      if (params.end->Matches(INPUT) || Exp::IsBreak(next) || !INPUT) {
         break;
       }
 
       // document indicator?
-      if (INPUT.column() == 0 && Exp::DocIndicator().Matches(INPUT)) {
+      if (INPUT.column() == 0 && Exp::MatchesDocIndicator(INPUT)) {
         if (params.onDocIndicator == BREAK) {
           break;
         }
@@ -57,8 +145,9 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
       pastOpeningBreak = true;
 
       // escaped newline? (only if we're escaping on slash)
-      if (params.escape == '\\' && Exp::EscBreak().Matches(INPUT)) {
+      if (params.escape == '\\' && Exp::MatchesEscBreak(INPUT)) {
         // eat escape character and get out (but preserve trailing whitespace!)
+        scalar.Text();
         INPUT.get();
         lastNonWhitespaceChar = scalar.size();
         lastEscapedChar = scalar.size();
@@ -68,7 +157,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
       // escape this?
       if (INPUT.peek() == params.escape) {
-        scalar += Exp::Escape(INPUT);
+        scalar.Text() += Exp::Escape(INPUT);
         lastNonWhitespaceChar = scalar.size();
         lastEscapedChar = scalar.size();
         continue;
@@ -76,7 +165,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
       // otherwise, just add the damn character
       char ch = INPUT.get();
-      scalar += ch;
+      scalar.AppendInput(ch);
       if (ch != ' ' && ch != '\t') {
         lastNonWhitespaceChar = scalar.size();
       }
@@ -92,7 +181,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
     // doc indicator?
     if (params.onDocIndicator == BREAK && INPUT.column() == 0 &&
-        Exp::DocIndicator().Matches(INPUT)) {
+        Exp::MatchesDocIndicator(INPUT)) {
       break;
     }
 
@@ -107,11 +196,13 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
     // do we remove trailing whitespace?
     if (params.fold == FOLD_FLOW)
-      scalar.erase(lastNonWhitespaceChar);
+      scalar.Truncate(lastNonWhitespaceChar);
 
     // ********************************
     // Phase #2: eat line ending
-    n = Exp::Break().Match(INPUT);
+    // (from here on the scalar no longer matches the input)
+    std::string& text = scalar.Text();
+    n = Exp::MatchBreak(INPUT);
     INPUT.eat(n);
 
     // ********************************
@@ -131,7 +222,7 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     }
 
     // and then the rest of the whitespace
-    while (Exp::Blank().Matches(INPUT)) {
+    while (Exp::IsBlank(INPUT.peek())) {
       // we check for tabs that masquerade as indentation
       if (INPUT.peek() == '\t' && INPUT.column() < params.indent &&
           params.onTabInIndentation == THROW) {
@@ -150,8 +241,8 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     }
 
     // was this an empty line?
-    bool nextEmptyLine = Exp::Break().Matches(INPUT);
-    bool nextMoreIndented = Exp::Blank().Matches(INPUT);
+    bool nextEmptyLine = Exp::IsBreak(INPUT.peek());
+    bool nextMoreIndented = Exp::IsBlank(INPUT.peek());
     if (params.fold == FOLD_BLOCK && foldedNewlineCount == 0 && nextEmptyLine)
       foldedNewlineStartedMoreIndented = moreIndented;
 
@@ -160,32 +251,32 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     if (pastOpeningBreak) {
       switch (params.fold) {
         case DONT_FOLD:
-          scalar += "\n";
+          text += "\n";
           break;
         case FOLD_BLOCK:
           if (!emptyLine && !nextEmptyLine && !moreIndented &&
               !nextMoreIndented && INPUT.column() >= params.indent) {
-            scalar += " ";
+            text += " ";
           } else if (nextEmptyLine) {
             foldedNewlineCount++;
           } else {
-            scalar += "\n";
+            text += "\n";
           }
 
           if (!nextEmptyLine && foldedNewlineCount > 0) {
-            scalar += std::string(foldedNewlineCount - 1, '\n');
+            text += std::string(foldedNewlineCount - 1, '\n');
             if (foldedNewlineStartedMoreIndented ||
                 nextMoreIndented | !foundNonEmptyLine) {
-              scalar += "\n";
+              text += "\n";
             }
             foldedNewlineCount = 0;
           }
           break;
         case FOLD_FLOW:
           if (nextEmptyLine) {
-            scalar += "\n";
+            text += "\n";
           } else if (!emptyLine && !escapedNewline) {
-            scalar += " ";
+            text += " ";
           }
           break;
       }
@@ -204,48 +295,48 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
   // post-processing
   if (params.trimTrailingSpaces) {
-    std::size_t pos = scalar.find_last_not_of(" \t");
+    std::size_t pos = scalar.FindLastNotOf(" \t");
     if (lastEscapedChar != std::string::npos) {
       if (pos < lastEscapedChar || pos == std::string::npos) {
         pos = lastEscapedChar;
       }
     }
     if (pos < scalar.size()) {
-      scalar.erase(pos + 1);
+      scalar.Truncate(pos + 1);
     }
   }
 
   switch (params.chomp) {
     case CLIP: {
-      std::size_t pos = scalar.find_last_not_of('\n');
+      std::size_t pos = scalar.FindLastNotOf("\n");
       if (lastEscapedChar != std::string::npos) {
         if (pos < lastEscapedChar || pos == std::string::npos) {
           pos = lastEscapedChar;
         }
       }
       if (pos == std::string::npos) {
-        scalar.erase();
+        scalar.Truncate(0);
       } else if (pos + 1 < scalar.size()) {
-        scalar.erase(pos + 2);
+        scalar.Truncate(pos + 2);
       }
     } break;
     case STRIP: {
-      std::size_t pos = scalar.find_last_not_of('\n');
+      std::size_t pos = scalar.FindLastNotOf("\n");
       if (lastEscapedChar != std::string::npos) {
         if (pos < lastEscapedChar || pos == std::string::npos) {
           pos = lastEscapedChar;
         }
       }
       if (pos == std::string::npos) {
-        scalar.erase();
+        scalar.Truncate(0);
       } else if (pos < scalar.size()) {
-        scalar.erase(pos + 1);
+        scalar.Truncate(pos + 1);
       }
     } break;
     default:
       break;
   }
 
-  return scalar;
+  scalar.Finish(params);
 }
 }  // namespace YAML
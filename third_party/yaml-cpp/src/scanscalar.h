@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <string>
 
 #include "regex_yaml.h"
@@ -30,7 +31,9 @@ struct ScanScalarParams {
         chomp(CLIP),
         onDocIndicator(NONE),
         onTabInIndentation(NONE),
-        leadingSpaces(false) {}
+        leadingSpaces(false),
+        view(nullptr),
+        viewSize(0) {}
 
   // input:
   const RegEx* end;   // what condition ends this scalar?
@@ -55,9 +58,12 @@ struct ScanScalarParams {
 
   // output:
   bool leadingSpaces;
+  const char* view;       // if not null, the scalar is [view, view + viewSize)
+  std::size_t viewSize;   // of the in-place input and the result is empty
 };
 
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& params);
+// Scans into `scalar`, which is cleared first (its capacity is reused).
+void ScanScalar(Stream& INPUT, ScanScalarParams& params, std::string& scalar);
 }
 
 #endif  // SCANSCALAR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
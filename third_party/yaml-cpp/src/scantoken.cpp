@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <sstream>
 
 #include "exp.h"
@@ -29,32 +30,30 @@ void Scanner::ScanDirective() {
   m_canBeJSONFlow = false;
 
   // store pos and eat indicator
-  Token token(Token::DIRECTIVE, INPUT.mark());
+  Token& token = *PushToken(Token::DIRECTIVE);
   INPUT.eat(1);
 
   // read name
-  while (INPUT && !Exp::BlankOrBreak().Matches(INPUT))
+  while (INPUT && !Exp::IsBlankOrBreak(INPUT.peek()))
     token.value += INPUT.get();
 
   // read parameters
   while (true) {
     // first get rid of whitespace
-    while (Exp::Blank().Matches(INPUT))
+    while (Exp::IsBlank(INPUT.peek()))
       INPUT.eat(1);
 
     // break on newline or comment
-    if (!INPUT || Exp::Break().Matches(INPUT) || Exp::Comment().Matches(INPUT))
+    if (!INPUT || Exp::IsBreak(INPUT.peek()) || INPUT.peek() == '#')
       break;
 
     // now read parameter
     std::string param;
-    while (INPUT && !Exp::BlankOrBreak().Matches(INPUT))
+    while (INPUT && !Exp::IsBlankOrBreak(INPUT.peek()))
       param += INPUT.get();
 
     token.params.push_back(param);
   }
-
-  m_tokens.push(token);
 }
 
 // DocStart
@@ -67,7 +66,7 @@ void Scanner::ScanDocStart() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(3);
-  m_tokens.push(Token(Token::DOC_START, mark));
+  m_tokens.push(Token::DOC_START, mark);
 }
 
 // DocEnd
@@ -80,7 +79,7 @@ void Scanner::ScanDocEnd() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(3);
-  m_tokens.push(Token(Token::DOC_END, mark));
+  m_tokens.push(Token::DOC_END, mark);
 }
 
 // FlowStart
@@ -94,10 +93,10 @@ void Scanner::ScanFlowStart() {
   Mark mark = INPUT.mark();
   char ch = INPUT.get();
   FLOW_MARKER flowType = (ch == Keys::FlowSeqStart ? FLOW_SEQ : FLOW_MAP);
-  m_flows.push(flowType);
+  m_flows.push_back(flowType);
   Token::TYPE type =
       (flowType == FLOW_SEQ ? Token::FLOW_SEQ_START : Token::FLOW_MAP_START);
-  m_tokens.push(Token(type, mark));
+  m_tokens.push(type, mark);
 }
 
 // FlowEnd
@@ -107,9 +106,9 @@ void Scanner::ScanFlowEnd() {
 
   // we might have a solo entry in the flow context
   if (InFlowContext()) {
-    if (m_flows.top() == FLOW_MAP && VerifySimpleKey())
-      m_tokens.push(Token(Token::VALUE, INPUT.mark()));
-    else if (m_flows.top() == FLOW_SEQ)
+    if (m_flows.back() == FLOW_MAP && VerifySimpleKey())
+      PushToken(Token::VALUE);
+    else if (m_flows.back() == FLOW_SEQ)
       InvalidateSimpleKey();
   }
 
@@ -122,21 +121,21 @@ void Scanner::ScanFlowEnd() {
 
   // check that it matches the start
   FLOW_MARKER flowType = (ch == Keys::FlowSeqEnd ? FLOW_SEQ : FLOW_MAP);
-  if (m_flows.top() != flowType)
+  if (m_flows.back() != flowType)
     throw ParserException(mark, ErrorMsg::FLOW_END);
-  m_flows.pop();
+  m_flows.pop_back();
 
   Token::TYPE type = (flowType ? Token::FLOW_SEQ_END : Token::FLOW_MAP_END);
-  m_tokens.push(Token(type, mark));
+  m_tokens.push(type, mark);
 }
 
 // FlowEntry
 void Scanner::ScanFlowEntry() {
   // we might have a solo entry in the flow context
   if (InFlowContext()) {
-    if (m_flows.top() == FLOW_MAP && VerifySimpleKey())
-      m_tokens.push(Token(Token::VALUE, INPUT.mark()));
-    else if (m_flows.top() == FLOW_SEQ)
+    if (m_flows.back() == FLOW_MAP && VerifySimpleKey())
+      PushToken(Token::VALUE);
+    else if (m_flows.back() == FLOW_SEQ)
       InvalidateSimpleKey();
   }
 
@@ -146,7 +145,7 @@ void Scanner::ScanFlowEntry() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::FLOW_ENTRY, mark));
+  m_tokens.push(Token::FLOW_ENTRY, mark);
 }
 
 // BlockEntry
@@ -166,7 +165,7 @@ void Scanner::ScanBlockEntry() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::BLOCK_ENTRY, mark));
+  m_tokens.push(Token::BLOCK_ENTRY, mark);
 }
 
 // Key
@@ -185,7 +184,7 @@ void Scanner::ScanKey() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::KEY, mark));
+  m_tokens.push(Token::KEY, mark);
 }
 
 // Value
@@ -217,13 +216,12 @@ void Scanner::ScanValue() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::VALUE, mark));
+  m_tokens.push(Token::VALUE, mark);
 }
 
 // AnchorOrAlias
 void Scanner::ScanAnchorOrAlias() {
   bool alias;
-  std::string name;
 
   // insert a potential simple key
   InsertPotentialSimpleKey();
@@ -234,8 +232,10 @@ void Scanner::ScanAnchorOrAlias() {
   Mark mark = INPUT.mark();
   char indicator = INPUT.get();
   alias = (indicator == Keys::Alias);
+  Token& token = m_tokens.push(alias ? Token::ALIAS : Token::ANCHOR, mark);
 
   // now eat the content
+  std::string& name = token.value;
   while (INPUT && Exp::Anchor().Matches(INPUT))
     name += INPUT.get();
 
@@ -248,11 +248,6 @@ void Scanner::ScanAnchorOrAlias() {
   if (INPUT && !Exp::AnchorEnd().Matches(INPUT))
     throw ParserException(INPUT.mark(), alias ? ErrorMsg::CHAR_IN_ALIAS
                                               : ErrorMsg::CHAR_IN_ANCHOR);
-
-  // and we're done
-  Token token(alias ? Token::ALIAS : Token::ANCHOR, mark);
-  token.value = name;
-  m_tokens.push(token);
 }
 
 // Tag
@@ -262,7 +257,7 @@ void Scanner::ScanTag() {
   m_simpleKeyAllowed = false;
   m_canBeJSONFlow = false;
 
-  Token token(Token::TAG, INPUT.mark());
+  Token& token = *PushToken(Token::TAG);
 
   // eat the indicator
   INPUT.get();
@@ -290,14 +285,10 @@ void Scanner::ScanTag() {
       token.data = Tag::NAMED_HANDLE;
     }
   }
-
-  m_tokens.push(token);
 }
 
 // PlainScalar
 void Scanner::ScanPlainScalar() {
-  std::string scalar;
-
   // set up the scanning parameters
   ScanScalarParams params;
   params.end =
@@ -314,8 +305,10 @@ void Scanner::ScanPlainScalar() {
   // insert a potential simple key
   InsertPotentialSimpleKey();
 
-  Mark mark = INPUT.mark();
-  scalar = ScanScalar(INPUT, params);
+  Token& token = *PushToken(Token::PLAIN_SCALAR);
+  ScanScalar(INPUT, params, token.value);
+  token.view = params.view;
+  token.viewSize = static_cast<std::uint32_t>(params.viewSize);
 
   // can have a simple key only if we ended the scalar by starting a new line
   m_simpleKeyAllowed = params.leadingSpaces;
@@ -324,16 +317,10 @@ void Scanner::ScanPlainScalar() {
   // finally, check and see if we ended on an illegal character
   // if(Exp::IllegalCharInScalar.Matches(INPUT))
   //	throw ParserException(INPUT.mark(), ErrorMsg::CHAR_IN_SCALAR);
-
-  Token token(Token::PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
 }
 
 // QuotedScalar
 void Scanner::ScanQuotedScalar() {
-  std::string scalar;
-
   // peek at single or double quote (don't eat because we need to preserve (for
   // the time being) the input position)
   char quote = INPUT.peek();
@@ -361,17 +348,16 @@ void Scanner::ScanQuotedScalar() {
   INPUT.get();
 
   // and scan
-  scalar = ScanScalar(INPUT, params);
+  Token& token = m_tokens.push(Token::NON_PLAIN_SCALAR, mark);
+  ScanScalar(INPUT, params, token.value);
+  token.view = params.view;
+  token.viewSize = static_cast<std::uint32_t>(params.viewSize);
   m_simpleKeyAllowed = false;
   // we just scanned a quoted scalar;
   // we can only have another scalar in this line
   // if we are in a flow, eg: `[ "foo", "bar" ]` is ok, but `"foo", "bar"` isn't.
   m_scalarValueAllowed = InFlowContext();
   m_canBeJSONFlow = true;
-
-  Token token(Token::NON_PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
 }
 
 // BlockScalarToken
@@ -380,8 +366,6 @@ void Scanner::ScanQuotedScalar() {
 // of the scalar),
 //   and then we need to figure out what level of indentation we'll be using.
 void Scanner::ScanBlockScalar() {
-  std::string scalar;
-
   ScanScalarParams params;
   params.indent = 1;
   params.detectIndent = true;
@@ -400,7 +384,7 @@ void Scanner::ScanBlockScalar() {
       params.chomp = KEEP;
     else if (ch == '-')
       params.chomp = STRIP;
-    else if (Exp::Digit().Matches(ch)) {
+    else if (Exp::IsDigit(ch)) {
       if (ch == '0')
         throw ParserException(INPUT.mark(), ErrorMsg::ZERO_INDENT_IN_BLOCK);
 
@@ -410,16 +394,16 @@ void Scanner::ScanBlockScalar() {
   }
 
   // now eat whitespace
-  while (Exp::Blank().Matches(INPUT))
+  while (Exp::IsBlank(INPUT.peek()))
     INPUT.eat(1);
 
   // and comments to the end of the line
-  if (Exp::Comment().Matches(INPUT))
-    while (INPUT && !Exp::Break().Matches(INPUT))
+  if (INPUT.peek() == '#')
+    while (INPUT && !Exp::IsBreak(INPUT.peek()))
       INPUT.eat(1);
 
   // if it's not a line break, then we ran into a bad character inline
-  if (INPUT && !Exp::Break().Matches(INPUT))
+  if (INPUT && !Exp::IsBreak(INPUT.peek()))
     throw ParserException(INPUT.mark(), ErrorMsg::CHAR_IN_BLOCK);
 
   // set the initial indentation
@@ -430,15 +414,14 @@ void Scanner::ScanBlockScalar() {
   params.trimTrailingSpaces = false;
   params.onTabInIndentation = THROW;
 
-  scalar = ScanScalar(INPUT, params);
+  Token& token = m_tokens.push(Token::NON_PLAIN_SCALAR, mark);
+  ScanScalar(INPUT, params, token.value);
+  token.view = params.view;
+  token.viewSize = static_cast<std::uint32_t>(params.viewSize);
 
   // simple keys always ok after block scalars (since we're gonna start a new
   // line anyways)
   m_simpleKeyAllowed = true;
   m_canBeJSONFlow = false;
-
-  Token token(Token::NON_PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
 }
 }  // namespace YAML
@@ -48,7 +48,7 @@ bool Scanner::ExistsActiveSimpleKey() const {
   if (m_simpleKeys.empty())
     return false;
 
-  const SimpleKey& key = m_simpleKeys.top();
+  const SimpleKey& key = m_simpleKeys.back();
   return key.flowLevel == GetFlowLevel();
 }
 
@@ -72,11 +72,10 @@ void Scanner::InsertPotentialSimpleKey() {
   }
 
   // then add the (now unverified) key
-  m_tokens.push(Token(Token::KEY, INPUT.mark()));
-  key.pKey = &m_tokens.back();
+  key.pKey = PushToken(Token::KEY);
   key.pKey->status = Token::UNVERIFIED;
 
-  m_simpleKeys.push(key);
+  m_simpleKeys.push_back(key);
 }
 
 // InvalidateSimpleKey
@@ -86,12 +85,12 @@ void Scanner::InvalidateSimpleKey() {
     return;
 
   // grab top key
-  SimpleKey& key = m_simpleKeys.top();
+  SimpleKey& key = m_simpleKeys.back();
   if (key.flowLevel != GetFlowLevel())
     return;
 
   key.Invalidate();
-  m_simpleKeys.pop();
+  m_simpleKeys.pop_back();
 }
 
 // VerifySimpleKey
@@ -102,13 +101,13 @@ bool Scanner::VerifySimpleKey() {
     return false;
 
   // grab top key
-  SimpleKey key = m_simpleKeys.top();
+  SimpleKey key = m_simpleKeys.back();
 
   // only validate if we're in the correct flow level
   if (key.flowLevel != GetFlowLevel())
     return false;
 
-  m_simpleKeys.pop();
+  m_simpleKeys.pop_back();
 
   bool isValid = true;
 
@@ -126,7 +125,6 @@ bool Scanner::VerifySimpleKey() {
 }
 
 void Scanner::PopAllSimpleKeys() {
-  while (!m_simpleKeys.empty())
-    m_simpleKeys.pop();
+  m_simpleKeys.clear();
 }
 }  // namespace YAML
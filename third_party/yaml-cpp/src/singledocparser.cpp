@@ -98,8 +98,9 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
   if (tag.empty())
     tag = (token.type == Token::NON_PLAIN_SCALAR ? "!" : "?");
 
-  if (token.type == Token::PLAIN_SCALAR
-      && tag.compare("?") == 0 && IsNullString(token.value.data(), token.value.size())) {
+  if (token.type == Token::PLAIN_SCALAR && tag.compare("?") == 0 &&
+      (token.view ? IsNullString(token.view, token.viewSize)
+                  : IsNullString(token.value.data(), token.value.size()))) {
     eventHandler.OnNull(mark, anchor);
     m_scanner.pop();
     return;
@@ -109,7 +110,11 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
   switch (token.type) {
     case Token::PLAIN_SCALAR:
     case Token::NON_PLAIN_SCALAR:
-      eventHandler.OnScalar(mark, tag, anchor, token.value);
+      if (token.view)
+        eventHandler.OnScalar(mark, tag, anchor,
+                              std::string(token.view, token.viewSize));
+      else
+        eventHandler.OnScalar(mark, tag, anchor, token.value);
       m_scanner.pop();
       return;
     case Token::FLOW_SEQ_START:
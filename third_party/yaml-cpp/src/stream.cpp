@@ -1,5 +1,7 @@
+#include <cstring>
 #include <istream>
 
+#include "memorystreambuf.h"
 #include "stream.h"
 
 #ifndef YAML_PREFETCH_SIZE
@@ -158,7 +160,11 @@ inline char Utf8Adjust(unsigned long ch, unsigned char lead_bits,
       static_cast<unsigned char>(header | ((ch >> rshift) & mask)));
 }
 
-inline void QueueUnicodeCodepoint(std::deque<char>& q, unsigned long ch) {
+inline char* ReadBuffer(unsigned char* pBuffer) {
+  return reinterpret_cast<char*>(pBuffer);
+}
+
+inline void QueueUnicodeCodepoint(std::vector<char>& q, unsigned long ch) {
   // We are not allowed to queue the Stream::eof() codepoint, so
   // replace it with CP_REPLACEMENT_CHARACTER
   if (static_cast<unsigned long>(Stream::eof()) == ch) {
@@ -187,6 +193,9 @@ Stream::Stream(std::istream& input)
       m_mark{},
       m_charSet{},
       m_readahead{},
+      m_current(nullptr),
+      m_end(nullptr),
+      m_inPlace(false),
       m_pPrefetched(new unsigned char[YAML_PREFETCH_SIZE]),
       m_nPrefetchedAvailable(0),
       m_nPrefetchedUsed(0) {
@@ -237,22 +246,28 @@ Stream::Stream(std::istream& input)
       break;
   }
 
+  // UTF-8 bytes in memory are already what the scanner reads.
+  MemoryStreamBuf* pMemory = dynamic_cast<MemoryStreamBuf*>(input.rdbuf());
+  if (pMemory && m_charSet == utf8) {
+    pMemory->TakeRest(m_current, m_end);
+    m_inPlace = true;
+  }
+
   ReadAheadTo(0);
 }
 
 Stream::~Stream() { delete[] m_pPrefetched; }
 
 char Stream::peek() const {
-  if (m_readahead.empty()) {
+  if (ReadaheadSize() == 0) {
     return Stream::eof();
   }
 
-  return m_readahead[0];
+  return CharAt(0);
 }
 
 Stream::operator bool() const {
-  return m_input.good() ||
-         (!m_readahead.empty() && m_readahead[0] != Stream::eof());
+  return m_input.good() || (ReadaheadSize() > 0 && CharAt(0) != Stream::eof());
 }
 
 // get
@@ -306,17 +321,45 @@ void Stream::eat(int n) {
     get();
 }
 
+void Stream::eatInLine(std::size_t n) {
+  m_current += n;
+  m_mark.pos += static_cast<int>(n);
+  m_mark.column += static_cast<int>(n);
+  ReadAheadTo(0);
+}
+
 void Stream::AdvanceCurrent() {
-  if (!m_readahead.empty()) {
-    m_readahead.pop_front();
+  if (ReadaheadSize() > 0) {
+    m_current++;
     m_mark.pos++;
   }
 
   ReadAheadTo(0);
 }
 
+// Drops the consumed characters once they are at least half of the buffer,
+// so each character is moved at most once on average.  Returns the offset of
+// the first unconsumed character.
+std::size_t Stream::CompactReadahead() const {
+  std::size_t start = static_cast<std::size_t>(m_current - m_readahead.data());
+  if (start == 0 || start * 2 < m_readahead.size())
+    return start;
+  m_readahead.erase(m_readahead.begin(),
+                    m_readahead.begin() + static_cast<std::ptrdiff_t>(start));
+  return 0;
+}
+
 bool Stream::_ReadAheadTo(size_t i) const {
-  while (m_input.good() && (m_readahead.size() <= i)) {
+  std::size_t start = 0;
+  if (m_inPlace) {
+    // The in-memory input is used up; its tail moves to the readahead so the
+    // end-of-stream marker can follow it.
+    m_readahead.assign(m_current, m_end);
+    m_inPlace = false;
+  } else {
+    start = CompactReadahead();
+  }
+  while (m_input.good() && (ReadaheadSize() <= i)) {
     switch (m_charSet) {
       case utf8:
         StreamInUtf8();
@@ -340,14 +383,20 @@ bool Stream::_ReadAheadTo(size_t i) const {
   if (!m_input.good())
     m_readahead.push_back(Stream::eof());
 
-  return m_readahead.size() > i;
+  m_current = m_readahead.data() + start;
+  m_end = m_readahead.data() + m_readahead.size();
+  return ReadaheadSize() > i;
 }
 
+// UTF-8 needs no decoding, so everything prefetched is appended at once.
 void Stream::StreamInUtf8() const {
-  unsigned char b = GetNextByte();
-  if (m_input.good()) {
-    m_readahead.push_back(static_cast<char>(b));
-  }
+  if (!Prefetch())
+    return;
+
+  const char* begin = ReadBuffer(m_pPrefetched) + m_nPrefetchedUsed;
+  m_readahead.insert(m_readahead.end(), begin,
+                     begin + (m_nPrefetchedAvailable - m_nPrefetchedUsed));
+  m_nPrefetchedUsed = m_nPrefetchedAvailable;
 }
 
 void Stream::StreamInUtf16() const {
@@ -416,24 +465,26 @@ void Stream::StreamInUtf16() const {
   QueueUnicodeCodepoint(m_readahead, ch);
 }
 
-inline char* ReadBuffer(unsigned char* pBuffer) {
-  return reinterpret_cast<char*>(pBuffer);
+// Refills the prefetch buffer once it is used up.  Returns false (and sets
+// eof) at the end of the input.
+bool Stream::Prefetch() const {
+  if (m_nPrefetchedUsed < m_nPrefetchedAvailable)
+    return true;
+
+  std::streambuf* pBuf = m_input.rdbuf();
+  m_nPrefetchedAvailable = static_cast<std::size_t>(
+      pBuf->sgetn(ReadBuffer(m_pPrefetched), YAML_PREFETCH_SIZE));
+  m_nPrefetchedUsed = 0;
+  if (!m_nPrefetchedAvailable) {
+    m_input.setstate(std::ios_base::eofbit);
+    return false;
+  }
+  return true;
 }
 
 unsigned char Stream::GetNextByte() const {
-  if (m_nPrefetchedUsed >= m_nPrefetchedAvailable) {
-    std::streambuf* pBuf = m_input.rdbuf();
-    m_nPrefetchedAvailable = static_cast<std::size_t>(
-        pBuf->sgetn(ReadBuffer(m_pPrefetched), YAML_PREFETCH_SIZE));
-    m_nPrefetchedUsed = 0;
-    if (!m_nPrefetchedAvailable) {
-      m_input.setstate(std::ios_base::eofbit);
-    }
-
-    if (0 == m_nPrefetchedAvailable) {
-      return 0;
-    }
-  }
+  if (!Prefetch())
+    return 0;
 
   return m_pPrefetched[m_nPrefetchedUsed++];
 }
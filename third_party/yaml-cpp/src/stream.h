@@ -9,11 +9,11 @@
 
 #include "yaml-cpp/mark.h"
 #include <cstddef>
-#include <deque>
 #include <ios>
 #include <istream>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace YAML {
 
@@ -34,11 +34,26 @@ class Stream {
   bool operator!() const { return !static_cast<bool>(*this); }
 
   char peek() const;
+  // The character `i` places ahead (peek(0) is peek()), or eof() past the end.
+  char peek(std::size_t i) const {
+    return ReadAheadTo(i) ? CharAt(i) : Stream::eof();
+  }
   char get();
   std::string get(int n);
   void eat(int n = 1);
 
-  static char eof() { return 0x04; }
+  // The characters read ahead so far, [readahead(), readahead() +
+  // readaheadSize()), starting with peek().  For bulk scans.
+  const char* readahead() const { return m_current; }
+  std::size_t readaheadSize() const { return ReadaheadSize(); }
+  // Eats `n` read-ahead characters that contain no line break.
+  void eatInLine(std::size_t n);
+
+  static constexpr char eof() { return 0x04; }
+
+  // The input bytes at the current position when UTF-8 input is scanned in
+  // place, otherwise nullptr.  They stay valid for the whole parse.
+  const char* InPlaceData() const { return m_inPlace ? m_current : nullptr; }
 
   const Mark mark() const { return m_mark; }
   int pos() const { return m_mark.pos; }
@@ -54,27 +69,41 @@ class Stream {
 
   CharacterSet m_charSet;
   char m_lineEndingSymbol{}; // 0 means it is not determined yet, must be '\n' or '\r'
-  mutable std::deque<char> m_readahead;
+  // Decoded characters not consumed yet are [m_current, m_end): either the
+  // tail of m_readahead or, for UTF-8 input from a MemoryStreamBuf, the input
+  // bytes themselves (m_inPlace).  Consumed characters are dropped from
+  // m_readahead in bulk before refilling, so it stays contiguous.
+  mutable std::vector<char> m_readahead;
+  mutable const char* m_current;
+  mutable const char* m_end;
+  mutable bool m_inPlace;
   unsigned char* const m_pPrefetched;
   mutable size_t m_nPrefetchedAvailable;
   mutable size_t m_nPrefetchedUsed;
 
   void AdvanceCurrent();
+  std::size_t ReadaheadSize() const {
+    return static_cast<std::size_t>(m_end - m_current);
+  }
   char CharAt(size_t i) const;
   bool ReadAheadTo(size_t i) const;
   bool _ReadAheadTo(size_t i) const;
+  std::size_t CompactReadahead() const;
   void StreamInUtf8() const;
   void StreamInUtf16() const;
   void StreamInUtf32() const;
+  bool Prefetch() const;
   unsigned char GetNextByte() const;
 };
 
 // CharAt
 // . Unchecked access
-inline char Stream::CharAt(size_t i) const { return m_readahead[i]; }
+inline char Stream::CharAt(size_t i) const {
+  return m_current[i];
+}
 
 inline bool Stream::ReadAheadTo(size_t i) const {
-  if (m_readahead.size() > i)
+  if (ReadaheadSize() > i)
     return true;
   return _ReadAheadTo(i);
 }
@@ -8,6 +8,7 @@
 #endif
 
 #include "yaml-cpp/mark.h"
+#include <cstdint>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -22,9 +23,10 @@ constexpr const char* TokenNames[] = {
     "NON_PLAIN_SCALAR"};
 
 struct Token {
-  // enums
-  enum STATUS { VALID, INVALID, UNVERIFIED };
-  enum TYPE {
+  // enums (one byte each, so a token holding a scalar view is no larger
+  // than one without)
+  enum STATUS : unsigned char { VALID, INVALID, UNVERIFIED };
+  enum TYPE : unsigned char {
     DIRECTIVE,
     DOC_START,
     DOC_END,
@@ -50,10 +52,37 @@ struct Token {
 
   // data
   Token(TYPE type_, const Mark& mark_)
-      : status(VALID), type(type_), mark(mark_), value{}, params{}, data(0) {}
+      : status(VALID),
+        type(type_),
+        mark(mark_),
+        value{},
+        params{},
+        data(0),
+        viewSize(0),
+        view(nullptr) {}
+  Token(const Token&) = default;
+  Token(Token&&) = default;
+  Token& operator=(const Token&) = default;
+  Token& operator=(Token&&) = default;
+
+  // Makes this a fresh Token(type_, mark_), keeping the strings' capacity.
+  void Reset(TYPE type_, const Mark& mark_) {
+    status = VALID;
+    type = type_;
+    mark = mark_;
+    value.clear();
+    params.clear();
+    data = 0;
+    viewSize = 0;
+    view = nullptr;
+  }
 
   friend std::ostream& operator<<(std::ostream& out, const Token& token) {
-    out << TokenNames[token.type] << std::string(": ") << token.value;
+    out << TokenNames[token.type] << std::string(": ");
+    if (token.view)
+      out.write(token.view, static_cast<std::streamsize>(token.viewSize));
+    else
+      out << token.value;
     for (const std::string& param : token.params)
       out << std::string(" ") << param;
     return out;
@@ -65,6 +94,12 @@ struct Token {
   std::string value;
   std::vector<std::string> params;
   int data;
+
+  // Scalars scanned in place keep their text in the input buffer,
+  // [view, view + viewSize), and leave value empty.  (Positions fit in an int,
+  // see Mark.)
+  std::uint32_t viewSize;
+  const char* view;
 };
 }  // namespace YAML
 
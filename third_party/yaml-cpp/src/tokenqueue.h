@@ -0,0 +1,81 @@
+#ifndef TOKENQUEUE_H_3F0C9A52_6B1E_4D27_9E84_2C7A5D1B8E60
+#define TOKENQUEUE_H_3F0C9A52_6B1E_4D27_9E84_2C7A5D1B8E60
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "token.h"
+
+namespace YAML {
+// The scanner's FIFO of tokens.  Popped tokens go back to a free list and are
+// handed out again by push(), so their strings keep their capacity; once the
+// queue has reached its deepest point, scanning allocates nothing per token.
+//
+// A token's address does not change while it is queued (simple keys and
+// indent markers point at the tokens they may have to validate).
+class TokenQueue {
+ public:
+  TokenQueue() : m_storage{}, m_free{}, m_ring(16), m_head(0), m_size(0) {}
+  TokenQueue(const TokenQueue&) = delete;
+  TokenQueue& operator=(const TokenQueue&) = delete;
+
+  bool empty() const { return m_size == 0; }
+  std::size_t size() const { return m_size; }
+
+  Token& front() { return *m_ring[m_head]; }
+  const Token& front() const { return *m_ring[m_head]; }
+  Token& back() { return *m_ring[Slot(m_size - 1)]; }
+
+  // Appends a token as if it were Token(type, mark).
+  Token& push(Token::TYPE type, const Mark& mark) {
+    if (m_size == m_ring.size())
+      Grow();
+    Token* token;
+    if (m_free.empty()) {
+      m_storage.emplace_back(type, mark);
+      token = &m_storage.back();
+    } else {
+      token = m_free.back();
+      m_free.pop_back();
+      token->Reset(type, mark);
+    }
+    m_ring[Slot(m_size)] = token;
+    ++m_size;
+    return *token;
+  }
+
+  void pop() {
+    m_free.push_back(m_ring[m_head]);
+    m_head = Slot(1);
+    --m_size;
+  }
+
+ private:
+  // The ring's size is a power of two.
+  std::size_t Slot(std::size_t i) const {
+    return (m_head + i) & (m_ring.size() - 1);
+  }
+
+  void Grow() {
+    std::vector<Token*> ring(m_ring.size() * 2);
+    for (std::size_t i = 0; i < m_size; ++i)
+      ring[i] = m_ring[Slot(i)];
+    m_ring.swap(ring);
+    m_head = 0;
+  }
+
+  std::deque<Token> m_storage;  // never shrinks, so tokens never move
+  std::vector<Token*> m_free;
+  std::vector<Token*> m_ring;
+  std::size_t m_head, m_size;
+};
+}  // namespace YAML
+
+#endif  // TOKENQUEUE_H_3F0C9A52_6B1E_4D27_9E84_2C7A5D1B8E60
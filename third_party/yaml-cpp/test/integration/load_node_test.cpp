@@ -1,5 +1,11 @@
 #include "yaml-cpp/yaml.h"  // IWYU pragma: keep
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace YAML {
@@ -465,6 +471,172 @@ TEST(LoadNodeTest, IncorrectSeqEnd) {
   EXPECT_THROW(Load("[foo]_bar"), ParserException);
 }
 
+TEST(LoadNodeTest, LongUtf8StreamAcrossPrefetchBlocks) {
+  // Multi-byte characters land on every offset of the 2048-byte prefetch
+  // blocks, and the readahead is compacted many times along the way.
+  std::stringstream input;
+  std::vector<std::string> values;
+  for (int i = 0; i < 3000; i++) {
+    std::string value = "v" + std::to_string(i) + "\xc3\xa9\xe2\x82\xac";
+    values.push_back(value);
+    input << "k" << i << ": " << value << "\n";
+  }
+  Node node = Load(input);
+  ASSERT_EQ(3000u, node.size());
+  for (int i = 0; i < 3000; i++) {
+    EXPECT_EQ(values[i], node["k" + std::to_string(i)].as<std::string>());
+  }
+}
+
+
+TEST(LoadNodeTest, InPlaceScalarsMatchStreamScalars) {
+  // Load(std::string) scans in place and keeps single-line scalars as views
+  // of the input; a stringstream goes through the readahead.
+  const std::string input =
+      "plain: a plain scalar   \n"
+      "single: 'it''s quoted'\n"
+      "double: \"tab\\there\"\n"
+      "spaces: \"  kept  \"\n"
+      "folded: two\n  lines\n"
+      "empty: ''\n"
+      "nothing: ~\n"
+      "flow: [x, 'y', \"z\"]\n"
+      "last: at the end";
+  std::stringstream stream(input);
+  Node inPlace = Load(input);
+  Node streamed = Load(stream);
+  EXPECT_EQ("a plain scalar", inPlace["plain"].as<std::string>());
+  EXPECT_EQ("it's quoted", inPlace["single"].as<std::string>());
+  EXPECT_EQ("tab\there", inPlace["double"].as<std::string>());
+  EXPECT_EQ("  kept  ", inPlace["spaces"].as<std::string>());
+  EXPECT_EQ("two lines", inPlace["folded"].as<std::string>());
+  EXPECT_EQ("", inPlace["empty"].as<std::string>());
+  EXPECT_TRUE(inPlace["nothing"].IsNull());
+  EXPECT_EQ("at the end", inPlace["last"].as<std::string>());
+  for (const char* key :
+       {"plain", "single", "double", "spaces", "folded", "empty", "last"}) {
+    EXPECT_EQ(streamed[key].as<std::string>(), inPlace[key].as<std::string>());
+  }
+  for (std::size_t i = 0; i < 3; i++) {
+    EXPECT_EQ(streamed["flow"][i].as<std::string>(),
+              inPlace["flow"][i].as<std::string>());
+  }
+}
+
+TEST(LoadNodeTest, LongScalarsAndComments) {
+  // Runs of ordinary characters and comments are skipped in bulk; put the
+  // characters that end them at many different offsets.
+  std::string input;
+  std::vector<std::string> values;
+  for (int i = 0; i < 64; i++) {
+    std::string text(static_cast<std::size_t>(i), 'x');
+    values.push_back("plain " + text + " end");
+    input += "p" + std::to_string(i) + ": plain " + text + " end  # " + text +
+             "\n";
+    input += "q" + std::to_string(i) + ": \"" + text + "\\t" + text + "\"\n";
+    input += "f" + std::to_string(i) + ": [" + text + "a, " + text + "b]\n";
+  }
+  std::stringstream stream(input);
+  for (const Node& node : {Load(input), Load(stream)}) {
+    for (int i = 0; i < 64; i++) {
+      std::string text(static_cast<std::size_t>(i), 'x');
+      std::string n = std::to_string(i);
+      EXPECT_EQ(values[i], node["p" + n].as<std::string>());
+      EXPECT_EQ(text + "\t" + text, node["q" + n].as<std::string>());
+      EXPECT_EQ(text + "a", node["f" + n][0].as<std::string>());
+      EXPECT_EQ(text + "b", node["f" + n][1].as<std::string>());
+    }
+  }
+}
 
+TEST(LoadNodeTest, RecycledTokensAndIndents) {
+  // A flow sequence used as a key keeps all its tokens queued until the ':'
+  // (growing the token ring); the block maps around it push and pop indents
+  // and reuse tokens whose strings held longer scalars.
+  std::string key = "[";
+  for (int i = 0; i < 100; i++)
+    key += (i ? ", " : "") + std::to_string(i);
+  key += "]";
+  std::string input;
+  for (int i = 0; i < 20; i++) {
+    std::string n = std::to_string(i);
+    input += "m" + n + ":\n  " + key + ": a rather long value " + n +
+             "\n  deeper:\n    k: v" + n + "\n";
+  }
+  std::stringstream stream(input);
+  for (const Node& node : {Load(input), Load(stream)}) {
+    ASSERT_EQ(20u, node.size());
+    for (int i = 0; i < 20; i++) {
+      std::string n = std::to_string(i);
+      const Node m = node["m" + n];
+      ASSERT_EQ(2u, m.size());
+      for (const_iterator it = m.begin(); it != m.end(); ++it) {
+        if (it->first.IsSequence()) {
+          ASSERT_EQ(100u, it->first.size());
+          EXPECT_EQ(99, it->first[99].as<int>());
+          EXPECT_EQ("a rather long value " + n, it->second.as<std::string>());
+        } else {
+          EXPECT_EQ("deeper", it->first.as<std::string>());
+          EXPECT_EQ("v" + n, it->second["k"].as<std::string>());
+        }
+      }
+    }
+  }
+}
+
+// Writes `contents` to a scratch file that is removed when it goes away.
+class ScratchFile {
+ public:
+  explicit ScratchFile(const std::string& contents)
+      : m_name("yaml-cpp-load-node-test.yaml") {
+    std::ofstream out(m_name, std::ios_base::out | std::ios_base::binary);
+    out << contents;
+  }
+  ~ScratchFile() { std::remove(m_name.c_str()); }
+  const std::string& name() const { return m_name; }
+
+ private:
+  std::string m_name;
+};
+
+TEST(LoadNodeTest, LoadFileMapsUtf8) {
+  std::string contents = "\xef\xbb\xbfname: caf\xc3\xa9\nitems: [1, 2, 3]\n";
+  for (int i = 0; i < 2000; i++) {
+    contents += "k" + std::to_string(i) + ": " + std::to_string(i) + "\n";
+  }
+  // No trailing newline: the last scalar ends at the end of the mapping.
+  contents += "last: end";
+  ScratchFile file(contents);
+  Node node = LoadFile(file.name());
+  EXPECT_EQ("caf\xc3\xa9", node["name"].as<std::string>());
+  EXPECT_EQ(3u, node["items"].size());
+  EXPECT_EQ(1999, node["k1999"].as<int>());
+  EXPECT_EQ("end", node["last"].as<std::string>());
+}
+
+TEST(LoadNodeTest, LoadFileUtf16) {
+  std::string contents("\xff\xfe" "a\0:\0 \0b\0\n\0", 12);
+  ScratchFile file(contents);
+  Node node = LoadFile(file.name());
+  EXPECT_EQ("b", node["a"].as<std::string>());
+}
+
+TEST(LoadNodeTest, LoadFileEmpty) {
+  ScratchFile file("");
+  EXPECT_TRUE(LoadFile(file.name()).IsNull());
+  EXPECT_TRUE(LoadAllFromFile(file.name()).empty());
+}
+
+TEST(LoadNodeTest, LoadFileMissing) {
+  EXPECT_THROW(LoadFile("yaml-cpp-no-such-file.yaml"), BadFile);
+}
+
+TEST(LoadNodeTest, LoadAllFromFile) {
+  ScratchFile file("a: 1\n---\nb: 2\n...\n");
+  std::vector<Node> docs = LoadAllFromFile(file.name());
+  ASSERT_EQ(2u, docs.size());
+  EXPECT_EQ(1, docs[0]["a"].as<int>());
+  EXPECT_EQ(2, docs[1]["b"].as<int>());
+}
 }  // namespace
 }  // namespace YAML
@@ -10,6 +10,7 @@
 #include "gtest/gtest.h"
 
 #include <sstream>
+#include <thread>
 
 namespace {
 
@@ -704,6 +705,133 @@ TEST(NodeTest, SpaceChar) {
   EXPECT_EQ(' ', node.as<char>());
 }
 
+// How convert<> reads numbers with a classic-locale stream (the special
+// values, .inf and .nan, are left out).
+template <typename T>
+bool StreamDecode(const std::string& input, T& value) {
+  std::stringstream stream(input);
+  stream.imbue(std::locale::classic());
+  stream.unsetf(std::ios::dec);
+  if (stream.peek() == '-' && std::is_unsigned<T>::value)
+    return false;
+  return (stream >> std::noskipws >> value) && (stream >> std::ws).eof();
+}
+
+template <typename T>
+void ExpectDecodesLikeStream(const std::vector<std::string>& inputs) {
+  for (const std::string& input : inputs) {
+    T expected{};
+    bool accepted = StreamDecode(input, expected);
+    T value{};
+    EXPECT_EQ(accepted, convert<T>::decode(Node(input), value))
+        << "\"" << input << "\"";
+    T text{};
+    EXPECT_EQ(accepted, conversion::DecodeScalar(input, text))
+        << "\"" << input << "\"";
+    if (accepted) {
+      EXPECT_EQ(expected, value) << "\"" << input << "\"";
+      EXPECT_EQ(std::signbit(expected), std::signbit(value))
+          << "\"" << input << "\"";
+      EXPECT_EQ(expected, text) << "\"" << input << "\"";
+    }
+  }
+}
+
+TEST(NodeTest, NumbersDecodeLikeStreams) {
+  const std::vector<std::string> inputs = {
+      "0", "-0", "7", "-7", "+7", "007", "08", "0x1F", "0X1f", "-0x10",
+      "017", " 42", "42 ", "42\t", "42\n", "4 2", "", "-", "+", ".", "-.",
+      "e5", "1e", "1e+", "inf", "-inf", "nan", "infinity", "0x1p3", "1_000",
+      "1,5", "1.5", "-1.5", ".5", "5.", "-.5", "00.5", "1.5e-3", "1E+10",
+      "0.1", "0.25", "0.001", "2147483647", "2147483648", "-2147483648",
+      "-2147483649", "4294967295", "4294967296", "9223372036854775807",
+      "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+      "18446744073709551615", "18446744073709551616", "32767", "32768",
+      "-32769", "65535", "65536", "123456789012345678901234567890",
+      "3.4028235e38", "3.5e38", "1e39", "1e-39", "1e-46", "1e-400",
+      "4.9e-324", "2.2250738585072014e-308", "1.7976931348623157e308",
+      "1.8e308", "0.1000000000000000055511151231257827"};
+  ExpectDecodesLikeStream<short>(inputs);
+  ExpectDecodesLikeStream<unsigned short>(inputs);
+  ExpectDecodesLikeStream<int>(inputs);
+  ExpectDecodesLikeStream<unsigned>(inputs);
+  ExpectDecodesLikeStream<long>(inputs);
+  ExpectDecodesLikeStream<unsigned long>(inputs);
+  ExpectDecodesLikeStream<long long>(inputs);
+  ExpectDecodesLikeStream<unsigned long long>(inputs);
+  ExpectDecodesLikeStream<float>(inputs);
+  ExpectDecodesLikeStream<double>(inputs);
+}
+
+TEST(NodeTest, ScalarsDecodeWithoutNodes) {
+  double d = 0;
+  EXPECT_TRUE(conversion::DecodeScalar("-.Inf", d));
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), d);
+  EXPECT_TRUE(conversion::DecodeScalar(".NaN", d));
+  EXPECT_TRUE(std::isnan(d));
+  EXPECT_FALSE(conversion::DecodeScalar("1,5", d));
+  int i = 0;
+  EXPECT_FALSE(conversion::DecodeScalar(".inf", i));
+  unsigned u = 0;
+  EXPECT_FALSE(conversion::DecodeScalar("-1", u));
+
+  const std::vector<std::string> bools = {"y",    "Yes",  "TRUE", "tRuE",
+                                          "off",  "No",   "nO",   "",
+                                          "true ", "1",   "On",   "FALSE"};
+  for (const std::string& input : bools) {
+    bool expected = false;
+    bool accepted = convert<bool>::decode(Node(input), expected);
+    bool value = false;
+    EXPECT_EQ(accepted, conversion::DecodeScalar(input, value))
+        << "\"" << input << "\"";
+    if (accepted)
+      EXPECT_EQ(expected, value) << "\"" << input << "\"";
+  }
+  bool b = false;
+  EXPECT_FALSE(conversion::DecodeScalar("tRuE", b));
+  EXPECT_TRUE(conversion::DecodeScalar("TRUE", b));
+  EXPECT_TRUE(b);
+}
+
+template <typename T>
+void ExpectEncodesLikeStream(T value) {
+  std::stringstream stream;
+  stream.imbue(std::locale::classic());
+  stream << value;
+  EXPECT_EQ(stream.str(), Node(value).Scalar());
+}
+
+TEST(NodeTest, IntegersEncodeLikeStreams) {
+  ExpectEncodesLikeStream(0);
+  ExpectEncodesLikeStream(-1);
+  ExpectEncodesLikeStream((std::numeric_limits<short>::min)());
+  ExpectEncodesLikeStream((std::numeric_limits<unsigned short>::max)());
+  ExpectEncodesLikeStream((std::numeric_limits<int>::min)());
+  ExpectEncodesLikeStream((std::numeric_limits<int>::max)());
+  ExpectEncodesLikeStream((std::numeric_limits<unsigned>::max)());
+  ExpectEncodesLikeStream((std::numeric_limits<long>::min)());
+  ExpectEncodesLikeStream((std::numeric_limits<unsigned long>::max)());
+  ExpectEncodesLikeStream((std::numeric_limits<long long>::min)());
+  ExpectEncodesLikeStream((std::numeric_limits<unsigned long long>::max)());
+  ExpectEncodesLikeStream('x');
+}
+
+TEST(NodeTest, DoublesRoundTrip) {
+  const double values[] = {0.1,     1.0 / 3.0, 0.25,    -2.5e-8,
+                           1e300,   5e-324,    1e23,    -0.0,
+                           123456789.0, (std::numeric_limits<double>::max)()};
+  for (double value : values) {
+    Node node(value);
+    EXPECT_EQ(value, node.as<double>()) << node.Scalar();
+    EXPECT_EQ(std::signbit(value), std::signbit(node.as<double>()));
+  }
+  EXPECT_EQ("0.25", Node(0.25).Scalar());
+  EXPECT_EQ("-0.5", Node(-0.5f).Scalar());
+  EXPECT_EQ(".inf", Node(std::numeric_limits<double>::infinity()).Scalar());
+  EXPECT_EQ("-.inf", Node(-std::numeric_limits<float>::infinity()).Scalar());
+  EXPECT_EQ(".nan", Node(std::numeric_limits<double>::quiet_NaN()).Scalar());
+}
+
 TEST(NodeTest, CloneNull) {
   Node node;
   Node clone = Clone(node);
@@ -733,6 +861,152 @@ TEST(NodeTest, AccessNonexistentKeyOnConstNode) {
   ASSERT_FALSE(other["5"]);
 }
 
+TEST(NodeTest, LargeMapLookupByString) {
+  Node node;
+  for (int i = 0; i < 1000; i++) {
+    node["key" + std::to_string(i)] = i;
+  }
+  const Node& constNode = node;
+  for (int i = 0; i < 1000; i++) {
+    std::string key = "key" + std::to_string(i);
+    EXPECT_EQ(i, constNode[key].as<int>());
+    EXPECT_EQ(i, node[key.c_str()].as<int>());
+  }
+  EXPECT_FALSE(constNode["missing"]);
+  EXPECT_EQ(1000, node.size());
+}
+
+TEST(NodeTest, LargeMapNonStringKeys) {
+  Node node;
+  for (int i = 0; i < 100; i++) {
+    node[i] = i * 2;
+  }
+  node["0x10"] = "hex";
+  EXPECT_EQ(20, node["10"].as<int>());
+  EXPECT_EQ(20, node[10].as<int>());
+  // integer lookups convert each key; "16" comes before "0x10"
+  EXPECT_EQ(32, node[16].as<int>());
+  EXPECT_EQ("hex", node["0x10"].as<std::string>());
+}
+
+TEST(NodeTest, LargeMapKeyIndexFollowsChanges) {
+  Node node;
+  for (int i = 0; i < 100; i++) {
+    node["key" + std::to_string(i)] = i;
+  }
+  EXPECT_EQ(5, node["key5"].as<int>());
+
+  // rename a key through the iterator
+  for (auto it = node.begin(); it != node.end(); ++it) {
+    if (it->first.as<std::string>() == "key7") {
+      Node key = it->first;
+      key = "renamed";
+    }
+  }
+  EXPECT_FALSE(static_cast<const Node&>(node)["key7"]);
+  EXPECT_EQ(7, node["renamed"].as<int>());
+
+  EXPECT_TRUE(node.remove("key3"));
+  EXPECT_FALSE(static_cast<const Node&>(node)["key3"]);
+  EXPECT_EQ(4, node["key4"].as<int>());
+  EXPECT_EQ(99, node["key99"].as<int>());
+
+  // the first of two equal keys wins, as with a linear search
+  node.force_insert("key10", "second");
+  EXPECT_EQ(10, node["key10"].as<int>());
+  node["late"] = "appended";
+  EXPECT_EQ("appended", node["late"].as<std::string>());
+}
+
+TEST(NodeTest, LargeMapKeyIndexSharedKeyFollowsChanges) {
+  Node first;
+  Node second;
+  for (int i = 0; i < 20; i++) {
+    first["a" + std::to_string(i)] = i;
+    second["b" + std::to_string(i)] = i;
+  }
+  Node key("shared");
+  first[key] = "first";
+  second[key] = "second";
+  EXPECT_EQ("first", first["shared"].as<std::string>());
+  EXPECT_EQ("second", second["shared"].as<std::string>());
+
+  key = "renamed";
+  EXPECT_FALSE(static_cast<const Node&>(first)["shared"]);
+  EXPECT_FALSE(static_cast<const Node&>(second)["shared"]);
+  EXPECT_EQ("first", first["renamed"].as<std::string>());
+  EXPECT_EQ("second", second["renamed"].as<std::string>());
+}
+
+TEST(NodeTest, LargeMapKeyIndexConcurrentConstLookups) {
+  Node node;
+  for (int i = 0; i < 200; i++) {
+    node["key" + std::to_string(i)] = i;
+  }
+  const Node& constNode = node;
+
+  std::vector<std::thread> threads;
+  std::vector<int> misses(4, 0);
+  for (std::size_t t = 0; t < misses.size(); t++) {
+    threads.emplace_back([&constNode, &misses, t] {
+      for (int i = 0; i < 200; i++) {
+        if (constNode["key" + std::to_string(i)].as<int>() != i)
+          misses[t]++;
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_THAT(misses, testing::Each(0));
+}
+
+TEST(NodeTest, LargeSequenceSpansManyChunks) {
+  Node node;
+  for (int i = 0; i < 5000; i++) {
+    node.push_back(i);
+  }
+  ASSERT_EQ(5000, node.size());
+  for (int i = 0; i < 5000; i++) {
+    EXPECT_EQ(i, node[i].as<int>());
+  }
+}
+
+TEST(NodeTest, MemorySizeCountsNodesAddedToSharedChunks) {
+  detail::memory a;
+  detail::memory b;
+  a.create_node();
+  a.create_node();  // second chunk, half full
+  b.merge(a);
+  a.create_node();  // lands in the chunk b now shares
+  EXPECT_EQ(3u, a.size());
+  EXPECT_EQ(3u, b.size());
+  b.merge(a);
+  EXPECT_EQ(3u, b.size());
+  EXPECT_EQ(a.chunk_count(), b.chunk_count());
+}
+
+TEST(NodeTest, NodesSurviveRepeatedMerges) {
+  Node survivor;
+  {
+    Node a, b, c;
+    b["c"] = c;
+    c["value"] = "from c";
+    a["b"] = b;
+    // c's holder still points to the memory that was merged into a.
+    a["c"] = c;
+    survivor = c;
+    b.reset();
+  }
+  EXPECT_EQ("from c", survivor["value"].as<std::string>());
+  for (int i = 0; i < 100; i++) {
+    Node other;
+    other["n"] = i;
+    survivor["others"].push_back(other);
+  }
+  EXPECT_EQ(99, survivor["others"][99]["n"].as<int>());
+}
+
 class NodeEmitterTest : public ::testing::Test {
  protected:
   void ExpectOutput(const std::string& output, const Node& node) {
@@ -4,8 +4,12 @@
 #include "mock_event_handler.h"
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <fstream>
+
 using YAML::Parser;
 using YAML::MockEventHandler;
+using ::testing::_;
 using ::testing::NiceMock;
 using ::testing::StrictMock;
 
@@ -62,3 +66,43 @@ TEST(ParserTest, CVE_2019_6285) {
     NiceMock<MockEventHandler> handler;
     EXPECT_THROW(parser.HandleNextDocument(handler), YAML::DeepRecursion);
 }
+
+TEST(ParserTest, LoadBuffer) {
+    const char input[] = "a: [1, 2]\n---\nb\n";
+    Parser parser;
+    parser.Load(input, sizeof(input) - 1);
+    EXPECT_TRUE(parser);
+
+    NiceMock<MockEventHandler> handler;
+    EXPECT_CALL(handler, OnScalar(_, _, _, _)).Times(3);
+    EXPECT_TRUE(parser.HandleNextDocument(handler));
+    ::testing::Mock::VerifyAndClearExpectations(&handler);
+
+    EXPECT_CALL(handler, OnScalar(_, _, _, "b"));
+    EXPECT_TRUE(parser.HandleNextDocument(handler));
+    EXPECT_FALSE(parser.HandleNextDocument(handler));
+}
+
+TEST(ParserTest, LoadFile) {
+    const std::string name = "yaml-cpp-parser-test.yaml";
+    {
+        std::ofstream out(name, std::ios_base::out | std::ios_base::binary);
+        out << "key: value";
+    }
+    Parser parser;
+    parser.LoadFile(name);
+
+    NiceMock<MockEventHandler> handler;
+    EXPECT_CALL(handler, OnScalar(_, _, _, "key"));
+    EXPECT_CALL(handler, OnScalar(_, _, _, "value"));
+    EXPECT_TRUE(parser.HandleNextDocument(handler));
+    EXPECT_FALSE(parser.HandleNextDocument(handler));
+    parser.Load(nullptr, 0);  // unmaps the file
+    std::remove(name.c_str());
+}
+
+TEST(ParserTest, LoadFileMissing) {
+    Parser parser;
+    EXPECT_THROW(parser.LoadFile("yaml-cpp-no-such-file.yaml"), YAML::BadFile);
+    EXPECT_FALSE(parser);
+}
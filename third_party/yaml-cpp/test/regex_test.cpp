@@ -1,7 +1,12 @@
+#include "exp.h"
 #include "regex_yaml.h"
+#include "regeximpl.h"
 #include "stream.h"
 #include "gtest/gtest.h"
 
+#include <sstream>
+#include <vector>
+
 using YAML::RegEx;
 using YAML::Stream;
 
@@ -174,4 +179,83 @@ TEST(RegExTest, StringOr) {
 
   EXPECT_EQ(1, ex.Match(str));
 }
+
+TEST(RegExTest, CharClassesAgreeWithExpressions) {
+  namespace Exp = YAML::Exp;
+  for (int i = 0; i < 256; ++i) {
+    char ch = static_cast<char>(i);
+    EXPECT_EQ(Exp::Blank().Matches(ch), Exp::IsBlank(ch)) << i;
+    EXPECT_EQ(Exp::Break().Matches(ch), Exp::IsBreak(ch)) << i;
+    EXPECT_EQ(Exp::BlankOrBreak().Matches(ch), Exp::IsBlankOrBreak(ch)) << i;
+    EXPECT_EQ(Exp::Digit().Matches(ch), Exp::IsDigit(ch)) << i;
+    EXPECT_EQ(Exp::AlphaNumeric().Matches(ch), Exp::IsAlphaNumeric(ch)) << i;
+    EXPECT_EQ(Exp::Word().Matches(ch), Exp::IsWord(ch)) << i;
+    EXPECT_EQ(Exp::Hex().Matches(ch), Exp::IsHex(ch)) << i;
+  }
+}
+
+TEST(RegExTest, StreamMatchersAgreeWithExpressions) {
+  namespace Exp = YAML::Exp;
+  // Every string of up to four of these characters.
+  const std::string alphabet = "-.?:, \t\n\r]}a#\\";
+  std::vector<std::string> inputs(1);
+  for (std::size_t begin = 0, length = 0; length < 4; ++length) {
+    std::size_t end = inputs.size();
+    for (std::size_t i = begin; i < end; ++i) {
+      for (char ch : alphabet)
+        inputs.push_back(inputs[i] + ch);
+    }
+    begin = end;
+  }
+  for (const std::string& input : inputs) {
+    std::stringstream stream(input);
+    Stream in(stream);
+    EXPECT_EQ(Exp::Break().Match(in), Exp::MatchBreak(in)) << input;
+    EXPECT_EQ(Exp::DocStart().Matches(in), Exp::MatchesDocStart(in)) << input;
+    EXPECT_EQ(Exp::DocEnd().Matches(in), Exp::MatchesDocEnd(in)) << input;
+    EXPECT_EQ(Exp::DocIndicator().Matches(in), Exp::MatchesDocIndicator(in))
+        << input;
+    EXPECT_EQ(Exp::BlockEntry().Matches(in), Exp::MatchesBlockEntry(in))
+        << input;
+    EXPECT_EQ(Exp::Key().Matches(in), Exp::MatchesKey(in)) << input;
+    EXPECT_EQ(Exp::Value().Matches(in), Exp::MatchesValue(in)) << input;
+    EXPECT_EQ(Exp::ValueInFlow().Matches(in), Exp::MatchesValueInFlow(in))
+        << input;
+    EXPECT_EQ(Exp::EscBreak().Matches(in), Exp::MatchesEscBreak(in)) << input;
+    if (in) {
+      EXPECT_EQ(Exp::PlainScalar().Matches(in), Exp::MatchesPlainScalar(in))
+          << input;
+      EXPECT_EQ(Exp::PlainScalarInFlow().Matches(in),
+                Exp::MatchesPlainScalarInFlow(in))
+          << input;
+    }
+  }
+}
+
+TEST(RegExTest, BulkScansAgreeWithCharClasses) {
+  namespace Exp = YAML::Exp;
+  // A byte of interest at every offset of a 40-byte run, for every byte.
+  for (int i = 0; i < 256; ++i) {
+    char ch = static_cast<char>(i);
+    for (std::size_t at = 0; at < 40; ++at) {
+      std::string text(40, 'x');
+      text[at] = ch;
+      const char* begin = text.data();
+      const char* end = begin + text.size();
+
+      // Other control characters may stop the scan too.
+      std::size_t stop = Exp::FindScalarStop(begin, end);
+      if (Exp::IsScalarStop(ch))
+        EXPECT_EQ(at, stop) << i;
+      else if (i < ' ')
+        EXPECT_TRUE(stop == at || stop == text.size()) << i;
+      else
+        EXPECT_EQ(text.size(), stop) << i;
+
+      bool isBreak = Exp::IsBreak(ch) || ch == Stream::eof();
+      EXPECT_EQ(isBreak ? at : text.size(), Exp::FindBreakOrEof(begin, end))
+          << i;
+    }
+  }
+}
 }  // namespace
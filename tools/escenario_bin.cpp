@@ -0,0 +1,62 @@
+/*
+ * Convierte un escenario YAML al formato binario de RelaBinario.h.
+ *
+ *   escenario_bin config.yaml config.rlev   convierte
+ *   escenario_bin --check config.rlev       comprueba cabecera y suma
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "RelaEventos.h"
+#include "RelaBinario.h"
+
+static int Convert(const char* input, const char* output)
+{
+	ScenarioConfig config;
+	std::string error;
+	if (!LoadEventosFromYaml(input, config, error)) {
+		fprintf(stderr, "%s: %s\n", input, error.c_str());
+		return 1;
+	}
+	if (!WriteScenarioBinary(output, config, error)) {
+		fprintf(stderr, "%s: %s\n", output, error.c_str());
+		return 1;
+	}
+	printf("%s: %u eventos, %u bytes\n", output, (unsigned)config.eventos.size(),
+		(unsigned)(sizeof(ScenarioBinaryHeader) + config.eventos.size() * sizeof(AppEvent)));
+	return 0;
+}
+
+static int Check(const char* path)
+{
+	MappedScenario mapped;
+	std::string error;
+	if (!mapped.Open(path, error, true)) {
+		fprintf(stderr, "%s: %s\n", path, error.c_str());
+		return 1;
+	}
+	ScenarioConfig config;
+	mapped.CopyTo(config);
+	if (!ValidateEventos(config.eventos, error)) {
+		fprintf(stderr, "%s: %s\n", path, error.c_str());
+		return 1;
+	}
+	const ScenarioBinaryHeader& header = mapped.Header();
+	printf("%s: version %u, %u eventos, crc %08x\n", path, (unsigned)header.version,
+		(unsigned)header.eventCount, (unsigned)header.checksum);
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc == 3 && strcmp(argv[1], "--check") == 0) {
+		return Check(argv[2]);
+	}
+	if (argc == 3) {
+		return Convert(argv[1], argv[2]);
+	}
+	fprintf(stderr, "Uso: %s <escenario.yaml> <escenario.rlev>\n", argv[0]);
+	fprintf(stderr, "     %s --check <escenario.rlev>\n", argv[0]);
+	return 2;
+}
@@ -0,0 +1,193 @@
+/*
+ * Validacion previa de escenarios.
+ *
+ * Lee cada escenario una vez con el lector por eventos (sin construir el
+ * arbol YAML), anota todos los problemas con su linea y columna y calcula
+ * la linea temporal de forma cerrada con AnalyticEngine, saltando de evento
+ * en evento sin dar pasos.  De ahi salen los recortes a kVelocityLimit y
+ * los tiempos finales.  Los eventos periodicos sin limite no terminan
+ * nunca, asi que la linea temporal se corta en el horizonte (-t, 3600 s
+ * de simulacion por defecto).
+ *
+ *   escenario_validar [-j N] [-t T] escenario.yaml...
+ *
+ * Los ficheros se reparten entre N hilos; la salida sale en el orden de
+ * los argumentos.  Devuelve 1 si algun escenario tiene problemas.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RelaEventos.h"
+#include "RelaAnalitico.h"
+#include "RelaTipos.h"
+
+struct FileReport {
+	std::string text;
+	bool ok;
+};
+
+static void Append(std::string& text, const char* format, ...)
+{
+	char buffer[512];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+	text += buffer;
+}
+
+static void AppendProblem(std::string& text, const char* path, int line, int column, const std::string& message)
+{
+	if (line > 0) {
+		Append(text, "%s:%d:%d: %s\n", path, line, column, message.c_str());
+	} else {
+		Append(text, "%s: %s\n", path, message.c_str());
+	}
+}
+
+struct TimelineSummary {
+	size_t disparos[kEventTypeCount];
+	size_t recortes;
+	bool cortada;
+};
+
+// Recorre el escenario de evento en evento y anota los cambios recortados.
+static void RunTimeline(const char* path, const ScenarioConfig& config,
+	const ScenarioDiagnostics& diagnostics, AnalyticEngine& engine, double horizon,
+	TimelineSummary& summary, std::string& text)
+{
+	for (int t = 0; t < kEventTypeCount; t++) {
+		summary.disparos[t] = 0;
+	}
+	summary.recortes = 0;
+	summary.cortada = false;
+	engine.Load(config.eventos.data(), config.eventos.size());
+	std::vector<AnalyticTrigger> fired;
+	while (engine.Advance(fired)) {
+		for (size_t d = 0; d < fired.size(); d++) {
+			const AnalyticTrigger& trigger = fired[d];
+			const AppEvent& ev = config.eventos[trigger.event];
+			summary.disparos[ev.type]++;
+			if (trigger.velocity == trigger.requested) {
+				continue;
+			}
+			summary.recortes++;
+			const ScenarioPosition& pos = diagnostics.eventPositions[trigger.event];
+			char msg[160];
+			snprintf(msg, sizeof(msg),
+				"%s recortado en la ventana %d: la velocidad de %c pasaria a %.4f, queda en %.4f (t = %.4f)",
+				kEventTypes[ev.type].name, trigger.window, ColumnLabel(ev.column), trigger.requested,
+				trigger.velocity, trigger.elapsed);
+			AppendProblem(text, path, pos.line, pos.column, msg);
+		}
+		fired.clear();
+		if (engine.State().elapsed > horizon) {
+			summary.cortada = true;
+			break;
+		}
+	}
+}
+
+static FileReport CheckFile(const char* path, double horizon)
+{
+	FileReport report;
+	ScenarioConfig config;
+	ScenarioDiagnostics diagnostics;
+	std::string error;
+	bool loaded = LoadEventosFromYaml(path, config, error, &diagnostics);
+	for (size_t i = 0; i < diagnostics.problems.size(); i++) {
+		const ScenarioProblem& p = diagnostics.problems[i];
+		AppendProblem(report.text, path, p.line, p.column, p.message);
+	}
+	report.ok = loaded && diagnostics.problems.empty();
+	if (!loaded) {
+		return report;
+	}
+
+	AnalyticEngine engine(AnalyticEngine::kContinuo);
+	TimelineSummary tl;
+	RunTimeline(path, config, diagnostics, engine, horizon, tl, report.text);
+	const AnalyticState& state = engine.State();
+	if (tl.recortes > 0) {
+		report.ok = false;
+	}
+	Append(report.text, "%s: %u eventos, %u problemas;", path, (unsigned)config.eventos.size(),
+		(unsigned)(diagnostics.problems.size() + tl.recortes));
+	for (int t = 0; t < kEventTypeCount; t++) {
+		// Los tipos que no aparecen no se listan (salvo los de siempre).
+		if (tl.disparos[t] > 0 || t == kEventoPausa || t == kEventoCambio) {
+			Append(report.text, " %u %s,", (unsigned)tl.disparos[t], kEventTypes[t].plural);
+		}
+	}
+	Append(report.text, " %u recortados\n", (unsigned)tl.recortes);
+	Append(report.text, "  tiempo de simulacion %.4f (%llu pasos)%s\n", state.elapsed, state.step,
+		tl.cortada ? ", cortado en el horizonte" : "");
+	if (config.fisicaModelo == kFisicaLorentz) {
+		// La linea temporal se calcula con el modelo de dilatacion.
+		Append(report.text, "  (fisica lorentz: relojes calculados sin transformacion de Lorentz)\n");
+	}
+	for (int w = 0; w < kWindowCount; w++) {
+		Append(report.text, "  ventana %d:", w);
+		for (int c = 0; c < kIndexColumns; c++) {
+			int col = GetIndexForLabelInWindow(w, (char)('A' + c));
+			Append(report.text, " %c = %.4f (v %.3f)", 'A' + c, state.clock[col], state.velocity[col]);
+		}
+		Append(report.text, "\n");
+	}
+	return report;
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<const char*> files;
+	unsigned threads = std::thread::hardware_concurrency();
+	double horizon = 3600.0;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+			threads = (unsigned)atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+			horizon = atof(argv[++i]);
+		} else {
+			files.push_back(argv[i]);
+		}
+	}
+	if (files.empty()) {
+		fprintf(stderr, "Uso: %s [-j N] [-t T] <escenario.yaml>...\n", argv[0]);
+		return 2;
+	}
+	if (threads == 0) {
+		threads = 1;
+	}
+	if (threads > files.size()) {
+		threads = (unsigned)files.size();
+	}
+
+	std::vector<FileReport> reports(files.size());
+	std::atomic<size_t> next(0);
+	std::vector<std::thread> workers;
+	for (unsigned t = 0; t < threads; t++) {
+		workers.push_back(std::thread([&]() {
+			for (size_t i = next++; i < files.size(); i = next++) {
+				reports[i] = CheckFile(files[i], horizon);
+			}
+		}));
+	}
+	for (size_t t = 0; t < workers.size(); t++) {
+		workers[t].join();
+	}
+
+	int status = 0;
+	for (size_t i = 0; i < reports.size(); i++) {
+		fputs(reports[i].text.c_str(), stdout);
+		if (!reports[i].ok) {
+			status = 1;
+		}
+	}
+	return status;
+}